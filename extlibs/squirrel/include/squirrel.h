@@ -454,6 +454,9 @@ SQUIRREL_API SQRESULT sq_getobjtypetag(const HSQOBJECT *o,SQUserPointer * typeta
 /*GC*/
 SQUIRREL_API SQInteger sq_collectgarbage(HSQUIRRELVM v);
 SQUIRREL_API SQRESULT sq_resurrectunreachable(HSQUIRRELVM v);
+// Begin Attract-Mode specific change
+SQUIRREL_API void sq_getallocstats(SQUnsignedInteger *count,SQUnsignedInteger *size);
+// End Attract-Mode specific change
 
 /*serialization*/
 SQUIRREL_API SQRESULT sq_writeclosure(HSQUIRRELVM vm,SQWRITEFUNC writef,SQUserPointer up);
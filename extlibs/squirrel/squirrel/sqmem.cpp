@@ -2,8 +2,18 @@
 	see copyright notice in squirrel.h
 */
 #include "sqpcheader.h"
-void *sq_vm_malloc(SQUnsignedInteger size){	return malloc(size); }
+// Begin Attract-Mode specific change
+//
+// Count allocations so the frontend's script profiler can report them
+//
+static SQUnsignedInteger _alloc_count = 0;
+static SQUnsignedInteger _alloc_size = 0;
 
-void *sq_vm_realloc(void *p, SQUnsignedInteger oldsize, SQUnsignedInteger size){ return realloc(p, size); }
+void *sq_vm_malloc(SQUnsignedInteger size){	_alloc_count++; _alloc_size+=size; return malloc(size); }
+
+void *sq_vm_realloc(void *p, SQUnsignedInteger oldsize, SQUnsignedInteger size){ if(size>oldsize){ _alloc_count++; _alloc_size+=size-oldsize; } return realloc(p, size); }
+
+void sq_getallocstats(SQUnsignedInteger *count,SQUnsignedInteger *size){ *count=_alloc_count; *size=_alloc_size; }
+// End Attract-Mode specific change
 
 void sq_vm_free(void *p, SQUnsignedInteger size){	free(p); }
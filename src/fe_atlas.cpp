@@ -0,0 +1,378 @@
+/*
+ *
+ *  Attract-Mode Plus frontend
+ *  Copyright (C) 2025 Andrew Mickelson & Radek Dutkiewicz
+ *
+ *  This file is part of Attract-Mode Plus
+ *
+ *  Attract-Mode Plus is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Attract-Mode Plus is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Attract-Mode Plus.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "fe_atlas.hpp"
+#include "fe_base.hpp" // logging
+#include <SFML/System/Clock.hpp>
+#include <SFML/System/Time.hpp>
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+	const unsigned int MAX_PAGE_SIZE = 2048;
+	const int MAX_PAGES = 4;
+
+	// Edge pixels are repeated into the padding so smoothing doesn't
+	// pick up neighbouring images
+	const int PADDING = 1;
+
+	// A shelf is only used for images at least this fraction of its height
+	const float SHELF_FILL = 0.75f;
+};
+
+FeTextureAtlas::FeTextureAtlas()
+	: m_page_size( 0 ),
+	m_use_count( 0 ),
+	m_upload_us( 0 ),
+	m_max_size( 0 )
+{
+}
+
+FeTextureAtlas &FeTextureAtlas::get_ref()
+{
+	// Never destroyed, the pages can't be freed once the window has closed
+	static FeTextureAtlas *atlas = new FeTextureAtlas();
+	return *atlas;
+}
+
+void FeTextureAtlas::set_max_image_size( int s )
+{
+	if ( s < 0 )
+		s = 0;
+
+	if ( m_page_size == 0 )
+		m_page_size = std::min( MAX_PAGE_SIZE, sf::Texture::getMaximumSize() );
+
+	// Keep at least a few images to a page
+	m_max_size = std::min( s, (int)m_page_size / 4 - 2 * PADDING );
+
+	if ( m_max_size == 0 )
+		purge();
+
+	FeDebug() << "Set texture atlas maximum image size: " << m_max_size << std::endl;
+}
+
+bool FeTextureAtlas::accepts( int width, int height ) const
+{
+	return (( width > 0 ) && ( height > 0 )
+		&& ( width <= m_max_size ) && ( height <= m_max_size ));
+}
+
+std::string FeTextureAtlas::make_key( const std::string &key, bool smooth ) const
+{
+	return ( smooth ? "1" : "0" ) + key;
+}
+
+int FeTextureAtlas::acquire( const std::string &key, bool smooth )
+{
+	if ( m_max_size == 0 )
+		return -1;
+
+	std::map<std::string, int>::iterator itr = m_lookup.find( make_key( key, smooth ) );
+	if ( itr == m_lookup.end() )
+		return -1;
+
+	Slot &s = m_slots[ (*itr).second ];
+	s.ref_count++;
+	s.last_use = ++m_use_count;
+	return (*itr).second;
+}
+
+int FeTextureAtlas::add( const std::string &key, bool smooth,
+	int width, int height, const std::uint8_t *data )
+{
+	if ( !accepts( width, height ) || !data )
+		return -1;
+
+	// The same image may have been added by another load since this one
+	// started
+	int existing = acquire( key, smooth );
+	if ( existing >= 0 )
+		return existing;
+
+	const int w = width + 2 * PADDING;
+	const int h = height + 2 * PADDING;
+
+	int idx;
+	int page;
+	sf::IntRect cell;
+
+	if ( allocate( smooth, w, h, page, cell ) )
+	{
+		// Reuse a slot entry whose page was freed
+		idx = 0;
+		while (( idx < (int)m_slots.size() ) && ( m_slots[idx].page >= 0 ))
+			idx++;
+
+		if ( idx == (int)m_slots.size() )
+			m_slots.push_back( Slot() );
+
+		m_slots[idx].page = page;
+		m_slots[idx].cell = cell;
+	}
+	else
+	{
+		idx = evict( smooth, w, h );
+		if ( idx < 0 )
+			return -1;
+
+		std::map<std::string, int>::iterator itr = m_lookup.find( m_slots[idx].key );
+		if (( itr != m_lookup.end() ) && ( (*itr).second == idx ))
+			m_lookup.erase( itr );
+	}
+
+	Slot &s = m_slots[idx];
+	s.key = make_key( key, smooth );
+	s.rect = sf::IntRect( s.cell.position + sf::Vector2i( PADDING, PADDING ), { width, height } );
+	s.ref_count = 1;
+	s.last_use = ++m_use_count;
+	m_lookup[ s.key ] = idx;
+
+	upload( s, width, height, data );
+	return idx;
+}
+
+void FeTextureAtlas::release( int slot )
+{
+	if (( slot >= 0 ) && ( slot < (int)m_slots.size() ) && ( m_slots[slot].ref_count > 0 ))
+		m_slots[slot].ref_count--;
+}
+
+size_t FeTextureAtlas::release_pages()
+{
+	return purge();
+}
+
+const sf::Texture &FeTextureAtlas::get_texture( int slot ) const
+{
+	return m_pages[ m_slots[slot].page ]->texture;
+}
+
+const sf::IntRect &FeTextureAtlas::get_rect( int slot ) const
+{
+	return m_slots[slot].rect;
+}
+
+bool FeTextureAtlas::allocate( bool smooth, int w, int h, int &page, sf::IntRect &cell )
+{
+	const int size = (int)m_page_size;
+
+	for ( int p=0; p<(int)m_pages.size(); p++ )
+	{
+		Page &pg = *m_pages[p];
+		if ( pg.smooth != smooth )
+			continue;
+
+		for ( std::vector<Shelf>::iterator itr = pg.shelves.begin(); itr != pg.shelves.end(); ++itr )
+		{
+			if (( h <= (*itr).height ) && ( h >= (*itr).height * SHELF_FILL )
+					&& ( (*itr).next_x + w <= size ))
+			{
+				page = p;
+				cell = sf::IntRect( { (*itr).next_x, (*itr).y }, { w, h } );
+				(*itr).next_x += w;
+				return true;
+			}
+		}
+
+		if ( pg.next_y + h <= size )
+		{
+			Shelf sh = { pg.next_y, h, w };
+			pg.shelves.push_back( sh );
+			pg.next_y += h;
+
+			page = p;
+			cell = sf::IntRect( { 0, sh.y }, { w, h } );
+			return true;
+		}
+	}
+
+	if ( (int)m_pages.size() >= MAX_PAGES )
+		return false;
+
+	Page *pg = new Page;
+	if ( !pg->texture.resize( { m_page_size, m_page_size } ))
+	{
+		FeLog() << "Error creating texture atlas page" << std::endl;
+		delete pg;
+		return false;
+	}
+
+	pg->texture.setSmooth( smooth );
+	pg->smooth = smooth;
+	pg->next_y = h;
+
+	Shelf sh = { 0, h, w };
+	pg->shelves.push_back( sh );
+
+	page = (int)m_pages.size();
+	m_pages.push_back( pg );
+	cell = sf::IntRect( { 0, 0 }, { w, h } );
+
+	FeDebug() << "Added texture atlas page #" << page << " (" << m_page_size
+		<< "x" << m_page_size << ")" << std::endl;
+
+	return true;
+}
+
+int FeTextureAtlas::evict( bool smooth, int w, int h )
+{
+	int found = -1;
+
+	for ( int i=0; i<(int)m_slots.size(); i++ )
+	{
+		const Slot &s = m_slots[i];
+		if (( s.ref_count == 0 ) && ( s.page >= 0 )
+				&& ( m_pages[s.page]->smooth == smooth )
+				&& ( s.cell.size.x >= w ) && ( s.cell.size.y >= h )
+				&& (( found < 0 ) || ( s.last_use < m_slots[found].last_use )))
+			found = i;
+	}
+
+	return found;
+}
+
+void FeTextureAtlas::upload( Slot &s, int width, int height, const std::uint8_t *data )
+{
+	sf::Clock clock;
+
+	const int w = width + 2 * PADDING;
+	const int h = height + 2 * PADDING;
+	const size_t row_bytes = width * 4;
+
+	m_buffer.resize( w * h * 4 );
+
+	for ( int y=0; y<h; y++ )
+	{
+		const int sy = std::clamp( y - PADDING, 0, height - 1 );
+		const std::uint8_t *src = data + sy * row_bytes;
+		std::uint8_t *dest = &m_buffer[ y * w * 4 ];
+
+		for ( int x=0; x<PADDING; x++ )
+		{
+			std::memcpy( dest + x * 4, src, 4 );
+			std::memcpy( dest + ( PADDING + width + x ) * 4, src + row_bytes - 4, 4 );
+		}
+
+		std::memcpy( dest + PADDING * 4, src, row_bytes );
+	}
+
+	m_pages[s.page]->texture.update( m_buffer.data(),
+		{ (unsigned int)w, (unsigned int)h },
+		{ (unsigned int)s.cell.position.x, (unsigned int)s.cell.position.y } );
+
+	m_upload_us += clock.getElapsedTime().asMicroseconds();
+}
+
+size_t FeTextureAtlas::purge()
+{
+	std::vector<bool> in_use( m_pages.size(), false );
+	for ( std::vector<Slot>::const_iterator itr = m_slots.begin(); itr != m_slots.end(); ++itr )
+	{
+		if (( (*itr).page >= 0 ) && ( (*itr).ref_count > 0 ))
+			in_use[ (*itr).page ] = true;
+	}
+
+	//
+	// Free the pages that no image is using.  The slots on them are kept
+	// as free entries, as slot indices are held by the texture containers
+	//
+	std::vector<int> remap( m_pages.size(), -1 );
+	std::vector<Page *> kept;
+	size_t bytes = 0;
+
+	for ( int p=0; p<(int)m_pages.size(); p++ )
+	{
+		if ( in_use[p] )
+		{
+			remap[p] = (int)kept.size();
+			kept.push_back( m_pages[p] );
+		}
+		else
+		{
+			bytes += (size_t)m_page_size * m_page_size * 4;
+			delete m_pages[p];
+		}
+	}
+
+	if ( bytes == 0 )
+		return 0;
+
+	m_pages.swap( kept );
+
+	if ( m_pages.empty() )
+	{
+		m_slots.clear();
+		m_lookup.clear();
+		m_buffer.clear();
+		return bytes;
+	}
+
+	for ( int i=0; i<(int)m_slots.size(); i++ )
+	{
+		Slot &s = m_slots[i];
+		if ( s.page < 0 )
+			continue;
+
+		s.page = remap[ s.page ];
+		if ( s.page < 0 )
+		{
+			m_lookup.erase( s.key );
+			s.key.clear();
+		}
+	}
+
+	return bytes;
+}
+
+int FeTextureAtlas::get_image_count() const
+{
+	int count = 0;
+	for ( std::vector<Slot>::const_iterator itr = m_slots.begin(); itr != m_slots.end(); ++itr )
+	{
+		if ( (*itr).ref_count > 0 )
+			count++;
+	}
+
+	return count;
+}
+
+float FeTextureAtlas::get_occupancy() const
+{
+	if ( m_pages.empty() )
+		return 0.f;
+
+	double used = 0.0;
+	for ( std::vector<Slot>::const_iterator itr = m_slots.begin(); itr != m_slots.end(); ++itr )
+	{
+		if ( (*itr).ref_count > 0 )
+			used += (double)(*itr).rect.size.x * (*itr).rect.size.y;
+	}
+
+	return (float)( 100.0 * used / ( (double)m_page_size * m_page_size * m_pages.size() ));
+}
+
+float FeTextureAtlas::get_upload_time() const
+{
+	return m_upload_us / 1000.f;
+}
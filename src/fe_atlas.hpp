@@ -0,0 +1,131 @@
+/*
+ *
+ *  Attract-Mode Plus frontend
+ *  Copyright (C) 2025 Andrew Mickelson & Radek Dutkiewicz
+ *
+ *  This file is part of Attract-Mode Plus
+ *
+ *  Attract-Mode Plus is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Attract-Mode Plus is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Attract-Mode Plus.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef FE_ATLAS_HPP
+#define FE_ATLAS_HPP
+
+#include <SFML/Graphics/Texture.hpp>
+#include <SFML/Graphics/Rect.hpp>
+#include <string>
+#include <vector>
+#include <map>
+#include <cstdint>
+
+//
+// Shared texture pages that small images are packed into, so that images
+// such as wheel logos and icons don't each need their own texture and can
+// be drawn in a single batch.
+//
+// Images are packed onto shelves and keyed by filename.  A slot stays in
+// the atlas after its last user releases it, so showing the same image
+// again needs no decoding or upload.  Unused slots are reclaimed least
+// recently used first when there is no free space left.
+//
+// The atlas is disabled until a maximum image size is set.
+//
+class FeTextureAtlas
+{
+public:
+	static FeTextureAtlas &get_ref();
+
+	// Images up to this size in both dimensions are placed in the atlas.
+	// 0 disables the atlas
+	void set_max_image_size( int s );
+	int get_max_image_size() const { return m_max_size; };
+
+	bool accepts( int width, int height ) const;
+
+	// Return the slot holding the given image and add a reference to it,
+	// or -1 if it isn't in the atlas
+	int acquire( const std::string &key, bool smooth );
+
+	// Copy RGBA pixel data into the atlas and return its referenced slot,
+	// or -1 if there is no room.  If the image is already in the atlas, its
+	// slot is referenced and returned instead
+	int add( const std::string &key, bool smooth,
+		int width, int height, const std::uint8_t *data );
+
+	void release( int slot );
+
+	// Free the pages that none of their images are in use on, returns the
+	// number of bytes released
+	size_t release_pages();
+
+	const sf::Texture &get_texture( int slot ) const;
+	const sf::IntRect &get_rect( int slot ) const;
+
+	//
+	// Stats
+	//
+	int get_page_count() const { return (int)m_pages.size(); };
+	int get_image_count() const;
+	float get_occupancy() const; // % of the page area used by referenced images
+	float get_upload_time() const; // total upload time in milliseconds
+
+private:
+	FeTextureAtlas();
+	FeTextureAtlas( const FeTextureAtlas & );
+	FeTextureAtlas &operator=( const FeTextureAtlas & );
+
+	struct Shelf
+	{
+		int y;
+		int height;
+		int next_x;
+	};
+
+	struct Page
+	{
+		sf::Texture texture;
+		std::vector<Shelf> shelves;
+		int next_y;
+		bool smooth;
+	};
+
+	struct Slot
+	{
+		std::string key;
+		int page; // -1 if the slot's page has been freed
+		sf::IntRect cell; // allocated area, including padding
+		sf::IntRect rect; // image area
+		int ref_count;
+		unsigned int last_use;
+	};
+
+	bool allocate( bool smooth, int w, int h, int &page, sf::IntRect &cell );
+	int evict( bool smooth, int w, int h );
+	void upload( Slot &s, int width, int height, const std::uint8_t *data );
+	size_t purge(); // returns the number of bytes freed
+
+	std::string make_key( const std::string &key, bool smooth ) const;
+
+	std::vector<Page *> m_pages;
+	std::vector<Slot> m_slots;
+	std::map<std::string, int> m_lookup;
+	std::vector<std::uint8_t> m_buffer;
+	unsigned int m_page_size;
+	unsigned int m_use_count;
+	std::int64_t m_upload_us;
+	int m_max_size;
+};
+
+#endif
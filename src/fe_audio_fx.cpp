@@ -36,6 +36,7 @@ static constexpr float MAX_GAIN = 128.0f;
 #define _USE_MATH_DEFINES
 
 #define MEOW_FFT_IMPLEMENTATION
+#include "meow_fft.h"
 #include "fe_audio_fx.hpp"
 #include "fe_settings.hpp"
 #include "fe_present.hpp"
@@ -44,12 +45,148 @@ static constexpr float MAX_GAIN = 128.0f;
 #include <algorithm>
 #include <cstring>
 #include <cstdio>
+#include <chrono>
+#include <thread>
+#include <condition_variable>
+#include <iomanip>
+
+#if defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+#define FE_AUDIO_FX_SSE
+#include <emmintrin.h>
+#elif defined( __ARM_NEON ) || defined( __ARM_NEON__ )
+#define FE_AUDIO_FX_NEON
+#include <arm_neon.h>
+#endif
 
 // Undefine Windows GetObject macro that conflicts with Sqrat
 #ifdef GetObject
 #undef GetObject
 #endif
 
+namespace
+{
+	//
+	// Sample kernels used by the effects, these run on the audio thread
+	// for every block so have SSE2/NEON versions with a scalar fallback
+	//
+
+	// Return the peak absolute sample value
+	float fx_peak( const float *in, size_t count )
+	{
+		size_t i = 0;
+		float peak = 0.0f;
+
+#if defined( FE_AUDIO_FX_SSE )
+		const __m128 abs_mask = _mm_castsi128_ps( _mm_set1_epi32( 0x7fffffff ));
+		__m128 vpeak = _mm_setzero_ps();
+		for ( ; i + 4 <= count; i += 4 )
+			vpeak = _mm_max_ps( vpeak, _mm_and_ps( _mm_loadu_ps( in + i ), abs_mask ));
+
+		vpeak = _mm_max_ps( vpeak, _mm_shuffle_ps( vpeak, vpeak, _MM_SHUFFLE( 1, 0, 3, 2 )));
+		vpeak = _mm_max_ps( vpeak, _mm_shuffle_ps( vpeak, vpeak, _MM_SHUFFLE( 2, 3, 0, 1 )));
+		peak = _mm_cvtss_f32( vpeak );
+#elif defined( FE_AUDIO_FX_NEON )
+		float32x4_t vpeak = vdupq_n_f32( 0.0f );
+		for ( ; i + 4 <= count; i += 4 )
+			vpeak = vmaxq_f32( vpeak, vabsq_f32( vld1q_f32( in + i )));
+
+		float32x2_t vp = vmax_f32( vget_low_f32( vpeak ), vget_high_f32( vpeak ));
+		vp = vpmax_f32( vp, vp );
+		peak = vget_lane_f32( vp, 0 );
+#endif
+
+		for ( ; i < count; ++i )
+		{
+			float sample = std::abs( in[i] );
+			if ( sample > peak )
+				peak = sample;
+		}
+
+		return peak;
+	}
+
+	// out[i] = in[i] * gain
+	void fx_gain( const float *in, float *out, size_t count, float gain )
+	{
+		size_t i = 0;
+
+#if defined( FE_AUDIO_FX_SSE )
+		const __m128 vgain = _mm_set1_ps( gain );
+		for ( ; i + 4 <= count; i += 4 )
+			_mm_storeu_ps( out + i, _mm_mul_ps( _mm_loadu_ps( in + i ), vgain ));
+#elif defined( FE_AUDIO_FX_NEON )
+		for ( ; i + 4 <= count; i += 4 )
+			vst1q_f32( out + i, vmulq_n_f32( vld1q_f32( in + i ), gain ));
+#endif
+
+		for ( ; i < count; ++i )
+			out[i] = in[i] * gain;
+	}
+
+	//
+	// One-pole one-zero DC filter
+	// y[n] = x[n] - x[n-1] + coefficient * y[n-1]
+	//
+	// The filter is recursive so it can't be vectorised across samples,
+	// instead stereo frames are processed with both channels in one register
+	//
+	void fx_dc_filter( const float *in, float *out, unsigned int frame_count,
+		unsigned int channel_count, float coefficient, float *prev_in, float *prev_out )
+	{
+#if defined( FE_AUDIO_FX_SSE )
+		if ( channel_count == 2 )
+		{
+			const __m128 vcoef = _mm_set1_ps( coefficient );
+			__m128 px = _mm_castpd_ps( _mm_load_sd( reinterpret_cast<const double *>( prev_in )));
+			__m128 py = _mm_castpd_ps( _mm_load_sd( reinterpret_cast<const double *>( prev_out )));
+
+			for ( unsigned int frame = 0; frame < frame_count; ++frame )
+			{
+				__m128 x = _mm_castpd_ps( _mm_load_sd( reinterpret_cast<const double *>( in + frame * 2 )));
+				py = _mm_add_ps( _mm_sub_ps( x, px ), _mm_mul_ps( vcoef, py ));
+				px = x;
+				_mm_store_sd( reinterpret_cast<double *>( out + frame * 2 ), _mm_castps_pd( py ));
+			}
+
+			_mm_store_sd( reinterpret_cast<double *>( prev_in ), _mm_castps_pd( px ));
+			_mm_store_sd( reinterpret_cast<double *>( prev_out ), _mm_castps_pd( py ));
+			return;
+		}
+#elif defined( FE_AUDIO_FX_NEON )
+		if ( channel_count == 2 )
+		{
+			float32x2_t px = vld1_f32( prev_in );
+			float32x2_t py = vld1_f32( prev_out );
+
+			for ( unsigned int frame = 0; frame < frame_count; ++frame )
+			{
+				float32x2_t x = vld1_f32( in + frame * 2 );
+				py = vmla_n_f32( vsub_f32( x, px ), py, coefficient );
+				px = x;
+				vst1_f32( out + frame * 2, py );
+			}
+
+			vst1_f32( prev_in, px );
+			vst1_f32( prev_out, py );
+			return;
+		}
+#endif
+
+		for ( unsigned int frame = 0; frame < frame_count; ++frame )
+		{
+			for ( unsigned int ch = 0; ch < channel_count; ++ch )
+			{
+				const unsigned int sample_idx = frame * channel_count + ch;
+				const float input_sample = in[sample_idx];
+				const float output_sample = input_sample - prev_in[ch] + coefficient * prev_out[ch];
+				prev_in[ch] = input_sample;
+				prev_out[ch] = output_sample;
+				out[sample_idx] = output_sample;
+			}
+		}
+	}
+};
+
 FeAudioEffect::FeAudioEffect()
 {
 	const std::optional<std::uint32_t> device_sample_rate = sf::PlaybackDevice::getDeviceSampleRate();
@@ -57,6 +194,7 @@ FeAudioEffect::FeAudioEffect()
 }
 
 FeAudioEffectsManager::FeAudioEffectsManager()
+	: m_buffer( DEFAULT_BUFFER_SAMPLES, 0.0f )
 {
 }
 
@@ -73,11 +211,12 @@ void FeAudioEffectsManager::add_effect( std::unique_ptr<FeAudioEffect> effect )
 bool FeAudioEffectsManager::process_all( const float *input_frames, float *output_frames,
                                          unsigned int frame_count, unsigned int channel_count )
 {
+	const unsigned int total_samples = frame_count * channel_count;
+
 	// Don't process until all effects are fully constructed
-	if ( !m_ready_for_processing )
+	if ( !m_ready_for_processing || ( channel_count > FeAudioEffect::MAX_CHANNELS ))
 	{
 		// Pass-through during construction
-		const unsigned int total_samples = frame_count * channel_count;
 		std::memcpy( output_frames, input_frames, total_samples * sizeof( float ));
 		return false;
 	}
@@ -85,41 +224,55 @@ bool FeAudioEffectsManager::process_all( const float *input_frames, float *outpu
 	bool audio_modified = false;
 	m_reset_fx = true;
 
-	// First, copy input to output
-	const unsigned int total_samples = frame_count * channel_count;
-	std::memcpy( output_frames, input_frames, total_samples * sizeof( float ));
-
-	// Create a temporary buffer for chaining effects
-	std::vector<float> temp_buffer;
-	temp_buffer.resize( total_samples );
+	// Only grows if SFML hands us a bigger block than we preallocated for
+	if ( m_buffer.size() < total_samples )
+		m_buffer.resize( total_samples );
+
+	//
+	// Chain the effects through a ping-pong between output_frames and our
+	// preallocated buffer.  The buffer each effect writes to is picked so
+	// that the last effect that modifies the audio writes to output_frames,
+	// passthrough (analysis) effects read the current buffer in place.
+	//
+	int remaining = 0;
+	for ( auto& effect : m_effects )
+	{
+		if ( effect && effect->is_enabled() && !effect->is_passthrough() )
+			remaining++;
+	}
 
-	float* current_input = output_frames;
-	float* current_output = temp_buffer.data();
-	bool use_temp_as_output = true;
+	const float *current = input_frames;
+	float *temp = m_buffer.data();
 
-	for ( size_t i = 0; i < m_effects.size(); ++i )
+	for ( auto& effect : m_effects )
 	{
-		auto& effect = m_effects[i];
-		if ( effect && effect->is_enabled() )
+		if ( !effect || !effect->is_enabled() )
+			continue;
+
+		float *target;
+		if ( effect->is_passthrough() )
 		{
-			if ( effect->process( current_input, current_output, frame_count, channel_count ))
-				audio_modified = true;
+			if ( current == input_frames )
+				target = output_frames;
+			else
+				target = const_cast<float *>( current );
 		}
-		else if ( effect )
+		else
 		{
-			// Pass-through
-			std::memcpy( current_output, current_input, frame_count * channel_count * sizeof( float ) );
+			target = ( remaining-- % 2 ) ? output_frames : temp;
+			if ( target == current )
+				target = ( target == output_frames ) ? temp : output_frames;
 		}
 
-		std::swap( current_input, current_output );
-		use_temp_as_output = !use_temp_as_output;
+		if ( effect->process( current, target, frame_count, channel_count ))
+			audio_modified = true;
+
+		current = target;
 	}
 
 	// Ensure final result is in output_frames
-	if ( current_input != output_frames )
-	{
-		std::memcpy( output_frames, current_input, total_samples * sizeof( float ));
-	}
+	if ( current != output_frames )
+		std::memcpy( output_frames, current, total_samples * sizeof( float ));
 
 	return audio_modified;
 }
@@ -159,6 +312,118 @@ void FeAudioEffectsManager::set_ready_for_processing()
 	m_ready_for_processing = true;
 }
 
+//
+// Scratch buffers and FFT workset used by the analysis thread
+//
+struct FeAudioAnalysisScratch
+{
+	std::vector<uint8_t> workset_storage;
+	Meow_FFT_Workset_Real *workset;
+	std::vector<float> input;
+	std::vector<float> bands_left;
+	std::vector<float> bands_right;
+	std::vector<Meow_FFT_Complex> output;
+
+	FeAudioAnalysisScratch()
+		: workset( nullptr ),
+		input( FFT_BUFFER_SIZE, 0.0f ),
+		bands_left( FeAudioVisualiser::FFT_BANDS_MAX, 0.0f ),
+		bands_right( FeAudioVisualiser::FFT_BANDS_MAX, 0.0f ),
+		output( FFT_BUFFER_SIZE / 2 + 1 )
+	{
+		size_t workset_size = meow_fft_generate_workset_real( FFT_BUFFER_SIZE, nullptr );
+		workset_storage.resize( workset_size );
+		workset = reinterpret_cast<Meow_FFT_Workset_Real*>( workset_storage.data() );
+		meow_fft_generate_workset_real( FFT_BUFFER_SIZE, workset );
+	}
+};
+
+//
+// Analysis stage shared by all visualisers.  A single background thread
+// runs the FFTs for every stream that has submitted a block, so neither
+// the audio threads nor the main thread pay for them
+//
+class FeAudioAnalyser
+{
+public:
+	static FeAudioAnalyser &get()
+	{
+		static FeAudioAnalyser analyser;
+		return analyser;
+	}
+
+	void submit( FeAudioVisualiser *v )
+	{
+		{
+			std::lock_guard<std::mutex> lock( m_mutex );
+			if ( std::find( m_queue.begin(), m_queue.end(), v ) == m_queue.end() )
+				m_queue.push_back( v );
+
+			if ( !m_thread.joinable() )
+				m_thread = std::thread( &FeAudioAnalyser::run, this );
+		}
+		m_cv.notify_one();
+	}
+
+	// Remove v from the queue and wait for any analysis of it to finish
+	void cancel( FeAudioVisualiser *v )
+	{
+		std::unique_lock<std::mutex> lock( m_mutex );
+		m_queue.erase( std::remove( m_queue.begin(), m_queue.end(), v ), m_queue.end() );
+		m_done_cv.wait( lock, [&]{ return m_current != v; } );
+	}
+
+private:
+	FeAudioAnalyser()
+		: m_current( nullptr ),
+		m_quit( false )
+	{
+	}
+
+	~FeAudioAnalyser()
+	{
+		{
+			std::lock_guard<std::mutex> lock( m_mutex );
+			m_quit = true;
+		}
+		m_cv.notify_one();
+
+		if ( m_thread.joinable() )
+			m_thread.join();
+	}
+
+	void run()
+	{
+		FeAudioAnalysisScratch scratch;
+		std::unique_lock<std::mutex> lock( m_mutex );
+
+		while ( true )
+		{
+			m_cv.wait( lock, [&]{ return m_quit || !m_queue.empty(); } );
+			if ( m_quit )
+				break;
+
+			m_current = m_queue.front();
+			m_queue.erase( m_queue.begin() );
+			lock.unlock();
+
+			m_current->analyse( scratch );
+
+			lock.lock();
+			m_current = nullptr;
+			m_done_cv.notify_all();
+		}
+	}
+
+	std::mutex m_mutex;
+	std::condition_variable m_cv;
+	std::condition_variable m_done_cv;
+	std::vector<FeAudioVisualiser *> m_queue;
+	FeAudioVisualiser *m_current;
+	bool m_quit;
+	std::thread m_thread;
+};
+
 std::vector<float> FeAudioVisualiser::m_window_lut;
 
 FeAudioVisualiser::FeAudioVisualiser()
@@ -186,27 +451,29 @@ FeAudioVisualiser::FeAudioVisualiser()
 	m_buffer_write_pos( 0 ),
 	m_buffer_samples_count( 0 ),
 	m_phase_accumulator( 0.0 ),
-	m_fft_workset( nullptr )
+	m_fft_call_counter( 0 ),
+	m_job_left( FFT_BUFFER_SIZE, 0.0f ),
+	m_job_right( FFT_BUFFER_SIZE, 0.0f ),
+	m_job_channels( 0 ),
+	m_job_bands( 0 ),
+	m_job_pending( false ),
+	m_bands_back( 0 ),
+	m_bands_front( 1 ),
+	m_bands_middle( 2 )
 {
 	// Initialise Blackman window
 	if ( m_window_lut.empty() )
 		initialise_window_lut();
 
-	// Initialise MEOW_FFT
-	size_t workset_size = meow_fft_generate_workset_real( FFT_BUFFER_SIZE, nullptr );
-	m_fft_workset_storage.resize( workset_size );
-	m_fft_workset = reinterpret_cast<Meow_FFT_Workset_Real*>( m_fft_workset_storage.data() );
-	meow_fft_generate_workset_real( FFT_BUFFER_SIZE, m_fft_workset );
-
-	// Allocate FFT output buffer
-	m_fft_output_buffer.resize( FFT_BUFFER_SIZE / 2 + 1 );
+	std::memset( m_bands, 0, sizeof( m_bands ));
 }
 
 FeAudioVisualiser::~FeAudioVisualiser()
 {
+	FeAudioAnalyser::get().cancel( this );
 }
 
-float FeAudioVisualiser::convert_to_log_scale( float linear_value, float amplitude_linearity ) const
+float FeAudioVisualiser::convert_to_log_scale( float linear_value, float amplitude_linearity )
 {
 	if ( linear_value <= 1e-8f )
 		return 0.0f;
@@ -222,9 +489,10 @@ float FeAudioVisualiser::convert_to_log_scale( float linear_value, float amplitu
 bool FeAudioVisualiser::process( const float* input_frames, float* output_frames,
                                  unsigned int frame_count, unsigned int channel_count )
 {
-	// It's a passthrough effect
+	// It's a passthrough effect, the manager normally hands us the same buffer
 	const unsigned int total_samples = frame_count * channel_count;
-	std::memcpy( output_frames, input_frames, total_samples * sizeof( float ));
+	if ( output_frames != input_frames )
+		std::memcpy( output_frames, input_frames, total_samples * sizeof( float ));
 
 	std::lock_guard<std::mutex> lock( m_mutex );
 
@@ -245,11 +513,7 @@ bool FeAudioVisualiser::process( const float* input_frames, float* output_frames
 
 		if ( channel_count == 1 )
 		{
-			for ( unsigned int i = 0; i < frame_count; ++i )
-			{
-				float sample = std::abs( input_frames[i] );
-				if ( sample > peak_mono ) peak_mono = sample;
-			}
+			peak_mono = fx_peak( input_frames, frame_count );
 			peak_left = peak_right = peak_mono;
 		}
 		else if ( channel_count >= 2 )
@@ -261,10 +525,8 @@ bool FeAudioVisualiser::process( const float* input_frames, float* output_frames
 
 				float right_sample = std::abs( input_frames[i * channel_count + 1] );
 				if ( right_sample > peak_right ) peak_right = right_sample;
-
-				float max_sample = std::max( left_sample, right_sample );
-				if ( max_sample > peak_mono ) peak_mono = max_sample;
 			}
+			peak_mono = std::max( peak_left, peak_right );
 		}
 
 		// Hold the maximum peak until fall processing
@@ -278,67 +540,76 @@ bool FeAudioVisualiser::process( const float* input_frames, float* output_frames
 		if ( new_right > m_vu_right_in ) m_vu_right_in = new_right;
 	}
 
-	// Process FFT only if requested and we have enough data
+	// Hand the FFT off to the analysis thread if requested and we have enough data
 	if ( should_process_fft && channel_count >= 1 )
 	{
-		static int fft_call_counter = 0;
-		fft_call_counter++;
+		m_fft_call_counter++;
 
 		float sample_rate_factor = m_device_sample_rate / 48000.0f; // Normalise to 48kHz baseline
-		float band_factor = static_cast<float>(m_fft_bands) / 64.0f; // Normalise to 64 bands baseline
+		float band_factor = static_cast<float>( m_fft_bands ) / 64.0f; // Normalise to 64 bands baseline
 		float computational_load = sample_rate_factor * band_factor;
 
 		int throttle_factor = 1;
 		if ( computational_load > 2.0f )
 			throttle_factor = static_cast<int>( std::min( 4.0f, 1.0f + ( computational_load - 2.0f ) * 1.5f ));
 
-		if ( throttle_factor > 1 && ( fft_call_counter % throttle_factor ) != 0 )
+		if ( throttle_factor > 1 && ( m_fft_call_counter % throttle_factor ) != 0 )
 			return false;
 
 		// Only process if we have enough samples
 		if ( m_buffer_samples_count < FFT_BUFFER_SIZE )
 			return false;
 
-		std::vector<float> temp_mono( FFT_BUFFER_SIZE );
-		std::vector<float> temp_left( FFT_BUFFER_SIZE );
-		std::vector<float> temp_right( FFT_BUFFER_SIZE );
+		// The previous block is still being analysed, skip this one
+		if ( m_job_pending.load( std::memory_order_acquire ))
+			return false;
 
 		for ( size_t i = 0; i < FFT_BUFFER_SIZE; ++i )
 		{
 			size_t read_pos = ( m_buffer_write_pos + ROLLING_BUFFER_SIZE - FFT_BUFFER_SIZE + i ) % ROLLING_BUFFER_SIZE;
-			temp_mono[i] = m_rolling_buffer_mono[read_pos];
-			temp_left[i] = m_rolling_buffer_left[read_pos];
-			temp_right[i] = m_rolling_buffer_right[read_pos];
+			m_job_left[i] = m_rolling_buffer_left[read_pos];
+			m_job_right[i] = m_rolling_buffer_right[read_pos];
 		}
 
-		// Use temporary vectors for FFT calculation to avoid race conditions
-		std::vector<float> temp_fft_mono( FFT_BANDS_MAX, 0.0f );
-		std::vector<float> temp_fft_left( FFT_BANDS_MAX, 0.0f );
-		std::vector<float> temp_fft_right( FFT_BANDS_MAX, 0.0f );
+		m_job_channels = channel_count;
+		m_job_bands = m_fft_bands;
+		m_job_pending.store( true, std::memory_order_release );
 
-		if ( channel_count == 1 )
-		{
-			calculate_fft_channel( temp_mono.data(), FFT_BUFFER_SIZE, temp_fft_mono, RESAMPLE_RATE );
+		FeAudioAnalyser::get().submit( this );
+	}
 
-			std::copy( temp_fft_mono.begin(), temp_fft_mono.begin() + m_fft_bands, m_fft_mono_in.begin() );
-			std::copy( temp_fft_mono.begin(), temp_fft_mono.begin() + m_fft_bands, m_fft_left_in.begin() );
-			std::copy( temp_fft_mono.begin(), temp_fft_mono.begin() + m_fft_bands, m_fft_right_in.begin() );
-		}
-		else
-		{
-			calculate_fft_channel( temp_left.data(), FFT_BUFFER_SIZE, temp_fft_left, RESAMPLE_RATE );
-			calculate_fft_channel( temp_right.data(), FFT_BUFFER_SIZE, temp_fft_right, RESAMPLE_RATE );
+	return false;
+}
 
-			for ( int i = 0; i < m_fft_bands; ++i )
-				temp_fft_mono[i] = ( temp_fft_left[i] + temp_fft_right[i] ) * 0.5f;
+//
+// Runs on the analysis thread
+//
+void FeAudioVisualiser::analyse( FeAudioAnalysisScratch &scratch )
+{
+	const int band_count = m_job_bands;
+	Bands &b = m_bands[m_bands_back];
 
-			std::copy( temp_fft_left.begin(), temp_fft_left.begin() + m_fft_bands, m_fft_left_in.begin() );
-			std::copy( temp_fft_right.begin(), temp_fft_right.begin() + m_fft_bands, m_fft_right_in.begin() );
-			std::copy( temp_fft_mono.begin(), temp_fft_mono.begin() + m_fft_bands, m_fft_mono_in.begin() );
-		}
+	if ( m_job_channels == 1 )
+	{
+		calculate_fft_channel( m_job_left.data(), b.mono, band_count, RESAMPLE_RATE, scratch );
+
+		std::copy( b.mono, b.mono + band_count, b.left );
+		std::copy( b.mono, b.mono + band_count, b.right );
 	}
+	else
+	{
+		calculate_fft_channel( m_job_left.data(), b.left, band_count, RESAMPLE_RATE, scratch );
+		calculate_fft_channel( m_job_right.data(), b.right, band_count, RESAMPLE_RATE, scratch );
 
-	return false;
+		for ( int i = 0; i < band_count; ++i )
+			b.mono[i] = ( b.left[i] + b.right[i] ) * 0.5f;
+	}
+
+	b.count = band_count;
+
+	// Publish the results
+	m_bands_back = m_bands_middle.exchange( m_bands_back | BANDS_DIRTY, std::memory_order_acq_rel ) & ~BANDS_DIRTY;
+	m_job_pending.store( false, std::memory_order_release );
 }
 
 void FeAudioVisualiser::reset()
@@ -356,8 +627,6 @@ void FeAudioVisualiser::reset()
 	std::fill( m_rolling_buffer_left.begin(), m_rolling_buffer_left.end(), 0.0f );
 	std::fill( m_rolling_buffer_right.begin(), m_rolling_buffer_right.end(), 0.0f );
 
-	std::fill( m_fft_output_buffer.begin(), m_fft_output_buffer.end(), Meow_FFT_Complex{0.0f, 0.0f} );
-
 	m_buffer_write_pos = 0;
 	m_buffer_samples_count = 0;
 	m_phase_accumulator = 0.0;
@@ -369,113 +638,93 @@ void FeAudioVisualiser::reset()
 void FeAudioVisualiser::update()
 {
 	std::lock_guard<std::mutex> lock( m_mutex );
+
+	// Pick up the latest bands published by the analysis thread
+	if ( m_bands_middle.load( std::memory_order_acquire ) & BANDS_DIRTY )
+	{
+		m_bands_front = m_bands_middle.exchange( m_bands_front, std::memory_order_acq_rel ) & ~BANDS_DIRTY;
+
+		const Bands &b = m_bands[m_bands_front];
+		const int count = std::min( b.count, static_cast<int>( m_fft_bands ));
+		std::copy( b.mono, b.mono + count, m_fft_mono_in.begin() );
+		std::copy( b.left, b.left + count, m_fft_left_in.begin() );
+		std::copy( b.right, b.right + count, m_fft_right_in.begin() );
+	}
+
 	update_fall();
 }
 
-float FeAudioVisualiser::get_vu_mono() const
+void FeAudioVisualiser::mark_vu_requested() const
 {
 	m_vu_requested = true;
 	FePresent *fep = FePresent::script_get_fep();
 	if ( fep )
 		m_vu_request_time = fep->get_layout_time();
-
-	return m_vu_mono_out;
 }
 
-float FeAudioVisualiser::get_vu_left() const
+void FeAudioVisualiser::mark_fft_requested() const
 {
-	m_vu_requested = true;
+	m_fft_requested = true;
 	FePresent *fep = FePresent::script_get_fep();
 	if ( fep )
-		m_vu_request_time = fep->get_layout_time();
+		m_fft_request_time = fep->get_layout_time();
+}
+
+float FeAudioVisualiser::get_vu_mono() const
+{
+	mark_vu_requested();
+	return m_vu_mono_out;
+}
 
+float FeAudioVisualiser::get_vu_left() const
+{
+	mark_vu_requested();
 	return m_vu_left_out;
 }
 
 float FeAudioVisualiser::get_vu_right() const
 {
-	m_vu_requested = true;
-	FePresent *fep = FePresent::script_get_fep();
-	if ( fep )
-		m_vu_request_time = fep->get_layout_time();
-
+	mark_vu_requested();
 	return m_vu_right_out;
 }
 
-Sqrat::Array FeAudioVisualiser::get_fft_array_mono() const
+Sqrat::Array FeAudioVisualiser::get_script_fft_array( FeSqArrayCache &cache,
+	const std::vector<float> &bands ) const
 {
-	m_fft_requested = true;
-	FePresent *fep = FePresent::script_get_fep();
-	if ( fep )
-		m_fft_request_time = fep->get_layout_time();
+	mark_fft_requested();
 
 	HSQUIRRELVM vm = Sqrat::DefaultVM::Get();
+	HSQOBJECT obj = cache.fill( vm, bands.data(), m_fft_bands, FFT_BANDS_MAX );
 
-	Sqrat::Table fft_table( vm );
-	for ( int i = 0; i < FFT_BANDS_MAX; ++i )
-	{
-		if ( i < m_fft_bands )
-			fft_table.SetValue( i, m_fft_mono_out[i] );
-		else
-			fft_table.SetValue( i, 0.0f );
-	}
+	return Sqrat::Array( Sqrat::Object( obj, vm ));
+}
 
-	return Sqrat::Array( fft_table.GetObject(), vm );
+Sqrat::Array FeAudioVisualiser::get_fft_array_mono() const
+{
+	return get_script_fft_array( m_script_fft_mono, m_fft_mono_out );
 }
 
 Sqrat::Array FeAudioVisualiser::get_fft_array_left() const
 {
-	m_fft_requested = true;
-	FePresent *fep = FePresent::script_get_fep();
-	if ( fep )
-		m_fft_request_time = fep->get_layout_time();
-
-	HSQUIRRELVM vm = Sqrat::DefaultVM::Get();
-
-	Sqrat::Table fft_table( vm );
-	for ( int i = 0; i < FFT_BANDS_MAX; ++i )
-	{
-		if ( i < m_fft_bands )
-			fft_table.SetValue( i, m_fft_left_out[i] );
-		else
-			fft_table.SetValue( i, 0.0f );
-	}
-
-	return Sqrat::Array( fft_table.GetObject(), vm );
+	return get_script_fft_array( m_script_fft_left, m_fft_left_out );
 }
 
 Sqrat::Array FeAudioVisualiser::get_fft_array_right() const
 {
-	m_fft_requested = true;
-	FePresent *fep = FePresent::script_get_fep();
-	if ( fep )
-		m_fft_request_time = fep->get_layout_time();
-
-	HSQUIRRELVM vm = Sqrat::DefaultVM::Get();
-
-	Sqrat::Table fft_table( vm );
-	for ( int i = 0; i < FFT_BANDS_MAX; ++i )
-	{
-		if ( i < m_fft_bands )
-			fft_table.SetValue( i, m_fft_right_out[i] );
-		else
-			fft_table.SetValue( i, 0.0f );
-	}
-
-	return Sqrat::Array( fft_table.GetObject(), vm );
+	return get_script_fft_array( m_script_fft_right, m_fft_right_out );
 }
 
-void FeAudioVisualiser::calculate_fft_channel( const float* samples, unsigned int sample_count,
-                                               std::vector<float>& fft_bands, float sample_rate ) const
+void FeAudioVisualiser::calculate_fft_channel( const float* samples, float *fft_bands,
+                                               int band_count, float sample_rate,
+                                               FeAudioAnalysisScratch &scratch )
 {
-	// Create a temporary input buffer
-	std::vector<float> fft_input( FFT_BUFFER_SIZE, 0.0f );
+	std::vector<Meow_FFT_Complex> &fft_output = scratch.output;
 
 	// Apply Blackman window
-	for ( unsigned int i = 0; i < sample_count; ++i )
-		fft_input[i] = samples[i] * m_window_lut[i];
+	for ( unsigned int i = 0; i < FFT_BUFFER_SIZE; ++i )
+		scratch.input[i] = samples[i] * m_window_lut[i];
 
-	meow_fft_real( m_fft_workset, fft_input.data(), m_fft_output_buffer.data() );
+	meow_fft_real( scratch.workset, scratch.input.data(), fft_output.data() );
 
 	// Convert FFT bins to frequency bands
 	// Accumulate energy across frequency ranges
@@ -486,11 +735,11 @@ void FeAudioVisualiser::calculate_fft_channel( const float* samples, unsigned in
 
 	freq_max = std::min( freq_max, nyquist_freq );
 
-	for ( int band = 0; band < m_fft_bands; ++band )
+	for ( int band = 0; band < band_count; ++band )
 	{
 		// Calculate frequency range for this band
-		float band_start_ratio = static_cast<float>( band ) / m_fft_bands;
-		float band_end_ratio = static_cast<float>( band + 1 ) / m_fft_bands;
+		float band_start_ratio = static_cast<float>( band ) / band_count;
+		float band_end_ratio = static_cast<float>( band + 1 ) / band_count;
 
 		// Apply linear/logarithmic blending to band edges
 		float linear_start = freq_min + band_start_ratio * ( freq_max - freq_min );
@@ -503,7 +752,7 @@ void FeAudioVisualiser::calculate_fft_channel( const float* samples, unsigned in
 
 		// Convert to bin indices
 		int start_bin = std::max( 1, static_cast<int>( start_freq / bin_width ) ); // Skip DC bin
-		int end_bin = std::min( static_cast<int>( end_freq / bin_width ), static_cast<int>( m_fft_output_buffer.size() ) - 1 );
+		int end_bin = std::min( static_cast<int>( end_freq / bin_width ), static_cast<int>( fft_output.size() ) - 1 );
 
 		// Ensure we have at least one bin
 		if ( end_bin <= start_bin ) end_bin = start_bin + 1;
@@ -519,18 +768,18 @@ void FeAudioVisualiser::calculate_fft_channel( const float* samples, unsigned in
 
 			if ( bin == 0 )
 			{
-				real_part = m_fft_output_buffer[0].r;
+				real_part = fft_output[0].r;
 				imag_part = 0.0f;
 			}
 			else if ( bin == FFT_BUFFER_SIZE / 2 )
 			{
-				real_part = m_fft_output_buffer[0].j;
+				real_part = fft_output[0].j;
 				imag_part = 0.0f;
 			}
 			else
 			{
-				real_part = m_fft_output_buffer[bin].r;
-				imag_part = m_fft_output_buffer[bin].j;
+				real_part = fft_output[bin].r;
+				imag_part = fft_output[bin].j;
 			}
 
 			float magnitude = std::sqrt( real_part * real_part + imag_part * imag_part );
@@ -704,70 +953,46 @@ void FeAudioVisualiser::update_fall() const
 FeAudioNormaliser::FeAudioNormaliser()
 	: m_current_gain( 1.0f ),
 	m_target_reached( false ),
-	m_startup_delay( 0 ),
-	m_media_volume( 1.0f )
+	m_startup_delay( 0 )
 {
 }
 
 bool FeAudioNormaliser::process( const float *input_frames, float *output_frames,
                                  unsigned int frame_count, unsigned int channel_count )
 {
-	float current_peak = 0.0f;
-	for ( unsigned int i = 0; i < frame_count; ++i )
-	{
-		for ( unsigned int ch = 0; ch < channel_count; ++ch )
-		{
-			size_t idx = i * channel_count + ch;
-			float sample = std::abs(input_frames[idx]);
-			if ( sample > current_peak )
-				current_peak = sample;
-		}
-	}
+	const size_t total_samples = frame_count * channel_count;
 
-	float current_gain;
-	bool target_reached;
-	size_t startup_delay;
-	float media_volume;
-
-	// Read shared variables with minimal lock
+	if ( m_reset_pending.exchange( false, std::memory_order_acquire ))
 	{
-		std::lock_guard<std::mutex> lock( m_mutex );
-		current_gain = m_current_gain;
-		target_reached = m_target_reached;
-		startup_delay = m_startup_delay;
-		media_volume = m_media_volume;
+		m_current_gain = 1.0f;
+		m_target_reached = false;
+		m_startup_delay = 0;
 	}
 
+	if ( m_retarget_pending.exchange( false, std::memory_order_acquire ))
+		m_target_reached = false;
+
 	// Ignore the first 100ms to allow the DC filter to settle down
 	size_t startup_delay_threshold = static_cast<size_t>( 0.1f * m_device_sample_rate );
-	if ( startup_delay < startup_delay_threshold )
+	if ( m_startup_delay < startup_delay_threshold )
 	{
-		startup_delay += frame_count;
-		for ( unsigned int i = 0; i < frame_count; ++i )
-		{
-			for ( unsigned int ch = 0; ch < channel_count; ++ch )
-			{
-				size_t idx = i * channel_count + ch;
-				output_frames[idx] = input_frames[idx];
-			}
-		}
-
-		std::lock_guard<std::mutex> lock( m_mutex );
-		m_startup_delay = startup_delay;
-
+		m_startup_delay += frame_count;
+		std::memcpy( output_frames, input_frames, total_samples * sizeof( float ));
 		return true;
 	}
 
-	const float target_level = 0.5f * media_volume;
+	const float current_peak = fx_peak( input_frames, total_samples );
+	const float target_level = 0.5f * m_media_volume.load( std::memory_order_relaxed );
+	float current_gain = m_current_gain;
 
 	if ( current_peak > 0.0001f )
 	{
 		float output_level = current_peak * current_gain;
 
-		if ( !target_reached && output_level >= target_level )
-			target_reached = true;
+		if ( !m_target_reached && output_level >= target_level )
+			m_target_reached = true;
 
-		if ( target_reached )
+		if ( m_target_reached )
 		{
 			if ( output_level > target_level )
 			{
@@ -779,7 +1004,7 @@ bool FeAudioNormaliser::process( const float *input_frames, float *output_frames
 				current_gain += ( needed_gain - current_gain ) * fast_response;
 			}
 		}
-		else if ( !target_reached && output_level < target_level )
+		else if ( output_level < target_level )
 		{
 			// Slow gain increase
 			const float increase_time_ms = 1000.0f;
@@ -798,18 +1023,8 @@ bool FeAudioNormaliser::process( const float *input_frames, float *output_frames
 		current_gain = 1.0f;
 
 	// Apply gain to output
-	for ( unsigned int i = 0; i < frame_count; ++i )
-	{
-		for ( unsigned int ch = 0; ch < channel_count; ++ch )
-		{
-			size_t idx = i * channel_count + ch;
-			output_frames[idx] = input_frames[idx] * current_gain;
-		}
-	}
-
-	std::lock_guard<std::mutex> lock( m_mutex );
+	fx_gain( input_frames, output_frames, total_samples, current_gain );
 	m_current_gain = current_gain;
-	m_target_reached = target_reached;
 
 	return true;
 }
@@ -821,72 +1036,38 @@ void FeAudioNormaliser::update()
 
 void FeAudioNormaliser::reset()
 {
-	std::lock_guard<std::mutex> lock( m_mutex );
-	m_current_gain = 1.0f;
-	m_target_reached = false;
-	m_startup_delay = 0;
+	m_reset_pending.store( true, std::memory_order_release );
 }
 
 void FeAudioNormaliser::set_media_volume( float volume )
 {
-	std::lock_guard<std::mutex> lock( m_mutex );
-	m_target_reached = false;
-	m_media_volume = volume;
+	m_media_volume.store( volume, std::memory_order_relaxed );
+	m_retarget_pending.store( true, std::memory_order_release );
 }
 
 FeAudioDCFilter::FeAudioDCFilter( float cutoff_freq )
 	: m_cutoff_freq( cutoff_freq ),
 	m_coefficient( 0.0f )
 {
+	// Calculate one-pole one-zero DC filter coefficient
+	const float omega = 2.0f * M_PI * m_cutoff_freq / m_device_sample_rate;
+	m_coefficient = std::exp( -omega );
+
+	std::fill( m_prev_input, m_prev_input + MAX_CHANNELS, 0.0f );
+	std::fill( m_prev_output, m_prev_output + MAX_CHANNELS, 0.0f );
 }
 
 bool FeAudioDCFilter::process( const float *input_frames, float *output_frames,
                                unsigned int frame_count, unsigned int channel_count )
 {
-	float coefficient;
-	std::vector<float> prev_input;
-	std::vector<float> prev_output;
-
-	// Read shared variables with minimal lock
-	{
-		std::lock_guard<std::mutex> lock( m_mutex );
-		coefficient = m_coefficient;
-		prev_input = m_prev_input;
-		prev_output = m_prev_output;
-	}
-
-	if ( coefficient == 0.0f )
-	{
-		// Calculate one-pole one-zero DC filter coefficient
-		const float omega = 2.0f * M_PI * m_cutoff_freq / m_device_sample_rate;
-		coefficient = std::exp( -omega );
-	}
-
-	if ( prev_input.size() != channel_count )
-	{
-		prev_input.resize( channel_count, 0.0f );
-		prev_output.resize( channel_count, 0.0f );
-	}
-
-	// Apply one-pole one-zero DC filter
-	// y[n] = x[n] - x[n-1] + coefficient * y[n-1]
-	for ( unsigned int frame = 0; frame < frame_count; ++frame )
+	if ( m_reset_pending.exchange( false, std::memory_order_acquire ))
 	{
-		for ( unsigned int ch = 0; ch < channel_count; ++ch )
-		{
-			const unsigned int sample_idx = frame * channel_count + ch;
-			const float input_sample = input_frames[sample_idx];
-			const float output_sample = input_sample - prev_input[ch] + coefficient * prev_output[ch];
-			prev_input[ch] = input_sample;
-			prev_output[ch] = output_sample;
-			output_frames[sample_idx] = output_sample;
-		}
+		std::fill( m_prev_input, m_prev_input + MAX_CHANNELS, 0.0f );
+		std::fill( m_prev_output, m_prev_output + MAX_CHANNELS, 0.0f );
 	}
 
-	std::lock_guard<std::mutex> lock( m_mutex );
-	m_coefficient = coefficient;
-	m_prev_input = prev_input;
-	m_prev_output = prev_output;
+	fx_dc_filter( input_frames, output_frames, frame_count,
+		std::min( channel_count, MAX_CHANNELS ), m_coefficient, m_prev_input, m_prev_output );
 
 	return true;
 }
@@ -898,10 +1079,7 @@ void FeAudioDCFilter::update()
 
 void FeAudioDCFilter::reset()
 {
-	std::lock_guard<std::mutex> lock( m_mutex );
-	std::fill( m_prev_input.begin(), m_prev_input.end(), 0.0f );
-	std::fill( m_prev_output.begin(), m_prev_output.end(), 0.0f );
-	m_coefficient = 0.0f;
+	m_reset_pending.store( true, std::memory_order_release );
 }
 
 void FeAudioVisualiser::initialise_window_lut()
@@ -932,3 +1110,73 @@ void FeAudioVisualiser::set_fft_bands( int count )
 	count = std::max( 2, std::min( count, FFT_BANDS_MAX ));
 	m_fft_bands = count;
 }
+
+void FeAudioEffectsManager::benchmark()
+{
+	const unsigned int FRAMES = 1024;
+	const unsigned int CHANNELS = 2;
+	const int ITERATIONS = 2000;
+
+	// Synthetic test signal, a quiet tone with a DC offset
+	std::vector<float> input( FRAMES * CHANNELS );
+	std::vector<float> output( FRAMES * CHANNELS );
+	for ( unsigned int i = 0; i < FRAMES; ++i )
+	{
+		float sample = 0.05f + 0.1f * std::sin( 2.0f * M_PI * 440.0f * i / 48000.0f );
+		input[i * CHANNELS] = sample;
+		input[i * CHANNELS + 1] = -sample;
+	}
+
+	auto run = [&]( const char *name, FeAudioEffectsManager &manager )
+	{
+		manager.set_ready_for_processing();
+
+		// Warm up, lets the normaliser get past its startup delay
+		for ( int i = 0; i < 100; ++i )
+			manager.process_all( input.data(), output.data(), FRAMES, CHANNELS );
+
+		auto start = std::chrono::steady_clock::now();
+		for ( int i = 0; i < ITERATIONS; ++i )
+			manager.process_all( input.data(), output.data(), FRAMES, CHANNELS );
+
+		auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now() - start ).count();
+
+		FeLog() << " - " << std::setw( 12 ) << std::left << name
+			<< std::fixed << std::setprecision( 3 )
+			<< static_cast<double>( ns ) / ( static_cast<double>( ITERATIONS ) * FRAMES )
+			<< " ns/frame" << std::endl;
+	};
+
+	FeLog() << "Audio effects benchmark (" << FRAMES << " frames x "
+		<< CHANNELS << " channels, " << ITERATIONS << " blocks):" << std::endl;
+
+	{
+		FeAudioEffectsManager m;
+		run( "passthrough", m );
+	}
+	{
+		FeAudioEffectsManager m;
+		m.add_effect( std::make_unique<FeAudioDCFilter>() );
+		run( "dc filter", m );
+	}
+	{
+		FeAudioEffectsManager m;
+		m.add_effect( std::make_unique<FeAudioNormaliser>() );
+		run( "normaliser", m );
+	}
+	{
+		FeAudioEffectsManager m;
+		m.add_effect( std::make_unique<FeAudioVisualiser>() );
+		m.get_effect<FeAudioVisualiser>()->get_vu_mono();
+		run( "visualiser", m );
+	}
+	{
+		FeAudioEffectsManager m;
+		m.add_effect( std::make_unique<FeAudioDCFilter>() );
+		m.add_effect( std::make_unique<FeAudioNormaliser>() );
+		m.add_effect( std::make_unique<FeAudioVisualiser>() );
+		m.get_effect<FeAudioVisualiser>()->get_vu_mono();
+		run( "full chain", m );
+	}
+}
@@ -31,7 +31,7 @@
 #include <sqrat.h>
 #include <cmath>
 
-#include "meow_fft.h"
+#include "fe_util_sq.hpp"
 
 class FeAudioEffect
 {
@@ -49,6 +49,12 @@ public:
 	virtual bool is_enabled() const { return m_enabled; }
 	virtual void set_enabled( bool enabled ) { m_enabled = enabled; }
 
+	// Effects that only analyse the audio return true here, the manager
+	// may then pass the same buffer as both input and output
+	virtual bool is_passthrough() const { return false; }
+
+	static constexpr unsigned int MAX_CHANNELS = 8;
+
 protected:
 	std::atomic<bool> m_enabled = true;
 	float m_device_sample_rate;
@@ -73,8 +79,16 @@ public:
 	template<typename T>
 	T* get_effect() const;
 
+	// Run each effect over a synthetic signal and log the ns per frame
+	static void benchmark();
+
 private:
+	// Samples preallocated for the ping-pong buffer, enough for the
+	// block sizes SFML uses so the audio thread doesn't allocate
+	static constexpr unsigned int DEFAULT_BUFFER_SAMPLES = 8192 * 2;
+
 	std::vector<std::unique_ptr<FeAudioEffect>> m_effects;
+	std::vector<float> m_buffer;
 	std::atomic<bool> m_reset_fx{false};
 	std::atomic<bool> m_ready_for_processing{false};
 };
@@ -94,15 +108,28 @@ public:
 
 private:
 	float m_cutoff_freq;
-	mutable std::mutex m_mutex;
-	mutable float m_coefficient;
-	mutable std::vector<float> m_prev_input;  // Previous input samples per channel
-	mutable std::vector<float> m_prev_output; // Previous output samples per channel
+	float m_coefficient;
+
+	// Filter state is only touched by the audio thread, other threads
+	// request a reset through m_reset_pending
+	std::atomic<bool> m_reset_pending{ false };
+	float m_prev_input[MAX_CHANNELS];  // Previous input samples per channel
+	float m_prev_output[MAX_CHANNELS]; // Previous output samples per channel
 };
 
 
+struct FeAudioAnalysisScratch;
+
+//
+// VU and FFT analysis of a stream.  VU peaks are measured on the audio
+// thread, while the FFTs for all channels are computed once per block by
+// the shared analysis thread (see FeAudioAnalyser) and published through
+// a lock-free triple buffer for the main thread to pick up in update()
+//
 class FeAudioVisualiser : public FeAudioEffect
 {
+	friend class FeAudioAnalyser;
+
 public:
 	FeAudioVisualiser();
 	~FeAudioVisualiser() override;
@@ -112,12 +139,14 @@ public:
 
 	void update() override;
 	void reset() override;
+	bool is_passthrough() const override { return true; }
 
 	float get_vu_mono() const;
 	float get_vu_left() const;
 	float get_vu_right() const;
 
-	// Sqrat bindings for FFT arrays
+	// Sqrat bindings for FFT arrays, these return a preallocated
+	// array that is refilled on each call
 	Sqrat::Array get_fft_array_mono() const;
 	Sqrat::Array get_fft_array_left() const;
 	Sqrat::Array get_fft_array_right() const;
@@ -150,11 +179,11 @@ private:
 
 	mutable sf::Time m_last_frame_time;
 	mutable sf::Clock m_system_clock;
-	mutable bool m_vu_requested;
-	mutable bool m_fft_requested;
+	mutable std::atomic<bool> m_vu_requested;
+	mutable std::atomic<bool> m_fft_requested;
 	mutable sf::Time m_vu_request_time;
 	mutable sf::Time m_fft_request_time;
-	int m_fft_bands;
+	std::atomic<int> m_fft_bands;
 
 	// Rolling buffer and resampling for FFT
 	std::vector<float> m_rolling_buffer_mono;
@@ -164,16 +193,48 @@ private:
 	size_t m_buffer_write_pos;
 	size_t m_buffer_samples_count;
 	double m_phase_accumulator;
-
-	// Meow FFT worksets and buffers
-	std::vector<uint8_t> m_fft_workset_storage;
-	Meow_FFT_Workset_Real* m_fft_workset;
-	mutable std::vector<Meow_FFT_Complex> m_fft_output_buffer;
-
-	void calculate_fft_channel( const float *samples , unsigned int sample_count ,
-	                            std::vector<float> &fft_bands , float sample_rate ) const;
+	int m_fft_call_counter;
+
+	// Snapshot of the rolling buffers handed to the analysis thread,
+	// owned by the analysis thread while m_job_pending is set
+	std::vector<float> m_job_left;
+	std::vector<float> m_job_right;
+	unsigned int m_job_channels;
+	int m_job_bands;
+	std::atomic<bool> m_job_pending;
+
+	// Triple buffered band results.  The analysis thread fills the back
+	// buffer and swaps it with the middle, update() swaps the middle
+	// with the front when the dirty bit is set
+	struct Bands
+	{
+		float mono[FFT_BANDS_MAX];
+		float left[FFT_BANDS_MAX];
+		float right[FFT_BANDS_MAX];
+		int count;
+	};
+
+	static constexpr int BANDS_DIRTY = 4;
+	Bands m_bands[3];
+	int m_bands_back;
+	int m_bands_front;
+	std::atomic<int> m_bands_middle;
+
+	// Preallocated script arrays
+	mutable FeSqArrayCache m_script_fft_mono;
+	mutable FeSqArrayCache m_script_fft_left;
+	mutable FeSqArrayCache m_script_fft_right;
+
+	void analyse( FeAudioAnalysisScratch &scratch );
+	Sqrat::Array get_script_fft_array( FeSqArrayCache &cache, const std::vector<float> &bands ) const;
+	void mark_fft_requested() const;
+	void mark_vu_requested() const;
+
+	static void calculate_fft_channel( const float *samples, float *fft_bands,
+	                                   int band_count, float sample_rate,
+	                                   FeAudioAnalysisScratch &scratch );
 	void update_fall() const;
-	float convert_to_log_scale( float linear_value, float amplitude_linearity ) const;
+	static float convert_to_log_scale( float linear_value, float amplitude_linearity );
 	bool resample_and_buffer_audio( const float* input_frames, unsigned int input_frame_count,
 	                                unsigned int frame_channel_count );
 };
@@ -193,11 +254,15 @@ public:
 	void set_media_volume( float volume );
 
 private:
-	mutable std::mutex m_mutex;
+	// Parameters exchanged with the main thread
+	std::atomic<float> m_media_volume{ 1.0f };
+	std::atomic<bool> m_reset_pending{ false };
+	std::atomic<bool> m_retarget_pending{ false };
+
+	// State only touched by the audio thread
 	float m_current_gain = 1.0f;
 	bool m_target_reached = false;
 	size_t m_startup_delay = 0;
-	float m_media_volume = 1.0f;
 };
 
 template<typename T>
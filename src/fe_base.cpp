@@ -70,12 +70,13 @@ const std::uint32_t FE_CACHE_VERSION = FE_CACHE_VERSION_D;
 
 namespace {
 	nowide::ofstream g_logfile;
-#ifdef SFML_SYSTEM_WINDOWS
-	nowide::ofstream g_nullstream( "NUL" );
-#else
-	nowide::ofstream g_nullstream( "/dev/null" );
-#endif
+
+	// Discards everything written to it.  There is one per thread, as the
+	// romlist build workers log at the same time
+	thread_local std::ostream t_nullstream( NULL );
+
 	enum FeLogLevel g_log_level=FeLog_Info;
+	thread_local std::ostream *t_thread_log=NULL;
 
 #ifndef NO_MOVIE
 	void ffmpeg_log_callback( void *ptr, int level, const char *fmt, va_list vargs )
@@ -95,13 +96,16 @@ std::ostream &FeDebug()
 	if ( g_log_level == FeLog_Debug )
 		return FeLog();
 	else
-		return g_nullstream;
+		return t_nullstream;
 }
 
 std::ostream &FeLog()
 {
 	if ( g_log_level == FeLog_Silent )
-		return g_nullstream;
+		return t_nullstream;
+
+	if ( t_thread_log )
+		return *t_thread_log;
 
 	if ( g_logfile.is_open() )
 		return g_logfile;
@@ -117,6 +121,11 @@ void fe_set_log_file( const std::string &fn )
 		g_logfile.open( fn.c_str() );
 }
 
+void fe_set_thread_log( std::ostream *s )
+{
+	t_thread_log = s;
+}
+
 void fe_set_log_level( enum FeLogLevel f )
 {
 	g_log_level = f;
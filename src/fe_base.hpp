@@ -65,6 +65,9 @@ std::ostream &FeLog();
 std::ostream &FeDebug();
 void fe_set_log_file( const std::string & );
 void fe_set_log_level( enum FeLogLevel );
+
+// Send log output from the calling thread to "s" instead, NULL to stop
+void fe_set_thread_log( std::ostream *s );
 void fe_print_version();
 
 class FeBaseConfigurable
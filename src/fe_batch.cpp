@@ -0,0 +1,147 @@
+/*
+ *
+ *  Attract-Mode Plus frontend
+ *  Copyright (C) 2025 Andrew Mickelson & Radek Dutkiewicz
+ *
+ *  This file is part of Attract-Mode Plus
+ *
+ *  Attract-Mode Plus is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Attract-Mode Plus is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Attract-Mode Plus.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "fe_batch.hpp"
+#include "sprite.hpp"
+#include <SFML/Graphics/RenderTarget.hpp>
+
+unsigned int FeDrawBatch::m_draw_calls = 0;
+unsigned int FeDrawBatch::m_batched = 0;
+unsigned int FeDrawBatch::m_texture_binds = 0;
+
+FeDrawBatch::FeDrawBatch( sf::RenderTarget &target )
+	: m_target( target ),
+	m_vertices( sf::PrimitiveType::Triangles ),
+	m_bound( NULL ),
+	m_anisotropic( false )
+{
+}
+
+FeDrawBatch::~FeDrawBatch()
+{
+	flush();
+}
+
+void FeDrawBatch::add( const sf::VertexArray &v,
+	const sf::RenderStates &states,
+	bool anisotropic )
+{
+	const sf::PrimitiveType type = v.getPrimitiveType();
+	const std::size_t count = v.getVertexCount();
+
+	if (( type != sf::PrimitiveType::Triangles )
+			&& ( type != sf::PrimitiveType::TriangleStrip ))
+	{
+		draw( v, states );
+		return;
+	}
+
+	if ( count < 3 )
+		return;
+
+	if (( m_vertices.getVertexCount() > 0 )
+			&& (( states.texture != m_states.texture )
+				|| ( states.shader != m_states.shader )
+				|| ( states.blendMode != m_states.blendMode )
+				|| ( states.stencilMode != m_states.stencilMode )
+				|| ( states.coordinateType != m_states.coordinateType )))
+		flush();
+
+	if ( m_vertices.getVertexCount() == 0 )
+	{
+		m_states = states;
+		m_states.transform = sf::Transform::Identity;
+	}
+
+	m_anisotropic |= anisotropic;
+	m_batched++;
+
+	sf::Vertex vert;
+	if ( type == sf::PrimitiveType::Triangles )
+	{
+		for ( std::size_t i=0; i<count; i++ )
+		{
+			vert = v[i];
+			vert.position = states.transform.transformPoint( vert.position );
+			m_vertices.append( vert );
+		}
+	}
+	else
+	{
+		//
+		// Unroll the strip into separate triangles.  Degenerate triangles
+		// from repeated vertices are kept, they draw nothing
+		//
+		for ( std::size_t i=2; i<count; i++ )
+		{
+			for ( std::size_t j=i-2; j<=i; j++ )
+			{
+				vert = v[j];
+				vert.position = states.transform.transformPoint( vert.position );
+				m_vertices.append( vert );
+			}
+		}
+	}
+}
+
+void FeDrawBatch::draw( const sf::Drawable &d, const sf::RenderStates &states )
+{
+	flush();
+	submit( d, states );
+	m_draw_calls++;
+
+	// We don't know what the drawable bound
+	m_bound = NULL;
+}
+
+void FeDrawBatch::flush()
+{
+	if ( m_vertices.getVertexCount() == 0 )
+		return;
+
+	submit( m_vertices, m_states );
+	m_draw_calls++;
+
+	if ( m_states.texture != m_bound )
+	{
+		m_bound = m_states.texture;
+		m_texture_binds++;
+	}
+
+	if ( m_anisotropic )
+		FeSprite::applyAnisotropicFilter();
+
+	m_vertices.clear();
+	m_anisotropic = false;
+}
+
+void FeDrawBatch::submit( const sf::Drawable &d, const sf::RenderStates &states )
+{
+	m_target.draw( d, states );
+}
+
+void FeDrawBatch::reset_counts()
+{
+	m_draw_calls = 0;
+	m_batched = 0;
+	m_texture_binds = 0;
+}
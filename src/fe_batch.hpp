@@ -0,0 +1,92 @@
+/*
+ *
+ *  Attract-Mode Plus frontend
+ *  Copyright (C) 2025 Andrew Mickelson & Radek Dutkiewicz
+ *
+ *  This file is part of Attract-Mode Plus
+ *
+ *  Attract-Mode Plus is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Attract-Mode Plus is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Attract-Mode Plus.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef FE_BATCH_HPP
+#define FE_BATCH_HPP
+
+#include <SFML/Graphics/RenderStates.hpp>
+#include <SFML/Graphics/VertexArray.hpp>
+
+namespace sf
+{
+	class RenderTarget;
+	class Drawable;
+};
+
+//
+// Collects consecutive vertex arrays that share a texture, blend mode and
+// shader and submits them to the render target as a single draw call.
+// Vertices are transformed when they are added, so the batch is drawn
+// with an identity transform.
+//
+// Anything that can't be batched is drawn with draw(), which submits the
+// pending batch first so the drawing order is preserved.
+//
+class FeDrawBatch
+{
+public:
+	FeDrawBatch( sf::RenderTarget &target );
+	virtual ~FeDrawBatch();
+
+	// Add Triangles or TriangleStrip vertices.  anisotropic requests the
+	// anisotropic filtering setting be applied to the texture when drawn
+	void add( const sf::VertexArray &v,
+		const sf::RenderStates &states,
+		bool anisotropic=false );
+
+	void draw( const sf::Drawable &d, const sf::RenderStates &states );
+
+	// submit the pending batch to the render target
+	void flush();
+
+	sf::RenderTarget &get_target() { return m_target; };
+
+	//
+	// Draw calls and batched vertex arrays submitted since the last
+	// call to reset_counts()
+	//
+	static unsigned int get_draw_calls() { return m_draw_calls; };
+	static unsigned int get_batched() { return m_batched; };
+	static unsigned int get_texture_binds() { return m_texture_binds; };
+	static void reset_counts();
+
+protected:
+	// Draw to the render target.  Overridden by the tests to record what
+	// would be drawn.  The destructor's flush() doesn't reach an override
+	virtual void submit( const sf::Drawable &d, const sf::RenderStates &states );
+
+private:
+	FeDrawBatch( const FeDrawBatch & );
+	FeDrawBatch &operator=( const FeDrawBatch & );
+
+	sf::RenderTarget &m_target;
+	sf::VertexArray m_vertices;
+	sf::RenderStates m_states;
+	const sf::Texture *m_bound; // texture of the last batch drawn
+	bool m_anisotropic;
+
+	static unsigned int m_draw_calls;
+	static unsigned int m_batched;
+	static unsigned int m_texture_binds;
+};
+
+#endif
@@ -1,4 +1,8 @@
 #include "fe_cache.hpp"
+#include "zip.hpp"
+#include "scraper_xml.hpp"
+#include <iomanip>
+#include <sstream>
 #include <ctime>
 
 // Enable the romlist cache
@@ -76,6 +80,9 @@ const char *FE_CACHE_AVAILABLE = "available";
 const char *FE_CACHE_ROMLIST = "romlist";
 const char *FE_CACHE_CONFIG = "config";
 const char *FE_CACHE_GLOBALFILTER = "globalfilter";
+const char *FE_CACHE_ARCHIVE = "archive";
+const char *FE_CACHE_SCRIPT = "script";
+const char *FE_CACHE_LISTXML = "listxml";
 const std::string FE_EMPTY_STRING;
 
 std::vector<FeDisplayInfo>* FeCache::m_displays = {};
@@ -136,10 +143,17 @@ bool FeCache::save_globalfilter( const FeDisplayInfo &display, const FeRomList &
 bool FeCache::load_globalfilter( const FeDisplayInfo &display, FeRomList &romlist ) { return false; }
 bool FeCache::save_filter( FeDisplayInfo &display, const FeFilterEntry &entry, const int filter_index ) { return false; }
 bool FeCache::load_filter( FeDisplayInfo &display, FeFilterEntry &entry, const int filter_index, const std::map<int, FeRomInfo*> &lookup ) { return false; }
+void FeCache::invalidate_filter( const FeDisplayInfo &display, const int filter_index ) {}
 void FeCache::invalidate_rominfo( const FeRomList &romlist, const std::set<FeRomInfo::Index> targets ) {}
 void FeCache::clear_stats() {}
 bool FeCache::set_stats_info( const std::string &path, const std::vector<std::string> &rominfo ) { return false; }
 bool FeCache::get_stats_info( const std::string &path, std::vector<std::string> &rominfo ) { return false; }
+bool FeCache::save_archive_toc( const std::string &archive, const FeArchiveToc &toc ) { return false; }
+bool FeCache::load_archive_toc( const std::string &archive, FeArchiveToc &toc ) { return false; }
+bool FeCache::save_script( const FeCacheScript &script ) { return false; }
+bool FeCache::load_script( const std::string &path, std::uint32_t consts, FeCacheScript &script ) { return false; }
+bool FeCache::save_listxml( const FeListXMLDigest &digest ) { return false; }
+bool FeCache::load_listxml( const std::string &executable, FeListXMLDigest &digest ) { return false; }
 
 #else
 
@@ -238,6 +252,62 @@ std::string FeCache::get_stats_filename(
 		: m_config_path + FE_CACHE_SUBDIR + FE_CACHE_EMULATOR + "." + sanitize_filename( emulator ) + "." + FE_CACHE_STATS + FE_CACHE_EXT;
 }
 
+namespace
+{
+	// FNV-1a
+	std::string path_hash( const std::string &path, std::uint32_t hash=2166136261u )
+	{
+		for ( std::string::const_iterator itr=path.begin(); itr!=path.end(); ++itr )
+		{
+			hash ^= (unsigned char)(*itr);
+			hash *= 16777619u;
+		}
+
+		std::ostringstream ss;
+		ss << std::hex << std::setfill( '0' ) << std::setw( 8 ) << hash;
+		return ss.str();
+	}
+};
+
+//
+// Archive paths can be long and contain any characters, so the archive toc
+// filename is made from the archive's filename plus a hash of its full path
+//
+std::string FeCache::get_archive_toc_filename(
+	const std::string &archive
+)
+{
+	if ( archive.empty() || m_config_path.empty() )
+		return FE_EMPTY_STRING;
+
+	return m_config_path + FE_CACHE_SUBDIR + FE_CACHE_ARCHIVE + "." + sanitize_filename( path_filename( archive ) ) + "." + path_hash( archive ) + FE_CACHE_EXT;
+}
+
+//
+// Script filenames are made the same way, the const table hash is included
+// so a script run in vms with different constants has a cache for each
+//
+std::string FeCache::get_script_filename(
+	const std::string &path,
+	std::uint32_t consts
+)
+{
+	if ( path.empty() || m_config_path.empty() )
+		return FE_EMPTY_STRING;
+
+	return m_config_path + FE_CACHE_SUBDIR + FE_CACHE_SCRIPT + "." + sanitize_filename( path_filename( path ) ) + "." + path_hash( path, consts ) + FE_CACHE_EXT;
+}
+
+std::string FeCache::get_listxml_filename(
+	const std::string &executable
+)
+{
+	if ( executable.empty() || m_config_path.empty() )
+		return FE_EMPTY_STRING;
+
+	return m_config_path + FE_CACHE_SUBDIR + FE_CACHE_LISTXML + "." + sanitize_filename( path_filename( executable ) ) + "." + path_hash( executable ) + FE_CACHE_EXT;
+}
+
 // -------------------------------------------------------------------------------------
 
 template <typename T>
@@ -927,4 +997,96 @@ bool FeCache::set_stats_info(
 	return save_stats( emulator );
 }
 
+// -------------------------------------------------------------------------------------
+//
+// Archive Toc Cache stores the table of contents of an archive
+// - The toc records the archive's size and mtime, which the caller checks for staleness
+//
+
+bool FeCache::save_archive_toc(
+	const std::string &archive,
+	const FeArchiveToc &toc
+)
+{
+	std::string filename = get_archive_toc_filename( archive );
+	bool success = !filename.empty() && save_cache( filename, toc );
+	debug( "Save Archive Toc Cache", archive, success );
+	if ( !success && !filename.empty() ) delete_cache( filename );
+	_debug();
+	return success;
+}
+
+bool FeCache::load_archive_toc(
+	const std::string &archive,
+	FeArchiveToc &toc
+)
+{
+	std::string filename = get_archive_toc_filename( archive );
+	bool success = !filename.empty() && load_cache( filename, toc );
+	debug( "Load Archive Toc Cache", archive, success );
+	_debug();
+	return success;
+}
+
+// -------------------------------------------------------------------------------------
+//
+// Script Cache stores the compiled bytecode of a layout, plugin or module script
+// - The script records its source size, mtime and interpreter, which the caller checks for staleness
+//
+
+bool FeCache::save_script(
+	const FeCacheScript &script
+)
+{
+	std::string filename = get_script_filename( script.path, script.consts );
+	bool success = !filename.empty() && save_cache( filename, script );
+	debug( "Save Script Cache", script.path, success );
+	if ( !success && !filename.empty() ) delete_cache( filename );
+	_debug();
+	return success;
+}
+
+bool FeCache::load_script(
+	const std::string &path,
+	std::uint32_t consts,
+	FeCacheScript &script
+)
+{
+	std::string filename = get_script_filename( path, consts );
+	bool success = !filename.empty() && load_cache( filename, script );
+	debug( "Load Script Cache", path, success );
+	_debug();
+	return success;
+}
+
+// -------------------------------------------------------------------------------------
+//
+// Listxml Cache stores the digest of an emulator's -listxml output
+// - The digest records the executable's size and mtime, which the caller checks for staleness
+//
+
+bool FeCache::save_listxml(
+	const FeListXMLDigest &digest
+)
+{
+	std::string filename = get_listxml_filename( digest.executable );
+	bool success = !filename.empty() && save_cache( filename, digest );
+	debug( "Save Listxml Cache", digest.executable, success );
+	if ( !success && !filename.empty() ) delete_cache( filename );
+	_debug();
+	return success;
+}
+
+bool FeCache::load_listxml(
+	const std::string &executable,
+	FeListXMLDigest &digest
+)
+{
+	std::string filename = get_listxml_filename( executable );
+	bool success = !filename.empty() && load_cache( filename, digest );
+	debug( "Load Listxml Cache", executable, success );
+	_debug();
+	return success;
+}
+
 #endif
\ No newline at end of file
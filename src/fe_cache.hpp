@@ -11,6 +11,30 @@
 #include <cereal/types/map.hpp>
 #include <cereal/types/vector.hpp>
 
+class FeArchiveToc;
+class FeListXMLDigest;
+
+// Cache class used to save compiled script bytecode
+class FeCacheScript
+{
+public:
+	std::string path;
+	std::int64_t mtime=0;
+	std::uint64_t size=0;
+	std::uint32_t interpreter=0; // squirrel version and type sizes
+	std::uint32_t consts=0; // hash of the const table the script was compiled against
+	std::vector<std::uint8_t> bytecode;
+
+	template<class Archive>
+	void serialize( Archive &archive, std::uint32_t const version )
+	{
+		if ( version != FE_CACHE_VERSION ) throw "Invalid FeCacheScript cache";
+		archive( path, mtime, size, interpreter, consts, bytecode );
+	}
+};
+
+CEREAL_CLASS_VERSION( FeCacheScript, FE_CACHE_VERSION );
+
 class FeCache
 {
 private:
@@ -57,6 +81,19 @@ private:
 		const std::string &emulator
 	);
 
+	static std::string get_archive_toc_filename(
+		const std::string &archive
+	);
+
+	static std::string get_script_filename(
+		const std::string &path,
+		std::uint32_t consts
+	);
+
+	static std::string get_listxml_filename(
+		const std::string &executable
+	);
+
 	// ----------------------------------------------------------------------------------
 
 	template <typename T>
@@ -132,11 +169,6 @@ private:
 		const FeDisplayInfo &display
 	);
 
-	static void invalidate_filter(
-		const FeDisplayInfo &display,
-		const int filter_index
-	);
-
 	static std::string get_filter_id(
 		FeFilter *filter
 	);
@@ -242,6 +274,11 @@ public:
 		const std::map<int, FeRomInfo*> &lookup
 	);
 
+	static void invalidate_filter(
+		const FeDisplayInfo &display,
+		const int filter_index
+	);
+
 	// ----------------------------------------------------------------------------------
 
 	static void invalidate_rominfo(
@@ -263,6 +300,41 @@ public:
 		std::vector<std::string> &rominfo
 	);
 
+	// ----------------------------------------------------------------------------------
+
+	static bool save_archive_toc(
+		const std::string &archive,
+		const FeArchiveToc &toc
+	);
+
+	static bool load_archive_toc(
+		const std::string &archive,
+		FeArchiveToc &toc
+	);
+
+	// ----------------------------------------------------------------------------------
+
+	static bool save_script(
+		const FeCacheScript &script
+	);
+
+	static bool load_script(
+		const std::string &path,
+		std::uint32_t consts,
+		FeCacheScript &script
+	);
+
+	// ----------------------------------------------------------------------------------
+
+	static bool save_listxml(
+		const FeListXMLDigest &digest
+	);
+
+	static bool load_listxml(
+		const std::string &executable,
+		FeListXMLDigest &digest
+	);
+
 };
 
 // Cache class used to save versioned map<string,string> data
@@ -22,6 +22,10 @@
 
 #include "fe_settings.hpp"
 #include "fe_util.hpp"
+#include "fe_audio_fx.hpp"
+#include "fe_magic.hpp"
+#include "fe_profiler.hpp"
+#include "fe_frametime.hpp"
 #include <iostream>
 #include <cstring>
 #include <sstream>
@@ -58,6 +62,8 @@ void process_args( int argc, char *argv[],
 	std::string output_name;
 	FeFilter filter( "" );
 	bool full=false;
+	std::string benchmark;
+	std::string benchmark_input;
 
 	int next_arg=1;
 
@@ -285,6 +291,72 @@ void process_args( int argc, char *argv[],
 
 			exit(0);
 		}
+		else if ( strcmp( argv[next_arg], "--benchmark" ) == 0 )
+		{
+			next_arg++;
+			if ( next_arg >= argc )
+			{
+				FeLog() << "Error, no benchmark specified with --benchmark option." << std::endl;
+				exit(1);
+			}
+
+			if (( strcmp( argv[next_arg], "audio" ) != 0 )
+					&& ( strcmp( argv[next_arg], "listbox" ) != 0 )
+					&& ( strcmp( argv[next_arg], "layout" ) != 0 ))
+			{
+				FeLog() << "Unrecognized benchmark: " << argv[next_arg] << std::endl;
+				exit(1);
+			}
+
+			// Run once all arguments are read, the config path may follow
+			benchmark = argv[next_arg];
+			next_arg++;
+		}
+		else if ( strcmp( argv[next_arg], "--benchmark-input" ) == 0 )
+		{
+			next_arg++;
+			if ( next_arg >= argc )
+			{
+				FeLog() << "Error, no input sequence specified with --benchmark-input option." << std::endl;
+				exit(1);
+			}
+
+			benchmark_input = argv[next_arg];
+			next_arg++;
+		}
+		else if ( strcmp( argv[next_arg], "--frame-stats" ) == 0 )
+		{
+			FeFrameTimer::get_ref().set_overlay( true );
+			next_arg++;
+		}
+		else if ( strcmp( argv[next_arg], "--frame-trace" ) == 0 )
+		{
+			next_arg++;
+			if ( next_arg >= argc )
+			{
+				FeLog() << "Error, no output file specified with --frame-trace option." << std::endl;
+				exit(1);
+			}
+
+			if ( !FeFrameTimer::get_ref().set_trace( argv[next_arg] ) )
+				exit(1);
+
+			next_arg++;
+		}
+		else if ( strcmp( argv[next_arg], "--profile" ) == 0 )
+		{
+			next_arg++;
+			if ( next_arg >= argc )
+			{
+				FeLog() << "Error, no output file specified with --profile option." << std::endl;
+				exit(1);
+			}
+
+			FeScriptProfiler &profiler = FeScriptProfiler::get_ref();
+			profiler.set_output( argv[next_arg] );
+			profiler.set_enabled( true );
+			next_arg++;
+		}
 		else if (( strcmp( argv[next_arg], "-t" ) == 0 )
 				|| ( strcmp( argv[next_arg], "--topmost" ) == 0 ))
 		{
@@ -353,11 +425,49 @@ void process_args( int argc, char *argv[],
 			write_option( "-v, --version", "Show version information" );
 			write_option( "-h, --help", "Show this message" );
 
+			write_section( "Diagnostics" );
+			write_option( "--benchmark audio", "Time the audio effects chain (ns per frame)" );
+			write_option( "--benchmark listbox", "Time listbox row formatting for the current display" );
+			write_option( "--benchmark layout", "Replay input on the current layout and report frame times" );
+			write_option( "--benchmark-input <sequence>", "Input for the layout benchmark, ie: \"next_game*100,wait*30\"" );
+			write_option( "--frame-stats", "Show frame timing on screen" );
+			write_option( "--frame-trace <file>", "Write the frame timing of each frame to file (.csv)" );
+			write_option( "--profile <file>", "Profile script callbacks, results are written to file on exit (.json or .csv)" );
+
 			FeLog() << std::endl;
 			exit( retval );
 		}
 	}
 
+	if ( benchmark.compare( "audio" ) == 0 )
+	{
+		FeAudioEffectsManager::benchmark();
+		exit(0);
+	}
+	else if ( benchmark.compare( "listbox" ) == 0 )
+	{
+		FeSettings feSettings( config_path );
+		feSettings.load();
+
+		if ( feSettings.displays_count() < 1 )
+		{
+			FeLog() << "Listbox benchmark needs at least one configured display." << std::endl;
+			exit(1);
+		}
+
+		feSettings.set_display( std::max( 0, feSettings.get_current_display_index() ));
+		FeMagicTemplate::benchmark( feSettings );
+		exit(0);
+	}
+	else if ( benchmark.compare( "layout" ) == 0 )
+	{
+		// Run by the main loop once the layout is loaded
+		if ( !FeFrameTimer::get_ref().set_benchmark( benchmark_input.empty()
+				? "wait*60,next_game*200,prev_game*100,next_page*20,prev_page*20,next_letter*20,wait*60"
+				: benchmark_input ))
+			exit(1);
+	}
+
 	if ( !task_list.empty() )
 	{
 		FeSettings feSettings( config_path );
@@ -1765,7 +1765,9 @@ void FeMiscMenu::get_options( FeConfigContext &ctx )
 	// ---------------------------------------------------------------------------------
 
 	ctx.add_opt( Opt::EDIT, _( "Image Cache Size" ), ctx.fe_settings.get_info( FeSettings::ImageCacheMBytes ), _( "_help_misc_image_cache_mbytes" ) );
+	ctx.add_opt( Opt::EDIT, _( "Romlist Cache Size" ), ctx.fe_settings.get_info( FeSettings::RomlistCacheMBytes ), _( "_help_misc_romlist_cache_mbytes" ) );
 	ctx.add_opt( Opt::TOGGLE, _( "Power Saving" ), ctx.fe_settings.get_info_bool( FeSettings::PowerSaving ), _( "_help_misc_power_saving" ) );
+	ctx.add_opt( Opt::TOGGLE, _( "Release Memory On Launch" ), ctx.fe_settings.get_info_bool( FeSettings::ReleaseMemoryOnLaunch ), _( "_help_misc_release_memory_on_launch" ) );
 	ctx.add_opt( Opt::TOGGLE, _( "Check for Updates" ), ctx.fe_settings.get_info_bool( FeSettings::CheckForUpdates ), _( "_help_misc_check_for_updates" ) );
 
 #ifdef SFML_SYSTEM_WINDOWS
@@ -1802,7 +1804,9 @@ bool FeMiscMenu::save( FeConfigContext &ctx )
 	ctx.fe_settings.set_info( FeSettings::ExitMessage, ctx.opt_list[i++].get_value() );
 	ctx.fe_settings.set_info( FeSettings::VideoDecoder, ctx.opt_list[i++].get_value() );
 	ctx.fe_settings.set_info( FeSettings::ImageCacheMBytes, ctx.opt_list[i++].get_value() );
+	ctx.fe_settings.set_info( FeSettings::RomlistCacheMBytes, ctx.opt_list[i++].get_value() );
 	ctx.fe_settings.set_info( FeSettings::PowerSaving, ctx.opt_list[i++].get_bool() );
+	ctx.fe_settings.set_info( FeSettings::ReleaseMemoryOnLaunch, ctx.opt_list[i++].get_bool() );
 	ctx.fe_settings.set_info( FeSettings::CheckForUpdates, ctx.opt_list[i++].get_bool() );
 #ifdef SFML_SYSTEM_WINDOWS
 	ctx.fe_settings.set_info( FeSettings::HideConsole, ctx.opt_list[i++].get_bool() );
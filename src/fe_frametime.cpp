@@ -0,0 +1,383 @@
+/*
+ *
+ *  Attract-Mode Plus frontend
+ *  Copyright (C) 2025 Andrew Mickelson & Radek Dutkiewicz
+ *
+ *  This file is part of Attract-Mode Plus
+ *
+ *  Attract-Mode Plus is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Attract-Mode Plus is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Attract-Mode Plus.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "fe_frametime.hpp"
+#include "fe_base.hpp" // logging
+#include "fe_util.hpp"
+
+#include <SFML/Graphics/RenderTarget.hpp>
+#include <SFML/Graphics/Font.hpp>
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+namespace
+{
+	const size_t MAX_FRAMES = 4096;
+
+	// Overlay text is only rebuilt this often
+	const int OVERLAY_UPDATE_FRAMES = 30;
+};
+
+const char *FeFrameTimer::phaseStrings[] =
+{
+	"input",
+	"script",
+	"video",
+	"surfaces",
+	"draw",
+	"present",
+	"idle",
+	NULL
+};
+
+const char *FeFrameTimer::wakeStrings[] =
+{
+	"input",
+	"tick",
+	"video",
+	"saver",
+	"timeout",
+	NULL
+};
+
+FeFrameTimer::FeFrameTimer()
+	: m_next( 0 ),
+	m_frames( 0 ),
+	m_in_frame( false ),
+	m_latency_next( 0 ),
+	m_sequence_pos( 0 ),
+	m_enabled( false ),
+	m_overlay( false ),
+	m_benchmark( false )
+{
+	std::fill( m_current, m_current + PhaseCount, 0.f );
+	std::fill( m_wakes, m_wakes + WakeCount, 0 );
+	m_text_bg.setFillColor( sf::Color( 0, 0, 0, 160 ) );
+}
+
+FeFrameTimer &FeFrameTimer::get_ref()
+{
+	static FeFrameTimer timer;
+	return timer;
+}
+
+void FeFrameTimer::update_enabled()
+{
+	m_enabled = m_overlay || m_benchmark || m_trace.is_open();
+}
+
+void FeFrameTimer::set_overlay( bool o )
+{
+	m_overlay = o;
+	update_enabled();
+}
+
+bool FeFrameTimer::set_trace( const std::string &filename )
+{
+	m_trace.open( clean_path( filename ).c_str() );
+	if ( !m_trace.is_open() )
+	{
+		FeLog() << "Error opening frame trace file: " << filename << std::endl;
+		return false;
+	}
+
+	m_trace << "frame";
+	for ( int i=0; i<PhaseCount; i++ )
+		m_trace << "," << phaseStrings[i] << "_ms";
+	m_trace << ",total_ms" << std::endl;
+
+	update_enabled();
+	return true;
+}
+
+bool FeFrameTimer::set_benchmark( const std::string &sequence )
+{
+	m_sequence.clear();
+	m_sequence_pos = 0;
+
+	size_t pos=0;
+	while ( pos < sequence.size() )
+	{
+		std::string entry;
+		token_helper( sequence, pos, entry, "," );
+
+		int count = 1;
+		size_t star = entry.find( '*' );
+		if ( star != std::string::npos )
+		{
+			count = as_int( entry.substr( star + 1 ) );
+			entry.erase( star );
+		}
+
+		FeInputMap::Command c = FeInputMap::LAST_COMMAND;
+		if ( entry.compare( "wait" ) != 0 )
+		{
+			c = FeInputMap::string_to_command( entry );
+			if ( c == FeInputMap::LAST_COMMAND )
+			{
+				FeLog() << "Unrecognized command in benchmark input: " << entry << std::endl;
+				return false;
+			}
+		}
+
+		m_sequence.insert( m_sequence.end(), std::max( count, 0 ), c );
+	}
+
+	m_benchmark = !m_sequence.empty();
+	update_enabled();
+	return m_benchmark;
+}
+
+bool FeFrameTimer::benchmark_next( FeInputMap::Command &c )
+{
+	if ( m_sequence_pos >= m_sequence.size() )
+		return false;
+
+	c = m_sequence[ m_sequence_pos++ ];
+	return true;
+}
+
+void FeFrameTimer::begin_frame()
+{
+	if ( !m_enabled )
+		return;
+
+	if ( m_in_frame )
+	{
+		mark( Idle );
+		end_frame();
+	}
+	else
+		m_last = clock::now();
+
+	m_in_frame = true;
+}
+
+void FeFrameTimer::mark( Phase p )
+{
+	if ( !m_enabled )
+		return;
+
+	clock::time_point now = clock::now();
+	m_current[p] += std::chrono::duration<float, std::milli>( now - m_last ).count();
+	m_last = now;
+}
+
+void FeFrameTimer::end_frame()
+{
+	float total = 0.f;
+	for ( int i=0; i<PhaseCount; i++ )
+		total += m_current[i];
+
+	if ( m_history[0].size() < MAX_FRAMES )
+	{
+		for ( int i=0; i<PhaseCount; i++ )
+			m_history[i].push_back( m_current[i] );
+
+		m_history[PhaseCount].push_back( total );
+	}
+	else
+	{
+		for ( int i=0; i<PhaseCount; i++ )
+			m_history[i][m_next] = m_current[i];
+
+		m_history[PhaseCount][m_next] = total;
+	}
+
+	m_next = ( m_next + 1 ) % MAX_FRAMES;
+	m_frames++;
+
+	if ( m_trace.is_open() )
+	{
+		m_trace << m_frames << std::fixed << std::setprecision( 3 );
+		for ( int i=0; i<PhaseCount; i++ )
+			m_trace << "," << m_current[i];
+		m_trace << "," << total << std::endl;
+	}
+
+	std::fill( m_current, m_current + PhaseCount, 0.f );
+}
+
+void FeFrameTimer::add_wake( Wake w, sf::Time idle )
+{
+	m_wakes[w]++;
+	m_idle += idle;
+}
+
+void FeFrameTimer::add_transition( const char *type, int frames, sf::Time duration, sf::Time longest )
+{
+	TransitionStat &t = m_transitions[ type ];
+	t.count++;
+	t.frames += frames;
+	t.total += duration;
+	t.longest = std::max( t.longest, longest );
+}
+
+void FeFrameTimer::add_latency( float ms )
+{
+	if ( !m_enabled )
+		return;
+
+	if ( m_latency.size() < MAX_FRAMES )
+		m_latency.push_back( ms );
+	else
+		m_latency[m_latency_next] = ms;
+
+	m_latency_next = ( m_latency_next + 1 ) % MAX_FRAMES;
+}
+
+float FeFrameTimer::percentile( int phase, float p ) const
+{
+	return percentile( m_history[phase], p );
+}
+
+float FeFrameTimer::average( int phase ) const
+{
+	return average( m_history[phase] );
+}
+
+float FeFrameTimer::percentile( const std::vector<float> &h, float p )
+{
+	if ( h.empty() )
+		return 0.f;
+
+	std::vector<float> temp( h );
+	size_t n = std::min( temp.size() - 1, (size_t)( p * temp.size() ));
+	std::nth_element( temp.begin(), temp.begin() + n, temp.end() );
+	return temp[n];
+}
+
+float FeFrameTimer::average( const std::vector<float> &h )
+{
+	if ( h.empty() )
+		return 0.f;
+
+	double sum = 0.0;
+	for ( std::vector<float>::const_iterator itr = h.begin(); itr != h.end(); ++itr )
+		sum += *itr;
+
+	return (float)( sum / h.size() );
+}
+
+void FeFrameTimer::draw_overlay( sf::RenderTarget &target, const sf::Font *font )
+{
+	if ( !m_overlay || !font )
+		return;
+
+	if ( !m_text || ( &m_text->getFont() != font ))
+		m_text.reset( new sf::Text( *font, "", 14 ) );
+
+	if (( m_frames % OVERLAY_UPDATE_FRAMES == 0 ) || m_text->getString().isEmpty() )
+	{
+		std::ostringstream ss;
+		ss << std::fixed << std::setprecision( 2 )
+			<< "frame  avg " << average( PhaseCount )
+			<< "  p99 " << percentile( PhaseCount, 0.99f ) << " ms";
+
+		for ( int i=0; i<PhaseCount; i++ )
+		{
+			ss << std::endl << std::left << std::setw( 9 ) << phaseStrings[i]
+				<< "avg " << average( i ) << "  p99 " << percentile( i, 0.99f );
+		}
+
+		if ( !m_latency.empty() )
+		{
+			ss << std::endl << std::left << std::setw( 9 ) << "latency"
+				<< "avg " << average( m_latency ) << "  p99 " << percentile( m_latency, 0.99f );
+		}
+
+		m_text->setString( ss.str() );
+
+		sf::FloatRect bounds = m_text->getLocalBounds();
+		m_text->setPosition( { 8.f, 4.f } );
+		m_text_bg.setSize( { bounds.position.x + bounds.size.x + 16.f,
+			bounds.position.y + bounds.size.y + 12.f } );
+	}
+
+	// Draw in window coordinates, whatever view the layout uses
+	sf::View old_view = target.getView();
+	target.setView( target.getDefaultView() );
+	target.draw( m_text_bg );
+	target.draw( *m_text );
+	target.setView( old_view );
+}
+
+void FeFrameTimer::log_report() const
+{
+	FeLog() << "Frame times over " << m_history[PhaseCount].size() << " frames (ms):" << std::endl
+		<< "  " << std::left << std::setw( 10 ) << "phase"
+		<< std::right << std::setw( 9 ) << "avg"
+		<< std::setw( 9 ) << "p50"
+		<< std::setw( 9 ) << "p95"
+		<< std::setw( 9 ) << "p99"
+		<< std::setw( 9 ) << "max" << std::endl;
+
+	for ( int i=0; i<=PhaseCount; i++ )
+	{
+		FeLog() << "  " << std::left << std::setw( 10 ) << ( i < PhaseCount ? phaseStrings[i] : "total" )
+			<< std::right << std::fixed << std::setprecision( 3 )
+			<< std::setw( 9 ) << average( i )
+			<< std::setw( 9 ) << percentile( i, 0.5f )
+			<< std::setw( 9 ) << percentile( i, 0.95f )
+			<< std::setw( 9 ) << percentile( i, 0.99f )
+			<< std::setw( 9 ) << percentile( i, 1.f ) << std::endl;
+	}
+
+	if ( !m_latency.empty() )
+	{
+		FeLog() << "Input latency over " << m_latency.size() << " inputs (ms):"
+			<< std::fixed << std::setprecision( 3 )
+			<< " avg " << average( m_latency )
+			<< " p50 " << percentile( m_latency, 0.5f )
+			<< " p95 " << percentile( m_latency, 0.95f )
+			<< " p99 " << percentile( m_latency, 0.99f )
+			<< " max " << percentile( m_latency, 1.f ) << std::endl;
+	}
+
+	FeLog() << "Idle waits (" << m_idle.asMilliseconds() << " ms):";
+	for ( int i=0; i<WakeCount; i++ )
+		FeLog() << " " << wakeStrings[i] << " " << m_wakes[i];
+	FeLog() << std::endl;
+
+	if ( m_transitions.empty() )
+		return;
+
+	FeLog() << "Transitions:" << std::endl
+		<< "  " << std::left << std::setw( 18 ) << "type"
+		<< std::right << std::setw( 7 ) << "count"
+		<< std::setw( 9 ) << "frames"
+		<< std::setw( 11 ) << "avg_ms"
+		<< std::setw( 11 ) << "frame_max" << std::endl;
+
+	for ( std::map<std::string, TransitionStat>::const_iterator itr=m_transitions.begin();
+			itr != m_transitions.end(); ++itr )
+	{
+		const TransitionStat &t = (*itr).second;
+		FeLog() << "  " << std::left << std::setw( 18 ) << (*itr).first
+			<< std::right << std::setw( 7 ) << t.count
+			<< std::setw( 9 ) << t.frames
+			<< std::fixed << std::setprecision( 3 )
+			<< std::setw( 11 ) << t.total.asSeconds() * 1000.f / t.count
+			<< std::setw( 11 ) << t.longest.asSeconds() * 1000.f << std::endl;
+	}
+}
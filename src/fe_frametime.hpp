@@ -0,0 +1,175 @@
+/*
+ *
+ *  Attract-Mode Plus frontend
+ *  Copyright (C) 2025 Andrew Mickelson & Radek Dutkiewicz
+ *
+ *  This file is part of Attract-Mode Plus
+ *
+ *  Attract-Mode Plus is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Attract-Mode Plus is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Attract-Mode Plus.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef FE_FRAMETIME_HPP
+#define FE_FRAMETIME_HPP
+
+#include "fe_input.hpp"
+#include "nowide/fstream.hpp"
+
+#include <SFML/Graphics/Text.hpp>
+#include <SFML/Graphics/RectangleShape.hpp>
+#include <SFML/System/Time.hpp>
+#include <string>
+#include <vector>
+#include <map>
+#include <chrono>
+#include <memory>
+
+namespace sf
+{
+	class RenderTarget;
+	class Font;
+};
+
+//
+// Records how long each phase of the main loop takes per frame.  The
+// results can be shown on screen, written to a trace file and reported
+// at the end of a benchmark run.
+//
+// Timing is off unless one of these is enabled, in which case mark() is
+// a single flag check.
+//
+class FeFrameTimer
+{
+public:
+	enum Phase
+	{
+		Input=0,   // event polling and command handling
+		Script,    // script tick callbacks
+		Video,     // video and animation updates
+		Surfaces,  // surface redraws
+		Draw,      // draw submission
+		Present,   // display (includes waiting for vsync)
+		Idle,      // power saving sleep
+		PhaseCount
+	};
+
+	static const char *phaseStrings[];
+
+	// Why the main loop woke up after waiting for something to change
+	enum Wake
+	{
+		WakeInput=0,     // window or input event
+		WakeTick,        // next frame for the layout's tick callbacks
+		WakeVideo,       // next frame for a playing video or loading image
+		WakeScreenSaver, // screen saver is due
+		WakeTimeout,     // maximum wait
+		WakeCount
+	};
+
+	static const char *wakeStrings[];
+
+	static FeFrameTimer &get_ref();
+
+	bool is_enabled() const { return m_enabled; };
+
+	// Show the frame timing overlay
+	void set_overlay( bool o );
+	bool get_overlay() const { return m_overlay; };
+
+	// Write the times of each frame to a CSV file
+	bool set_trace( const std::string &filename );
+
+	//
+	// Replay the given command sequence, one command per frame, and exit
+	// when it is done.  The sequence is a comma separated list of
+	// "command[*count]" entries, "wait" is a frame with no command
+	//
+	bool set_benchmark( const std::string &sequence );
+	bool is_benchmark() const { return m_benchmark; };
+
+	// Return the command to post this frame, false when the benchmark is over
+	bool benchmark_next( FeInputMap::Command &c );
+
+	// Start a new frame, ending the previous one
+	void begin_frame();
+
+	// Add the time since the previous mark to the given phase
+	void mark( Phase p );
+
+	void draw_overlay( sf::RenderTarget &target, const sf::Font *font );
+
+	// Record a wake up after waiting idle for the given time.  Wake ups
+	// are counted even when timing is off
+	void add_wake( Wake w, sf::Time idle );
+
+	// Record a finished transition of the given type and the number of
+	// frames it drew, along with its longest frame
+	void add_transition( const char *type, int frames, sf::Time duration, sf::Time longest );
+
+	// Record the time in ms from receiving an input to displaying the
+	// first frame after it was handled
+	void add_latency( float ms );
+
+	// Log percentiles of the recorded frames
+	void log_report() const;
+
+private:
+	FeFrameTimer();
+	FeFrameTimer( const FeFrameTimer & );
+	FeFrameTimer &operator=( const FeFrameTimer & );
+
+	void end_frame();
+	void update_enabled();
+	float percentile( int phase, float p ) const;
+	float average( int phase ) const;
+	static float percentile( const std::vector<float> &h, float p );
+	static float average( const std::vector<float> &h );
+
+	typedef std::chrono::steady_clock clock;
+
+	clock::time_point m_last;
+	float m_current[PhaseCount];
+	std::vector<float> m_history[PhaseCount+1]; // last entry is the frame total
+	size_t m_next;
+	int m_frames;
+	bool m_in_frame;
+
+	nowide::ofstream m_trace;
+	std::unique_ptr<sf::Text> m_text;
+	sf::RectangleShape m_text_bg;
+
+	std::vector<float> m_latency;
+	size_t m_latency_next;
+
+	int m_wakes[WakeCount];
+	sf::Time m_idle;
+
+	struct TransitionStat
+	{
+		int count=0;
+		int frames=0;
+		sf::Time total;
+		sf::Time longest;
+	};
+	std::map<std::string, TransitionStat> m_transitions;
+
+	std::vector<FeInputMap::Command> m_sequence;
+	size_t m_sequence_pos;
+
+	bool m_enabled;
+	bool m_overlay;
+	bool m_benchmark;
+};
+
+#endif
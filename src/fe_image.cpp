@@ -25,11 +25,13 @@
 #include "fe_settings.hpp"
 #include "fe_shader.hpp"
 #include "fe_present.hpp"
+#include "fe_batch.hpp"
 #include "fe_blend.hpp"
 #include "fe_vm.hpp"
 #include "fe_audio_fx.hpp"
 #include "zip.hpp"
 #include "image_loader.hpp"
+#include "fe_atlas.hpp"
 #include <cmath>
 
 #ifndef NO_MOVIE
@@ -186,6 +188,9 @@ void FeBaseTextureContainer::transition_swap( FeBaseTextureContainer *o )
 
 	for ( itr = o->m_images.begin(); itr != o->m_images.end(); ++itr )
 		(*itr)->texture_changed( o );
+
+	flag_images_redraw();
+	o->flag_images_redraw();
 }
 
 bool FeBaseTextureContainer::fix_masked_image()
@@ -208,16 +213,34 @@ FePresentableParent *FeBaseTextureContainer::get_presentable_parent()
 	return NULL;
 }
 
+sf::IntRect FeBaseTextureContainer::get_texture_rect()
+{
+	return sf::IntRect( { 0, 0 }, sf::Vector2i( get_texture().getSize() ));
+}
+
+void FeBaseTextureContainer::leave_atlas()
+{
+}
+
 void FeBaseTextureContainer::register_image( FeImage *img )
 {
 	m_images.push_back( img );
 }
 
+void FeBaseTextureContainer::flag_images_redraw()
+{
+	for ( std::vector<FeImage *>::iterator itr=m_images.begin();
+			itr != m_images.end(); ++itr )
+		(*itr)->flag_redraw();
+}
+
 void FeBaseTextureContainer::notify_texture_change()
 {
 	for ( std::vector<FeImage *>::iterator itr=m_images.begin();
 			itr != m_images.end(); ++itr )
 		(*itr)->texture_changed();
+
+	flag_images_redraw();
 }
 
 void FeBaseTextureContainer::release_audio( bool )
@@ -228,6 +251,20 @@ void FeBaseTextureContainer::on_redraw_surfaces()
 {
 }
 
+size_t FeBaseTextureContainer::release_memory()
+{
+	return 0;
+}
+
+void FeBaseTextureContainer::restore_memory()
+{
+}
+
+bool FeBaseTextureContainer::is_loading() const
+{
+	return false;
+}
+
 namespace
 {
 	//
@@ -245,6 +282,7 @@ FeTextureContainer::FeTextureContainer(
 	m_filter_offset( 0 ),
 	m_current_rom_index( -1 ),
 	m_current_filter_index( -1 ),
+	m_released_video( false ),
 	m_art_update_trigger( ToNewSelection ),
 	m_movie( NULL ),
 	m_movie_status( -1 ),
@@ -253,7 +291,9 @@ FeTextureContainer::FeTextureContainer(
 	m_smooth( false ),
 	m_volume( 100.0 ),
 	m_fft_bands( 32 ),
-	m_entry( NULL )
+	m_entry( NULL ),
+	m_atlas_slot( -1 ),
+	m_atlas_allowed( true )
 {
 	if ( is_artwork )
 	{
@@ -284,6 +324,8 @@ FeTextureContainer::~FeTextureContainer()
 		FeImageLoader &il = FeImageLoader::get_ref();
 		il.release_entry( &m_entry );
 	}
+
+	FeTextureAtlas::get_ref().release( m_atlas_slot );
 }
 
 bool FeTextureContainer::get_visible() const
@@ -298,6 +340,10 @@ bool FeTextureContainer::fix_masked_image()
 {
 	bool retval=false;
 
+	// The mask is applied to the whole texture
+	m_atlas_allowed = false;
+	leave_atlas();
+
 	sf::Image tmp_img = m_texture.copyToImage();
 	sf::Vector2u tmp_s = tmp_img.getSize();
 
@@ -411,10 +457,27 @@ bool FeTextureContainer::try_to_load(
 		return false;
 	}
 
+	m_file_name = loaded_name;
+
+	// An image already in the atlas needs no loading
+	if ( use_atlas() )
+	{
+		m_atlas_slot = FeTextureAtlas::get_ref().acquire( loaded_name, m_smooth );
+		if ( m_atlas_slot >= 0 )
+		{
+			m_texture = sf::Texture();
+			return true;
+		}
+	}
+
 	if ( il.load_image_from_file( loaded_name, &m_entry ) )
 		data = m_entry->get_data();
 
-	m_file_name = loaded_name;
+	if ( data && add_to_atlas() )
+	{
+		il.release_entry( &m_entry );
+		return true;
+	}
 
 	// resize our texture accordingly
 	if ( m_texture.getSize() != sf::Vector2u( m_entry->get_width(), m_entry->get_height() ))
@@ -433,9 +496,68 @@ bool FeTextureContainer::try_to_load(
 
 const sf::Texture &FeTextureContainer::get_texture()
 {
+	if ( m_atlas_slot >= 0 )
+		return FeTextureAtlas::get_ref().get_texture( m_atlas_slot );
+
 	return m_texture;
 }
 
+sf::IntRect FeTextureContainer::get_texture_rect()
+{
+	if ( m_atlas_slot >= 0 )
+		return FeTextureAtlas::get_ref().get_rect( m_atlas_slot );
+
+	return FeBaseTextureContainer::get_texture_rect();
+}
+
+bool FeTextureContainer::use_atlas() const
+{
+	return ( m_atlas_allowed && !m_mipmap && !m_texture.isRepeated()
+		&& ( FeTextureAtlas::get_ref().get_max_image_size() > 0 ));
+}
+
+//
+// Place the loaded m_entry in the atlas if it is suitable.  Returns true
+// if it was added
+//
+bool FeTextureContainer::add_to_atlas()
+{
+	FeTextureAtlas &atlas = FeTextureAtlas::get_ref();
+	if ( !use_atlas() || !atlas.accepts( m_entry->get_width(), m_entry->get_height() ))
+		return false;
+
+	m_atlas_slot = atlas.add( m_file_name, m_smooth,
+		m_entry->get_width(), m_entry->get_height(), m_entry->get_data() );
+
+	if ( m_atlas_slot < 0 )
+		return false;
+
+	m_texture = sf::Texture();
+	return true;
+}
+
+//
+// Load the current image again, so that changed settings decide
+// whether it goes in the atlas
+//
+void FeTextureContainer::reload_image()
+{
+	std::string file_name = m_file_name;
+	clear();
+
+	try_to_load( file_name, true );
+	notify_texture_change();
+}
+
+void FeTextureContainer::leave_atlas()
+{
+	// Also keeps images that haven't loaded yet out of the atlas
+	m_atlas_allowed = false;
+
+	if ( m_atlas_slot >= 0 )
+		reload_image();
+}
+
 void FeTextureContainer::on_new_selection( FeSettings *feSettings )
 {
 	if (( m_type != IsStatic ) && ( m_art_update_trigger == ToNewSelection ))
@@ -567,6 +689,13 @@ bool FeTextureContainer::tick( FeSettings *feSettings, bool play_movies )
 		FeImageLoader &il = FeImageLoader::get_ref();
 		if ( il.check_loaded( m_entry ) )
 		{
+			if ( add_to_atlas() )
+			{
+				il.release_entry( &m_entry );
+				notify_texture_change();
+				return true;
+			}
+
 			m_texture.update( m_entry->get_data() );
 			if ( m_mipmap ) std::ignore = m_texture.generateMipmap();
 			m_texture.setSmooth( m_smooth );
@@ -842,12 +971,19 @@ void FeTextureContainer::clear()
 		FeImageLoader &il = FeImageLoader::get_ref();
 		il.release_entry( &m_entry );
 	}
+
+	FeTextureAtlas::get_ref().release( m_atlas_slot );
+	m_atlas_slot = -1;
 }
 
 void FeTextureContainer::set_smooth( bool s )
 {
 	m_smooth = s;
 	m_texture.setSmooth( s );
+
+	// Atlas pages are either smooth or not
+	if (( m_atlas_slot >= 0 ) && ( s != FeTextureAtlas::get_ref().get_texture( m_atlas_slot ).isSmooth() ))
+		reload_image();
 }
 
 bool FeTextureContainer::get_smooth() const
@@ -858,6 +994,9 @@ bool FeTextureContainer::get_smooth() const
 void FeTextureContainer::set_mipmap( bool m )
 {
 	m_mipmap = m;
+	if ( m_mipmap && ( m_atlas_slot >= 0 ))
+		reload_image();
+
 	if ( m_mipmap && !m_movie ) std::ignore = m_texture.generateMipmap();
 }
 
@@ -869,6 +1008,8 @@ bool FeTextureContainer::get_mipmap() const
 void FeTextureContainer::set_repeat( bool r )
 {
 	m_texture.setRepeated( r );
+	if ( r && ( m_atlas_slot >= 0 ))
+		reload_image();
 }
 
 bool FeTextureContainer::get_repeat() const
@@ -929,10 +1070,50 @@ void FeTextureContainer::release_audio( bool state )
 {
 }
 
+size_t FeTextureContainer::release_memory()
+{
+	if ( m_file_name.empty() )
+		return 0;
+
+	// Images in the atlas are counted when its pages are released
+	size_t bytes = 0;
+	if ( m_atlas_slot < 0 )
+		bytes = (size_t)m_texture.getSize().x * m_texture.getSize().y * 4;
+
+	m_released_file = m_file_name;
+	m_released_video = ( m_movie != NULL );
+
+	clear();
+	m_texture = sf::Texture();
+	return bytes;
+}
+
+void FeTextureContainer::restore_memory()
+{
+	if ( m_released_file.empty() )
+		return;
+
+	std::string file_name;
+	file_name.swap( m_released_file );
+
+	try_to_load( file_name, !m_released_video );
+	notify_texture_change();
+}
+
+bool FeTextureContainer::is_loading() const
+{
+	return ( m_entry != NULL );
+}
+
+unsigned int FeSurfaceTextureContainer::m_rendered_count = 0;
+unsigned int FeSurfaceTextureContainer::m_skipped_count = 0;
+
 FeSurfaceTextureContainer::FeSurfaceTextureContainer( int width, int height )
-	: m_clear( true ),
+	: m_shader_version( 0 ),
+	m_clear( true ),
 	m_redraw( true ),
-	m_mipmap( false )
+	m_mipmap( false ),
+	m_dirty( true )
 {
 	sf::ContextSettings ctx;
 	FePresent *fep = FePresent::script_get_fep();
@@ -962,6 +1143,7 @@ const sf::Texture &FeSurfaceTextureContainer::get_texture()
 
 void FeSurfaceTextureContainer::on_new_selection( FeSettings *s )
 {
+	m_dirty = true;
 	for ( std::vector<FeBasePresentable *>::iterator itr = elements.begin();
 				itr != elements.end(); ++itr )
 		(*itr)->on_new_selection( s );
@@ -977,31 +1159,82 @@ void FeSurfaceTextureContainer::on_new_list( FeSettings *s, bool )
 	// We don't do any scaling of the objects when they are being drawn
 	// to the surface.
 	//
+	m_dirty = true;
 	for ( std::vector<FeBasePresentable *>::iterator itr = elements.begin();
 				itr != elements.end(); ++itr )
 		(*itr)->on_new_list( s );
 }
 
+unsigned int FeSurfaceTextureContainer::get_shader_version( bool &always_dirty ) const
+{
+	unsigned int version = 0;
+	always_dirty = false;
+
+	for ( std::vector<FeBasePresentable *>::const_iterator itr = elements.begin();
+				itr != elements.end(); ++itr )
+	{
+		FeShader *sh = (*itr)->get_shader();
+		if ( sh && (*itr)->get_visible() )
+		{
+			version += sh->get_version();
+			if ( sh->has_image_texture() )
+				always_dirty = true;
+		}
+	}
+
+	return version;
+}
+
 void FeSurfaceTextureContainer::on_redraw_surfaces()
 {
+	//
+	// Skip the redraw if none of our elements have changed since the last
+	// one.  Surfaces that aren't cleared accumulate what is drawn to them
+	// so they are always redrawn
+	//
+	bool always_dirty;
+	unsigned int shader_version = get_shader_version( always_dirty );
+
+	if ( m_redraw && m_clear && !m_dirty && !always_dirty
+			&& ( shader_version == m_shader_version ))
+	{
+		m_skipped_count++;
+		return;
+	}
+
+	m_dirty = false;
+	m_shader_version = shader_version;
+
 	//
 	// Draw the surface's draw list to the render texture
 	//
 	if ( m_clear ) m_texture.clear( sf::Color::Transparent );
 	if ( m_redraw )
 	{
+		FeDrawBatch batch( m_texture );
 		for ( std::vector<FeBasePresentable *>::const_iterator itr = elements.begin();
 					itr != elements.end(); ++itr )
 		{
 			if ( (*itr)->get_visible() )
-				m_texture.draw( (*itr)->drawable() );
+				(*itr)->batch( batch, sf::RenderStates::Default );
 		}
 
+		batch.flush();
 		m_texture.display();
 		if ( m_mipmap ) std::ignore = m_texture.generateMipmap();
+
+		m_rendered_count++;
+
+		// Images showing this surface (possibly on another surface) need redrawing
+		flag_images_redraw();
 	}
 }
 
+void FeSurfaceTextureContainer::flag_dirty()
+{
+	m_dirty = true;
+}
+
 void FeSurfaceTextureContainer::set_smooth( bool s )
 {
 	m_texture.setSmooth( s );
@@ -1015,6 +1248,7 @@ bool FeSurfaceTextureContainer::get_smooth() const
 void FeSurfaceTextureContainer::set_mipmap( bool m )
 {
 	m_mipmap = m;
+	m_dirty = true;
 }
 
 bool FeSurfaceTextureContainer::get_mipmap() const
@@ -1025,6 +1259,7 @@ bool FeSurfaceTextureContainer::get_mipmap() const
 void FeSurfaceTextureContainer::set_clear( bool c )
 {
 	m_clear = c;
+	m_dirty = true;
 }
 
 bool FeSurfaceTextureContainer::get_clear() const
@@ -1045,6 +1280,7 @@ bool FeSurfaceTextureContainer::get_repeat() const
 void FeSurfaceTextureContainer::set_redraw( bool r )
 {
 	m_redraw = r;
+	m_dirty = true;
 }
 
 bool FeSurfaceTextureContainer::get_redraw() const
@@ -1110,6 +1346,20 @@ const sf::Texture *FeImage::get_texture()
 		return NULL;
 }
 
+void FeImage::leave_atlas()
+{
+	if ( m_tex )
+		m_tex->leave_atlas();
+}
+
+void FeImage::script_set_shader( FeShader *s )
+{
+	if ( s && ( s->get_type() != FeShader::Empty ))
+		leave_atlas();
+
+	FeBasePresentable::script_set_shader( s );
+}
+
 bool FeImage::get_visible() const
 {
 	if ( !FeBasePresentable::get_visible() || !m_tex )
@@ -1127,8 +1377,9 @@ void FeImage::texture_changed( FeBaseTextureContainer *new_tex )
 	m_sprite.setTexture( m_tex->get_texture() );
 
 	//  reset texture rect now to the one reported by the new texture object
-	m_sprite.setTextureRect(
-		sf::FloatRect({ 0, 0 }, { static_cast<float>( m_tex->get_texture().getSize().x ), static_cast<float>( m_tex->get_texture().getSize().y )}));
+	sf::IntRect r = m_tex->get_texture_rect();
+	m_sprite.setTextureOffset( sf::Vector2f( r.position ));
+	m_sprite.setTextureRect( sf::FloatRect( { 0, 0 }, sf::Vector2f( r.size )));
 
 	scale();
 }
@@ -1177,6 +1428,7 @@ int FeImage::getIndexOffset() const
 void FeImage::setIndexOffset( int io )
 {
 	m_tex->set_index_offset( io );
+	m_tex->flag_images_redraw();
 }
 
 int FeImage::getFilterOffset() const
@@ -1187,6 +1439,7 @@ int FeImage::getFilterOffset() const
 void FeImage::setFilterOffset( int fo )
 {
 	m_tex->set_filter_offset( fo );
+	m_tex->flag_images_redraw();
 }
 
 void FeImage::rawset_index_offset( int io )
@@ -1221,6 +1474,27 @@ void FeImage::draw(sf::RenderTarget& target, sf::RenderStates states) const
 	target.draw( m_sprite, states );
 }
 
+void FeImage::batch( FeDrawBatch &b, const sf::RenderStates &rs ) const
+{
+	//
+	// Layout shaders can depend on the untransformed vertex positions,
+	// so those images are drawn on their own
+	//
+	FeShader *s = get_shader();
+	if ( s && s->get_shader() )
+	{
+		b.draw( drawable(), rs );
+		return;
+	}
+
+	sf::RenderStates states( rs );
+	if ( !s )
+		states.shader = FeBlend::get_default_shader( m_blend_mode );
+
+	states.blendMode = FeBlend::get_blend_mode( m_blend_mode );
+	m_sprite.batch( b, states );
+}
+
 void FeImage::scale()
 {
 	sf::FloatRect texture_rect = m_sprite.getTextureRect();
@@ -1360,7 +1634,7 @@ void FeImage::set_auto_width( bool w )
 	{
 		m_auto_size.x = w;
 		scale();
-		FePresent::script_flag_redraw();
+		flag_redraw();
 	}
 }
 
@@ -1370,7 +1644,7 @@ void FeImage::set_auto_height( bool h )
 	{
 		m_auto_size.y = h;
 		scale();
-		FePresent::script_flag_redraw();
+		flag_redraw();
 	}
 }
 
@@ -1399,7 +1673,7 @@ void FeImage::setSize( const sf::Vector2f &s )
 	{
 		m_size = s;
 		scale();
-		FePresent::script_flag_redraw();
+		flag_redraw();
 	}
 }
 
@@ -1409,7 +1683,7 @@ void FeImage::setPosition( const sf::Vector2f &p )
 	{
 		m_pos = p;
 		scale();
-		FePresent::script_flag_redraw();
+		flag_redraw();
 	}
 }
 
@@ -1424,7 +1698,7 @@ void FeImage::setRotation( float r )
 	{
 		m_rotation = r;
 		scale();
-		FePresent::script_flag_redraw();
+		flag_redraw();
 	}
 }
 
@@ -1438,13 +1712,13 @@ void FeImage::setColor( sf::Color c )
 	if ( c != m_sprite.getColor() )
 	{
 		m_sprite.setColor( c );
-		FePresent::script_flag_redraw();
+		flag_redraw();
 	}
 }
 
 sf::Vector2u FeImage::getTextureSize() const
 {
-	return m_tex->get_texture().getSize();
+	return sf::Vector2u( m_tex->get_texture_rect().size );
 }
 
 sf::FloatRect FeImage::getTextureRect() const
@@ -1458,7 +1732,7 @@ void FeImage::setTextureRect( const sf::FloatRect &r )
 	{
 		m_sprite.setTextureRect( r );
 		scale();
-		FePresent::script_flag_redraw();
+		flag_redraw();
 	}
 }
 
@@ -1470,6 +1744,7 @@ int FeImage::getVideoFlags() const
 void FeImage::setVideoFlags( int f )
 {
 	m_tex->set_video_flags( (FeVideoFlags)f );
+	m_tex->flag_images_redraw();
 }
 
 bool FeImage::getVideoPlaying() const
@@ -1480,6 +1755,7 @@ bool FeImage::getVideoPlaying() const
 void FeImage::setVideoPlaying( bool f )
 {
 	m_tex->set_play_state( f );
+	m_tex->flag_images_redraw();
 }
 
 int FeImage::getVideoDuration() const
@@ -1502,6 +1778,7 @@ void FeImage::setFileName( const char *n )
 	std::string filename = n;
 
 	m_tex->load_file( filename.c_str() );
+	m_tex->flag_images_redraw();
 }
 
 int FeImage::getTrigger() const
@@ -1512,6 +1789,7 @@ int FeImage::getTrigger() const
 void FeImage::setTrigger( int t )
 {
 	m_tex->set_trigger( t );
+	m_tex->flag_images_redraw();
 }
 
 bool FeImage::getMovieEnabled() const
@@ -1529,6 +1807,7 @@ void FeImage::setMovieEnabled( bool f )
 		c &= ~VF_DisableVideo;
 
 	m_tex->set_video_flags( (FeVideoFlags)c );
+	m_tex->flag_images_redraw();
 }
 
 float FeImage::get_origin_x() const
@@ -1597,7 +1876,7 @@ void FeImage::set_origin_x( float x )
 	{
 		m_origin.x = x;
 		scale();
-		FePresent::script_flag_redraw();
+		flag_redraw();
 	}
 }
 
@@ -1607,7 +1886,7 @@ void FeImage::set_origin_y( float y )
 	{
 		m_origin.y = y;
 		scale();
-		FePresent::script_flag_redraw();
+		flag_redraw();
 	}
 }
 
@@ -1617,7 +1896,7 @@ void FeImage::set_anchor( float x, float y )
 	{
 		m_anchor = sf::Vector2f( x, y );
 		scale();
-		FePresent::script_flag_redraw();
+		flag_redraw();
 	}
 }
 
@@ -1634,7 +1913,7 @@ void FeImage::set_rotation_origin( float x, float y )
 	{
 		m_rotation_origin = sf::Vector2f( x, y );
 		scale();
-		FePresent::script_flag_redraw();
+		flag_redraw();
 	}
 }
 
@@ -1651,7 +1930,7 @@ void FeImage::set_anchor_x( float x )
 	{
 		m_anchor.x = x;
 		scale();
-		FePresent::script_flag_redraw();
+		flag_redraw();
 	}
 }
 
@@ -1661,7 +1940,7 @@ void FeImage::set_anchor_y( float y )
 	{
 		m_anchor.y = y;
 		scale();
-		FePresent::script_flag_redraw();
+		flag_redraw();
 	}
 }
 
@@ -1671,7 +1950,7 @@ void FeImage::set_rotation_origin_x( float x )
 	{
 		m_rotation_origin.x = x;
 		scale();
-		FePresent::script_flag_redraw();
+		flag_redraw();
 	}
 }
 
@@ -1681,7 +1960,7 @@ void FeImage::set_rotation_origin_y( float y )
 	{
 		m_rotation_origin.y = y;
 		scale();
-		FePresent::script_flag_redraw();
+		flag_redraw();
 	}
 }
 
@@ -1690,7 +1969,7 @@ void FeImage::set_skew_x( float x )
 	if ( x != m_sprite.getSkewX() )
 	{
 		m_sprite.setSkewX( x );
-		FePresent::script_flag_redraw();
+		flag_redraw();
 	}
 }
 
@@ -1699,7 +1978,7 @@ void FeImage::set_skew_y( float y )
 	if ( y != m_sprite.getSkewY() )
 	{
 		m_sprite.setSkewY( y );
-		FePresent::script_flag_redraw();
+		flag_redraw();
 	}
 }
 
@@ -1708,7 +1987,7 @@ void FeImage::set_pinch_x( float x )
 	if ( x != m_sprite.getPinchX() )
 	{
 		m_sprite.setPinchX( x );
-		FePresent::script_flag_redraw();
+		flag_redraw();
 	}
 }
 
@@ -1717,7 +1996,7 @@ void FeImage::set_pinch_y( float y )
 	if ( y != m_sprite.getPinchY() )
 	{
 		m_sprite.setPinchY( y );
-		FePresent::script_flag_redraw();
+		flag_redraw();
 	}
 }
 
@@ -1795,13 +2074,14 @@ void FeImage::set_preserve_aspect_ratio( bool p )
 	{
 		m_preserve_aspect_ratio = p;
 		scale();
-		FePresent::script_flag_redraw();
+		flag_redraw();
 	}
 }
 
 void FeImage::set_mipmap( bool m )
 {
 	m_tex->set_mipmap( m );
+	m_tex->flag_images_redraw();
 }
 
 bool FeImage::get_mipmap() const
@@ -1812,6 +2092,7 @@ bool FeImage::get_mipmap() const
 void FeImage::set_clear( bool c )
 {
 	m_tex->set_clear( c );
+	m_tex->flag_images_redraw();
 }
 
 bool FeImage::get_clear() const
@@ -1822,6 +2103,7 @@ bool FeImage::get_clear() const
 void FeImage::set_repeat( bool r )
 {
 	m_tex->set_repeat( r );
+	m_tex->flag_images_redraw();
 }
 
 bool FeImage::get_repeat() const
@@ -1832,6 +2114,7 @@ bool FeImage::get_repeat() const
 void FeImage::set_redraw( bool r )
 {
 	m_tex->set_redraw( r );
+	m_tex->flag_images_redraw();
 }
 
 bool FeImage::get_redraw() const
@@ -1951,6 +2234,7 @@ void FeImage::transition_swap( FeImage *o )
 void FeImage::set_smooth( bool s )
 {
 	m_tex->set_smooth( s );
+	m_tex->flag_images_redraw();
 }
 
 bool FeImage::get_smooth() const
@@ -1966,6 +2250,7 @@ int FeImage::get_blend_mode() const
 void FeImage::set_blend_mode( int b )
 {
 	m_blend_mode = (FeBlend::Mode)b;
+	flag_redraw();
 }
 
 FeImage *FeImage::add_image(const char *n, float x, float y, float w, float h)
@@ -2067,7 +2352,7 @@ void FeImage::set_border( int l, int t, int r, int b )
 	if ( border != m_sprite.getBorder() )
 	{
 		m_sprite.setBorder( border );
-		FePresent::script_flag_redraw();
+		flag_redraw();
 	}
 }
 
@@ -2077,7 +2362,7 @@ void FeImage::set_padding( int l, int t, int r, int b )
 	if ( padding != m_sprite.getPadding() )
 	{
 		m_sprite.setPadding( padding );
-		FePresent::script_flag_redraw();
+		flag_redraw();
 	}
 }
 
@@ -2086,7 +2371,7 @@ void FeImage::set_border_scale( float s )
 	if ( s != m_sprite.getBorderScale() )
 	{
 		m_sprite.setBorderScale( s );
-		FePresent::script_flag_redraw();
+		flag_redraw();
 	}
 }
 
@@ -2100,6 +2385,8 @@ void FeImage::set_fft_bands( int count )
 	FeTextureContainer *tc = dynamic_cast<FeTextureContainer*>( m_tex );
 	if ( tc )
 		tc->set_fft_bands( count );
+
+	m_tex->flag_images_redraw();
 }
 
 int FeImage::get_fft_bands() const
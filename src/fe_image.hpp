@@ -54,6 +54,12 @@ public:
 
 	virtual const sf::Texture &get_texture()=0;
 
+	// The area of get_texture() holding this container's image
+	virtual sf::IntRect get_texture_rect();
+
+	// Move the image out of the texture atlas into its own texture
+	virtual void leave_atlas();
+
 	virtual void on_new_selection( FeSettings *feSettings )=0;
 	virtual void on_end_navigation( FeSettings *feSettings )=0;
 
@@ -110,9 +116,23 @@ public:
 
 	void register_image( FeImage * );
 
+	// flag the images showing this texture for redraw
+	void flag_images_redraw();
+
 	virtual void release_audio( bool );
 	virtual void on_redraw_surfaces();
 
+	//
+	// Free the loaded image or video while a game is running.  Returns the
+	// approximate number of bytes released.  restore_memory() loads the same
+	// file again
+	//
+	virtual size_t release_memory();
+	virtual void restore_memory();
+
+	// Return true while an image is still being loaded in the background
+	virtual bool is_loading() const;
+
 protected:
 	FeBaseTextureContainer();
 	FeBaseTextureContainer( const FeBaseTextureContainer & );
@@ -140,6 +160,8 @@ public:
 	~FeTextureContainer();
 
 	const sf::Texture &get_texture();
+	sf::IntRect get_texture_rect();
+	void leave_atlas();
 	bool get_visible() const;
 
 	void on_new_selection( FeSettings *feSettings );
@@ -175,6 +197,10 @@ public:
 
 	void release_audio( bool );
 
+	size_t release_memory();
+	void restore_memory();
+	bool is_loading() const;
+
 	void set_mipmap( bool );
 	bool get_mipmap() const;
 
@@ -209,6 +235,10 @@ private:
 	void internal_update_selection( FeSettings *feSettings );
 	void clear();
 
+	bool use_atlas() const;
+	bool add_to_atlas();
+	void reload_image();
+
 	sf::Texture m_texture;
 
 	std::string m_art_name; // artwork label/template name (dynamic images)
@@ -217,6 +247,8 @@ private:
 	int m_filter_offset;
 	int m_current_rom_index;
 	int m_current_filter_index;
+	std::string m_released_file; // the file to load again after release_memory()
+	bool m_released_video;
 
 	enum Type { IsArtwork, IsDynamic, IsStatic };
 	Type m_type;
@@ -229,6 +261,8 @@ private:
 	float m_volume;
 	int m_fft_bands;
 	FeImageLoaderEntry *m_entry;
+	int m_atlas_slot; // -1 if the image has its own texture
+	bool m_atlas_allowed;
 };
 
 class FeSurfaceTextureContainer : public FeBaseTextureContainer, public FePresentableParent
@@ -263,11 +297,24 @@ public:
 
 	FePresentableParent *get_presentable_parent();
 
+	void flag_dirty();
+
+	// number of surface redraws performed and skipped since startup
+	static unsigned int get_rendered_count() { return m_rendered_count; };
+	static unsigned int get_skipped_count() { return m_skipped_count; };
+
 private:
+	unsigned int get_shader_version( bool &always_dirty ) const;
+
 	sf::RenderTexture m_texture;
+	unsigned int m_shader_version;
 	bool m_clear;
 	bool m_redraw;
 	bool m_mipmap;
+	bool m_dirty;
+
+	static unsigned int m_rendered_count;
+	static unsigned int m_skipped_count;
 };
 
 class FeImage : public sf::Drawable, public FeBasePresentable
@@ -294,6 +341,12 @@ public:
 
 	const sf::Texture *get_texture();
 
+	// Give the image its own texture if it shares an atlas page, for
+	// shaders that depend on its texture coordinates
+	void leave_atlas();
+
+	void script_set_shader( FeShader *s );
+
 	sf::Vector2f getSize() const;
 	void setSize( const sf::Vector2f &s );
 	void setSize( int w, int h ) { setSize( sf::Vector2f( w, h ) ); };
@@ -329,6 +382,7 @@ public:
 	// Overrides from base class:
 	//
 	const sf::Drawable &drawable() const { return (const sf::Drawable &)*this; };
+	void batch( FeDrawBatch &b, const sf::RenderStates &states ) const;
 
 	bool get_visible() const;
 
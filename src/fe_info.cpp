@@ -312,17 +312,17 @@ void FeRomInfo::update_stats( const std::string &path, int count_incr, int playe
 
 int FeRomInfo::process_setting( const std::string &,
          const std::string &value, const std::string &fn )
+{
+	load_fields( value.data(), value.size() );
+	return 0;
+}
+
+void FeRomInfo::load_fields( const char *value, size_t len )
 {
 	size_t pos=0;
-	std::string token;
 
 	for ( int i=1; i < LAST_INFO; i++ )
-	{
-		token_helper( value, pos, token );
-		m_info[(Index)i] = token;
-	}
-
-	return 0;
+		token_helper( value, len, pos, m_info[(Index)i] );
 }
 
 std::string FeRomInfo::as_output( void ) const
@@ -490,6 +490,92 @@ bool FeRule::apply_rule( const FeRomInfo &rom ) const
 	}
 }
 
+std::string FeRule::get_required_text() const
+{
+	if (( m_filter_target == FeRomInfo::LAST_INDEX )
+		|| (( m_filter_comp != FilterEquals ) && ( m_filter_comp != FilterContains )))
+		return "";
+
+	if ( !m_use_rex )
+		return m_filter_what;
+
+	// Alternatives leave nothing that is always required
+	if ( !m_rex || ( m_filter_what.find( '|' ) != std::string::npos ))
+		return "";
+
+	//
+	// Find the longest run of literal characters outside of any group
+	//
+	const std::string &w = m_filter_what;
+	std::string best, run;
+	int depth = 0;
+
+	for ( size_t i=0; i<=w.size(); i++ )
+	{
+		char c = ( i < w.size() ) ? w[i] : 0;
+		switch ( c )
+		{
+		case '*':
+		case '?':
+		case '{':
+			// The preceding character is optional
+			if ( !run.empty() )
+				run.erase( run.size() - 1 );
+
+			if ( c == '{' )
+			{
+				i = w.find( '}', i );
+				if ( i == std::string::npos )
+					return "";
+			}
+			break;
+
+		case '\\':
+			i++;
+			break;
+
+		case '[':
+			// Skip the character class
+			for ( i++; ( i < w.size() ) && ( w[i] != ']' ); i++ )
+			{
+				if ( w[i] == '\\' )
+					i++;
+			}
+			break;
+
+		case '(':
+			depth++;
+			break;
+
+		case ')':
+			depth--;
+			break;
+
+		case '+':
+		case '.':
+		case '^':
+		case '$':
+		case 0:
+			break;
+
+		default:
+			if ( depth == 0 )
+			{
+				run += c;
+				continue;
+			}
+			break;
+		}
+
+		if ( run.size() > best.size() )
+			best = run;
+
+		run.clear();
+	}
+
+	return best;
+}
+
 void FeRule::save( nowide::ofstream &f ) const
 {
 	if (( m_filter_target == FeRomInfo::LAST_INDEX ) || ( m_filter_comp == LAST_COMPARISON ))
@@ -127,6 +127,11 @@ public:
 	int process_setting( const std::string &setting,
 		const std::string &value,
 		const std::string &fn );
+
+	// Set the info fields following the romname from a romlist line's
+	// value, which is the "len" characters at "value"
+	void load_fields( const char *value, size_t len );
+
 	std::string as_output( void ) const;
 
 	void load_stats( const std::string &path );
@@ -196,6 +201,10 @@ public:
 	bool apply_rule( const FeRomInfo &rom ) const;
 	void save( nowide::ofstream & ) const;
 
+	// Return text that the target must contain for the rule to match,
+	// or an empty string if there is none.  Call after init()
+	std::string get_required_text() const;
+
 	FeRomInfo::Index get_target() const { return m_filter_target; };
 	FilterComp get_comp() const { return m_filter_comp; };
 	const std::string &get_what() const { return m_filter_what; };
@@ -24,6 +24,7 @@
 #include "fe_settings.hpp"
 #include "fe_shader.hpp"
 #include "fe_present.hpp"
+#include "fe_batch.hpp"
 #include "fe_util.hpp"
 #include <iostream>
 #include <algorithm>
@@ -95,6 +96,7 @@ FeListBox::FeListBox( FePresentableParent &p )
 void FeListBox::setFont( const sf::Font &f )
 {
 	m_base_text.setFont( f );
+	flag_redraw();
 }
 
 sf::Vector2f FeListBox::getPosition() const
@@ -161,7 +163,7 @@ void FeListBox::setOutlineColor( sf::Color c )
 		return;
 
 	m_base_text.setOutlineColor( c );
-	FePresent::script_flag_redraw();
+	flag_redraw();
 }
 
 void FeListBox::set_sel_outline( float t )
@@ -203,7 +205,7 @@ void FeListBox::setSelOutlineColor( sf::Color c )
 	if ( getSelectedText( sel ) ) sel->setOutlineColor( m_selOutlineColour );
 
 	if ( m_scripted )
-		FePresent::script_flag_redraw();
+		flag_redraw();
 }
 
 void FeListBox::init_dimensions()
@@ -280,7 +282,7 @@ void FeListBox::setColor( sf::Color c )
 			m_texts[i].setColor( c );
 
 	if ( m_scripted )
-		FePresent::script_flag_redraw();
+		flag_redraw();
 }
 
 void FeListBox::setSelColor( sf::Color c )
@@ -293,7 +295,7 @@ void FeListBox::setSelColor( sf::Color c )
 	if ( getSelectedText( sel ) ) sel->setColor( m_selColour );
 
 	if ( m_scripted )
-		FePresent::script_flag_redraw();
+		flag_redraw();
 }
 
 void FeListBox::setSelBgColor( sf::Color c )
@@ -306,7 +308,7 @@ void FeListBox::setSelBgColor( sf::Color c )
 	if ( getSelectedText( sel ) ) sel->setBgColor( m_selBg );
 
 	if ( m_scripted )
-		FePresent::script_flag_redraw();
+		flag_redraw();
 }
 
 void FeListBox::setSelStyle( int s )
@@ -319,7 +321,7 @@ void FeListBox::setSelStyle( int s )
 	if ( getSelectedText( sel ) ) sel->setStyle( m_selStyle );
 
 	if ( m_scripted )
-		FePresent::script_flag_redraw();
+		flag_redraw();
 }
 
 int FeListBox::getSelStyle()
@@ -349,6 +351,7 @@ void FeListBox::setCustomSelection( const int index )
 {
 	m_custom_sel = index;
 	internalSetText( index );
+	flag_redraw();
 }
 
 //
@@ -458,31 +461,28 @@ void FeListBox::internalSetText( const int index )
 	}
 
 	std::string text_string;
-	std::string format_string = m_format_string.empty()
+	m_format_template.set_format( m_format_string.empty()
 		? DEFAULT_FORMAT_STRING
-		: m_format_string;
+		: m_format_string );
 
 	for ( int i=0; i < display_rows; i++ )
 	{
 		int listentry = i + offset;
 		if ( listentry < 0 || listentry >= list_size )
-			text_string = "";
+			text_string.clear();
 		else if ( m_has_custom_list )
 			text_string = m_custom_list[ listentry ];
 		else
 		{
 			// Substitute magic string on-demand
-			text_string = format_string;
-			FePresent::script_process_magic_strings(
+			m_format_template.expand(
 				text_string,
+				m_feSettings,
+				m_display_filter_index,
+				listentry,
 				m_filter_offset,
 				i - m_selected_row
 			);
-			m_feSettings->do_text_substitutions_absolute(
-				text_string,
-				m_display_filter_index,
-				listentry
-			);
 		}
 
 		m_texts[i].setString( text_string );
@@ -502,7 +502,7 @@ void FeListBox::setRotation( float r )
 		m_texts[i].setRotation( m_rotation );
 
 	if ( m_scripted )
-		FePresent::script_flag_redraw();
+		flag_redraw();
 }
 
 void FeListBox::on_new_list( FeSettings *s )
@@ -565,6 +565,20 @@ void FeListBox::draw( sf::RenderTarget &target, sf::RenderStates states ) const
 		target.draw( (*itl), states );
 }
 
+void FeListBox::batch( FeDrawBatch &b, const sf::RenderStates &rs ) const
+{
+	const FeShader *s = get_shader();
+	if ( s && s->get_shader() )
+	{
+		b.draw( drawable(), rs );
+		return;
+	}
+
+	for ( std::vector<FeTextPrimitive>::const_iterator itl=m_texts.begin();
+				itl != m_texts.end(); ++itl )
+		(*itl).batch( b, rs );
+}
+
 void FeListBox::clear()
 {
 	m_texts.clear();
@@ -689,7 +703,7 @@ void FeListBox::setBgColor( sf::Color c )
 			m_texts[i].setBgColor( c );
 
 	if ( m_scripted )
-		FePresent::script_flag_redraw();
+		flag_redraw();
 }
 
 void FeListBox::set_bgr(int r)
@@ -771,7 +785,7 @@ void FeListBox::set_style(int s)
 			m_texts[i].setStyle( s );
 
 	if ( m_scripted )
-		FePresent::script_flag_redraw();
+		flag_redraw();
 }
 
 void FeListBox::set_justify(int j)
@@ -786,7 +800,7 @@ void FeListBox::set_justify(int j)
 	}
 
 	if ( m_scripted )
-		FePresent::script_flag_redraw();
+		flag_redraw();
 }
 
 void FeListBox::set_align(int a)
@@ -800,7 +814,7 @@ void FeListBox::set_align(int a)
 		m_texts[i].setAlignment( (FeTextPrimitive::Alignment)a );
 
 	if ( m_scripted )
-		FePresent::script_flag_redraw();
+		flag_redraw();
 }
 
 int FeListBox::get_selr()
@@ -940,7 +954,7 @@ void FeListBox::set_font( const char *f )
 		setFont( *font );
 		m_font_name = f;
 
-		FePresent::script_flag_redraw();
+		flag_redraw();
 	}
 }
 
@@ -25,6 +25,7 @@
 
 #include <SFML/Graphics.hpp>
 #include "fe_presentable.hpp"
+#include "fe_magic.hpp"
 #include "tp.hpp"
 
 #include <map>
@@ -119,6 +120,7 @@ public:
 	int get_margin();
 
 	const sf::Drawable &drawable() const { return (const sf::Drawable &)*this; };
+	void batch( FeDrawBatch &b, const sf::RenderStates &states ) const;
 
 	int get_bgr();
 	int get_bgg();
@@ -188,6 +190,7 @@ private:
 	std::vector<FeTextPrimitive> m_texts;
 	std::string m_font_name;
 	std::string m_format_string;
+	FeMagicTemplate m_format_template;
 	sf::Color m_selColour;
 	sf::Color m_selBg;
 	sf::Color m_selOutlineColour;
@@ -0,0 +1,397 @@
+/*
+ *
+ *  Attract-Mode Plus frontend
+ *  Copyright (C) 2025 Andrew Mickelson & Radek Dutkiewicz
+ *
+ *  This file is part of Attract-Mode Plus
+ *
+ *  Attract-Mode Plus is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Attract-Mode Plus is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Attract-Mode Plus.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "fe_magic.hpp"
+#include "fe_settings.hpp"
+#include "fe_present.hpp"
+#include "fe_util.hpp"
+#include "fe_util_sq.hpp"
+#include "fe_profiler.hpp"
+
+#include <sqrat.h>
+#include <chrono>
+#include <iomanip>
+
+namespace
+{
+	const char *SCRIPT_TOK = "[!";
+	const size_t SCRIPT_TOK_LEN = 2;
+}
+
+FeMagicTemplate::FeMagicTemplate()
+	: m_vm( NULL ),
+	m_generation( 0 ),
+	m_compiled( false ),
+	m_unresolved( false )
+{
+}
+
+FeMagicTemplate::~FeMagicTemplate()
+{
+	clear();
+}
+
+void FeMagicTemplate::clear()
+{
+	// Script handles are only released if their vm is still open
+	if ( m_vm && ( m_generation == fe_sq_vm_generation( m_vm ) ))
+	{
+		for ( std::vector<Op>::iterator itr = m_ops.begin(); itr != m_ops.end(); ++itr )
+		{
+			if ( (*itr).type == Script )
+			{
+				sq_release( m_vm, &(*itr).func );
+				sq_release( m_vm, &(*itr).env );
+			}
+		}
+	}
+
+	m_ops.clear();
+	m_vm = NULL;
+	m_compiled = false;
+	m_unresolved = false;
+}
+
+void FeMagicTemplate::set_format( const std::string &format )
+{
+	if ( m_compiled && ( format == m_format ))
+		return;
+
+	clear();
+	m_format = format;
+}
+
+void FeMagicTemplate::add_literal( const std::string &s, size_t start, size_t end )
+{
+	if ( end <= start )
+		return;
+
+	if ( !m_ops.empty() && ( m_ops.back().type == Literal ))
+	{
+		m_ops.back().text.append( s, start, end - start );
+		return;
+	}
+
+	Op op;
+	op.type = Literal;
+	op.id = -1;
+	op.params = 0;
+	op.text = s.substr( start, end - start );
+	m_ops.push_back( op );
+}
+
+//
+// Compile the "[Token]" substitutions in s[start, end), matching the
+// search done by FeSettings::do_text_substitutions_absolute()
+//
+void FeMagicTemplate::compile_fields( const std::string &s, size_t start, size_t end )
+{
+	size_t lit = start;
+	size_t pos = s.find( '[', start );
+	while (( pos != std::string::npos ) && ( pos < end ))
+	{
+		size_t close = s.find_first_of( ']', pos + 1 );
+		if (( close == std::string::npos ) || ( close >= end ))
+			break;
+
+		std::string token = s.substr( pos + 1, close - pos - 1 );
+
+		Op op;
+		op.params = 0;
+		op.id = get_token_index( FeRomInfo::indexStrings, token );
+		if ( op.id >= 0 )
+			op.type = Field;
+		else
+		{
+			op.id = get_token_index( FeRomInfo::specialStrings, token );
+			op.type = Special;
+		}
+
+		if ( op.id >= 0 )
+		{
+			add_literal( s, lit, pos );
+			m_ops.push_back( op );
+			lit = pos = close + 1;
+		}
+
+		// The substitution search resumes one character past a replaced token
+		pos = s.find( '[', pos + 1 );
+	}
+
+	add_literal( s, lit, end );
+}
+
+void FeMagicTemplate::compile()
+{
+	clear();
+
+	HSQUIRRELVM vm = Sqrat::DefaultVM::Get();
+	m_vm = vm;
+	m_generation = fe_sq_vm_generation( vm );
+	m_compiled = true;
+
+	size_t start = 0;
+	size_t pos = vm ? m_format.find( SCRIPT_TOK ) : std::string::npos;
+	while ( pos != std::string::npos )
+	{
+		size_t end = m_format.find_first_of( ']', pos + SCRIPT_TOK_LEN );
+		if ( end == std::string::npos )
+			break;
+
+		std::string magic = m_format.substr( pos + SCRIPT_TOK_LEN, end - pos - SCRIPT_TOK_LEN );
+		Sqrat::Function func( Sqrat::RootTable(), magic.c_str() );
+
+		if ( !func.IsNull() )
+		{
+			compile_fields( m_format, start, pos );
+
+			Op op;
+			op.type = Script;
+			op.id = -1;
+			op.params = fe_get_num_params( vm, func.GetFunc(), func.GetEnv() );
+			op.text = magic;
+			op.func = func.GetFunc();
+			op.env = func.GetEnv();
+			sq_addref( vm, &op.func );
+			sq_addref( vm, &op.env );
+			m_ops.push_back( op );
+
+			start = pos = end + 1;
+		}
+		else
+		{
+			FeDebug() << "Potential magic string ignored, no corresponding function in script: "
+				<< SCRIPT_TOK << magic << "]" << std::endl;
+
+			// Look again next time, the script may not have defined it yet
+			m_unresolved = true;
+			pos += SCRIPT_TOK_LEN;
+		}
+
+		pos = m_format.find( SCRIPT_TOK, pos );
+	}
+
+	compile_fields( m_format, start, m_format.size() );
+}
+
+bool FeMagicTemplate::call_script( Op &op,
+	int filter_offset,
+	int index_offset,
+	std::string &result )
+{
+	//
+	// Check the root table slot first, the script may have replaced or
+	// removed the function since it was compiled
+	//
+	sq_pushroottable( m_vm );
+	sq_pushstring( m_vm, op.text.c_str(), -1 );
+	if ( SQ_FAILED( sq_get( m_vm, -2 )))
+	{
+		sq_pop( m_vm, 1 );
+		return false;
+	}
+
+	HSQOBJECT func;
+	sq_getstackobj( m_vm, -1, &func );
+	if ( sq_type( func ) == OT_NULL )
+	{
+		sq_pop( m_vm, 2 );
+		return false;
+	}
+
+	if ( fe_obj_compare( m_vm, func, op.func ) != 0 )
+	{
+		sq_release( m_vm, &op.func );
+		op.func = func;
+		sq_addref( m_vm, &op.func );
+		op.params = fe_get_num_params( m_vm, op.func, op.env );
+	}
+	sq_pop( m_vm, 2 );
+
+	FeProfileTimer pt( FeScriptProfiler::Magic, op.text );
+
+	int nargs = 1;
+	sq_pushobject( m_vm, op.func );
+	sq_pushobject( m_vm, op.env );
+
+	switch ( op.params )
+	{
+	case 2:
+		sq_pushinteger( m_vm, index_offset );
+		sq_pushinteger( m_vm, filter_offset );
+		nargs = 3;
+		break;
+	case 1:
+		sq_pushinteger( m_vm, index_offset );
+		nargs = 2;
+		break;
+	default:
+		// No arguments, as in script_process_magic_strings().  Extra
+		// parameters may have defaults, otherwise the call reports the error
+		break;
+	}
+
+	if ( SQ_FAILED( sq_call( m_vm, nargs, SQTrue, Sqrat::ErrorHandling::IsEnabled() )))
+	{
+		sq_pop( m_vm, 1 );
+		FeLog() << "Script Error in magic string function: "
+			<< op.text << " - " << Sqrat::LastErrorString( m_vm ) << std::endl;
+		return false;
+	}
+
+	result = Sqrat::Var<std::string>( m_vm, -1 ).value;
+	sq_pop( m_vm, 2 );
+
+	if ( Sqrat::Error::Instance().Occurred( m_vm ))
+	{
+		FeLog() << "Script Error in magic string function: "
+			<< op.text << " - " << Sqrat::Error::Instance().Message( m_vm ) << std::endl;
+		return false;
+	}
+
+	return true;
+}
+
+void FeMagicTemplate::expand( std::string &out,
+	FeSettings *feSettings,
+	int filter_index,
+	int rom_index,
+	int filter_offset,
+	int index_offset )
+{
+	if ( !m_compiled || m_unresolved
+			|| ( m_vm != Sqrat::DefaultVM::Get() )
+			|| ( m_generation != fe_sq_vm_generation( m_vm ) ))
+		compile();
+
+	out.clear();
+
+	for ( std::vector<Op>::iterator itr = m_ops.begin(); itr != m_ops.end(); ++itr )
+	{
+		switch ( (*itr).type )
+		{
+		case Literal:
+			out += (*itr).text;
+			break;
+
+		case Field:
+			feSettings->get_index_token_value( (FeRomInfo::Index)(*itr).id,
+				filter_index, rom_index, m_value );
+			out += m_value;
+			break;
+
+		case Special:
+			if ( feSettings->get_special_token_value( (FeRomInfo::Special)(*itr).id,
+					filter_index, rom_index, m_value ))
+				out += m_value;
+			break;
+
+		case Script:
+			if ( call_script( *itr, filter_offset, index_offset, m_value ))
+			{
+				// Script results may contain magic tokens of their own
+				if ( m_value.find( '[' ) != std::string::npos )
+					feSettings->do_text_substitutions_absolute( m_value, filter_index, rom_index );
+
+				out += m_value;
+			}
+			else
+			{
+				// Leave the token in place, as the uncompiled path does
+				out += SCRIPT_TOK;
+				out += (*itr).text;
+				out += "]";
+			}
+			break;
+		}
+	}
+}
+
+void FeMagicTemplate::benchmark( FeSettings &feSettings )
+{
+	const int ROWS = 40;
+	const int MOVES = 10000;
+
+	int filter_index = feSettings.get_current_filter_index();
+	int list_size = feSettings.get_filter_size( filter_index );
+
+	if ( list_size < 1 )
+	{
+		FeLog() << "Listbox benchmark needs a display with a non-empty romlist." << std::endl;
+		return;
+	}
+
+	const char *formats[] =
+	{
+		"[Title]",
+		"[Title] ([Year] [Manufacturer])",
+		"[ListEntry]/[ListSize] [Title] [FavouriteStar]",
+		NULL
+	};
+
+	FeLog() << "Listbox formatting benchmark (" << ROWS << " rows, "
+		<< MOVES << " selection changes, " << list_size << " games):" << std::endl;
+
+	for ( int f=0; formats[f]; f++ )
+	{
+		std::string format = formats[f];
+		std::string text;
+		size_t checksum[2] = { 0, 0 };
+		long long ns[2];
+
+		// Previous behaviour, parse the format for every row
+		auto start = std::chrono::steady_clock::now();
+		for ( int m=0; m<MOVES; m++ )
+		{
+			for ( int i=0; i<ROWS; i++ )
+			{
+				text = format;
+				FePresent::script_process_magic_strings( text, 0, i - ROWS / 2 );
+				feSettings.do_text_substitutions_absolute( text, filter_index, ( m + i ) % list_size );
+				checksum[0] += text.size();
+			}
+		}
+		ns[0] = std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now() - start ).count();
+
+		// Compiled template
+		FeMagicTemplate t;
+		start = std::chrono::steady_clock::now();
+		for ( int m=0; m<MOVES; m++ )
+		{
+			for ( int i=0; i<ROWS; i++ )
+			{
+				t.set_format( format );
+				t.expand( text, &feSettings, filter_index, ( m + i ) % list_size, 0, i - ROWS / 2 );
+				checksum[1] += text.size();
+			}
+		}
+		ns[1] = std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now() - start ).count();
+
+		const double rows = static_cast<double>( ROWS ) * MOVES;
+		FeLog() << " - " << format << std::endl
+			<< "     parsed:   " << std::fixed << std::setprecision( 1 ) << ns[0] / rows << " ns/row" << std::endl
+			<< "     compiled: " << std::fixed << std::setprecision( 1 ) << ns[1] / rows << " ns/row"
+			<< (( checksum[0] != checksum[1] ) ? " (OUTPUT MISMATCH)" : "" ) << std::endl;
+	}
+}
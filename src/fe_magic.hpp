@@ -0,0 +1,98 @@
+/*
+ *
+ *  Attract-Mode Plus frontend
+ *  Copyright (C) 2025 Andrew Mickelson & Radek Dutkiewicz
+ *
+ *  This file is part of Attract-Mode Plus
+ *
+ *  Attract-Mode Plus is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Attract-Mode Plus is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Attract-Mode Plus.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef FE_MAGIC_HPP
+#define FE_MAGIC_HPP
+
+#include <squirrel.h>
+#include <string>
+#include <vector>
+
+class FeSettings;
+
+//
+// A format string containing magic tokens ( "[Title]", "[!script_func]" )
+// compiled into a list of literals, rom fields, special values and script
+// function handles, so it can be expanded for many roms without parsing it
+// again.  Expanding gives the same result as running
+// FePresent::script_process_magic_strings() followed by
+// FeSettings::do_text_substitutions_absolute() on the format.
+//
+// The format is recompiled when it changes or the script vm is reloaded.
+// Script functions are looked up in the root table again on each call,
+// so a function that is redefined by the script is picked up.
+//
+class FeMagicTemplate
+{
+public:
+	FeMagicTemplate();
+	~FeMagicTemplate();
+
+	void set_format( const std::string &format );
+	const std::string &get_format() const { return m_format; };
+
+	//
+	// Replace "out" with the format expanded for the given rom.  Script
+	// functions are passed index_offset and filter_offset
+	//
+	void expand( std::string &out,
+		FeSettings *feSettings,
+		int filter_index,
+		int rom_index,
+		int filter_offset,
+		int index_offset );
+
+	// Time listbox row formatting against the current display's romlist
+	static void benchmark( FeSettings &feSettings );
+
+private:
+	FeMagicTemplate( const FeMagicTemplate & );
+	FeMagicTemplate &operator=( const FeMagicTemplate & );
+
+	enum OpType { Literal, Field, Special, Script };
+
+	struct Op
+	{
+		OpType type;
+		int id;				// FeRomInfo::Index or FeRomInfo::Special
+		int params;			// script function parameter count
+		std::string text;	// literal text, or the script token
+		HSQOBJECT func;
+		HSQOBJECT env;
+	};
+
+	void compile();
+	void compile_fields( const std::string &s, size_t start, size_t end );
+	void add_literal( const std::string &s, size_t start, size_t end );
+	bool call_script( Op &op, int filter_offset, int index_offset, std::string &result );
+	void clear();
+
+	std::string m_format;
+	std::vector<Op> m_ops;
+	std::string m_value;
+	HSQUIRRELVM m_vm;
+	unsigned int m_generation;
+	bool m_compiled;
+	bool m_unresolved; // a script token had no matching function when compiled
+};
+
+#endif
@@ -853,7 +853,7 @@ void FeOverlay::input_map_dialog(
 			redraw = false;
 		}
 		else
-			sf::sleep( sf::milliseconds( 30 ) );
+			m_fePresent.idle_wait( sf::milliseconds( 30 ) );
 	}
 }
 
@@ -892,6 +892,7 @@ bool FeOverlay::edit_game_dialog( int default_sel, FeInputMap::Command extra_exi
 				m_feSettings.save();
 
 				// This forces the display to reinitialize with the updated settings
+				m_feSettings.clear_romlist_cache();
 				m_feSettings.set_display( m_feSettings.get_current_display_index() );
 			}
 		}
@@ -1797,7 +1798,7 @@ bool FeOverlay::event_loop( FeEventLoopCtx &ctx )
 			redraw = false;
 		}
 		else
-			sf::sleep( sf::milliseconds( 30 ) );
+			m_fePresent.idle_wait( sf::milliseconds( 30 ) );
 
 		if ( ctx.move_command != FeInputMap::LAST_COMMAND )
 		{
@@ -2155,7 +2156,7 @@ bool FeOverlay::edit_loop( std::vector<sf::Drawable *> d,
 		m_wnd.display();
 
 		if ( !redraw && m_feSettings.get_info_bool( FeSettings::PowerSaving ) )
-			sf::sleep( sf::milliseconds( 30 ) );
+			m_fePresent.idle_wait( sf::milliseconds( 30 ) );
 
 		redraw = false;
 
@@ -29,6 +29,9 @@
 #include "fe_input.hpp"
 #include "fe_file.hpp"
 #include "fe_blend.hpp"
+#include "fe_batch.hpp"
+#include "fe_frametime.hpp"
+#include "fe_atlas.hpp"
 #include "zip.hpp"
 #include "base64.hpp"
 #include "image_loader.hpp"
@@ -44,6 +47,10 @@
 
 #include <SFML/Audio.hpp>
 
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
 
 #ifdef USE_XLIB
 #include <X11/extensions/Xrandr.h>
@@ -102,11 +109,13 @@ FeFontContainer::FeFontContainer()
 
 FeFontContainer::~FeFontContainer()
 {
+	sf::GlyphTable::invalidate( m_font );
 }
 
 void FeFontContainer::set_font( const std::string &n )
 {
 	m_name = n;
+	sf::GlyphTable::invalidate( m_font );
 
 	if ( !m_font.openFromFile( n ) )
 		FeLog() << "Error loading font from file: " << n << std::endl;
@@ -114,6 +123,7 @@ void FeFontContainer::set_font( const std::string &n )
 
 void FeFontContainer::load_default_font()
 {
+	sf::GlyphTable::invalidate( m_font );
 	m_font_binary_data = base64_decode( _binary_resources_fonts_BarlowCJK_ttf );
 	std::ignore = m_font.openFromMemory( m_font_binary_data.data(), m_font_binary_data.size() );
 }
@@ -125,6 +135,7 @@ const sf::Font &FeFontContainer::get_font() const
 
 void FeFontContainer::clear_font()
 {
+	sf::GlyphTable::invalidate( m_font );
 	m_font = sf::Font();
 	m_needs_reload = true;
 }
@@ -177,6 +188,9 @@ FePresent::FePresent( FeSettings *fesettings, FeWindow &wnd )
 	m_logo_image( NULL ),
 	m_layout_time_old( sf::Time::Zero ),
 	m_frame_time( 0.0f ),
+	m_draw_calls( 0 ),
+	m_draw_batched( 0 ),
+	m_texture_binds( 0 ),
 	m_baseRotation( FeSettings::RotateNone ),
 	m_toggleRotation( FeSettings::RotateNone ),
 	m_refresh_rate( 0 ),
@@ -189,7 +203,11 @@ FePresent::FePresent( FeSettings *fesettings, FeWindow &wnd )
 	m_emptyShader( NULL ),
 	m_overlay_caption( NULL ),
 	m_overlay_lb( NULL ),
-	m_layout_loaded( false )
+	m_layout_loaded( false ),
+	m_hold_changes( false ),
+	m_held_selection( -1 ),
+	m_held_filter( -1 ),
+	m_search_held( false )
 {
 	m_baseRotation = m_feSettings->get_screen_rotation();
 	m_layoutFontName = "";
@@ -565,7 +583,21 @@ void FePresent::draw( sf::RenderTarget& target, sf::RenderStates states ) const
 {
 	std::vector<FeBasePresentable *>::const_iterator itl;
 
+	// Show the frame from before the game until its images are loaded again
+	if ( m_snapshot )
+	{
+		sf::View old_view = target.getView();
+		target.setView( target.getDefaultView() );
+		target.draw( sf::Sprite( *m_snapshot ) );
+		target.setView( old_view );
+		return;
+	}
+
+	//
+	// Consecutive elements sharing a texture, blend mode and shader are
+	// submitted together
 	//
+	FeDrawBatch batch( target );
 	for ( unsigned int i=0; i<m_mon.size(); i++ )
 	{
 		// use m_transform on monitor 0
@@ -573,7 +605,7 @@ void FePresent::draw( sf::RenderTarget& target, sf::RenderStates states ) const
 		for ( itl=m_mon[i].elements.begin(); itl != m_mon[i].elements.end(); ++itl )
 		{
 			if ( (*itl)->get_visible() )
-				target.draw( (*itl)->drawable(), states );
+				(*itl)->batch( batch, states );
 		}
 	}
 }
@@ -597,6 +629,7 @@ FeImage *FePresent::add_image( bool is_artwork,
 	if (( !is_artwork ) && ( n.find_first_of( "[" ) == std::string::npos ))
 		new_image->setFileName( n.c_str() );
 
+	p.flag_dirty();
 	flag_redraw();
 	m_texturePool.push_back( new_tex );
 	p.elements.push_back( new_image );
@@ -608,6 +641,7 @@ FeImage *FePresent::add_clone( FeImage *o,
 			FePresentableParent &p )
 {
 	FeImage *new_image = new FeImage( o );
+	p.flag_dirty();
 	flag_redraw();
 	p.elements.push_back( new_image );
 
@@ -625,6 +659,7 @@ FeText *FePresent::add_text( const std::string &n, int x, int y, int w, int h,
 	new_text->setFont( *get_layout_font() );
 	new_text->set_scale_factor( m_layoutScale.x, m_layoutScale.y );
 
+	p.flag_dirty();
 	flag_redraw();
 	p.elements.push_back( new_text );
 	return new_text;
@@ -638,6 +673,7 @@ FeListBox *FePresent::add_listbox( int x, int y, int w, int h,
 	new_lb->setFont( *get_layout_font() );
 	new_lb->set_scale_factor( m_layoutScale.x, m_layoutScale.y );
 
+	p.flag_dirty();
 	flag_redraw();
 	m_listBox = new_lb;
 	p.elements.push_back( new_lb );
@@ -650,6 +686,7 @@ FeRectangle *FePresent::add_rectangle( float x, float y, float w, float h,
 	FeRectangle *new_rc = new FeRectangle( p, x, y, w, h );
 	new_rc->set_scale_factor( m_layoutScale.x, m_layoutScale.y );
 
+	p.flag_dirty();
 	flag_redraw();
 	p.elements.push_back( new_rc );
 	return new_rc;
@@ -670,6 +707,7 @@ FeImage *FePresent::add_surface( float x, float y, int w, int h, FePresentablePa
 
 	new_image->texture_changed();
 
+	p.flag_dirty();
 	flag_redraw();
 	p.elements.push_back( new_image );
 	m_texturePool.push_back( new_surface );
@@ -921,6 +959,12 @@ int FePresent::get_filter_index() const
 
 void FePresent::set_filter_index( int idx )
 {
+	if ( m_hold_changes )
+	{
+		m_held_filter = idx;
+		return;
+	}
+
 	int new_offset = idx - get_filter_index();
 	if ( new_offset != 0 )
 	{
@@ -947,6 +991,16 @@ bool FePresent::get_clones_list_showing() const
 		return false;
 }
 
+bool FePresent::get_list_loading() const
+{
+	return m_feSettings->get_romlist_loading();
+}
+
+float FePresent::get_list_progress() const
+{
+	return m_feSettings->get_romlist_progress();
+}
+
 int FePresent::get_selection_index() const
 {
 	return m_feSettings->get_rom_index( m_feSettings->get_current_filter_index(), 0 );
@@ -984,6 +1038,12 @@ int FePresent::get_list_limit() const
 
 void FePresent::set_selection_index( int index )
 {
+	if ( m_hold_changes )
+	{
+		m_held_selection = index;
+		return;
+	}
+
 	int new_offset = index - get_selection_index();
 	if ( new_offset != 0 )
 		change_selection( new_offset );
@@ -1194,6 +1254,12 @@ void FePresent::redraw_surfaces()
 {
 	std::vector<FeBaseTextureContainer *>::iterator itc;
 
+	// A new frame is starting, keep the draw counts from the last one
+	m_draw_calls = FeDrawBatch::get_draw_calls();
+	m_draw_batched = FeDrawBatch::get_batched();
+	m_texture_binds = FeDrawBatch::get_texture_binds();
+	FeDrawBatch::reset_counts();
+
 	for ( itc=m_texturePool.begin(); itc != m_texturePool.end(); ++itc )
 		(*itc)->on_redraw_surfaces();
 }
@@ -1290,21 +1356,87 @@ void FePresent::load_layout( bool initial_load )
 
 bool FePresent::tick()
 {
+	m_frame_clock.restart();
+
 	sf::Time current_time = m_layout_time.getElapsedTime();
 	sf::Time delta_time = current_time - m_layout_time_old;
 	m_layout_time_old = current_time;
 	m_frame_time = delta_time.asSeconds() * 1000.0f;
 
+	FeFrameTimer &ft = FeFrameTimer::get_ref();
+	ft.mark( FeFrameTimer::Input );
+
 	bool ret_val = false;
 	if ( on_tick())
 		ret_val = true;
 
+	ft.mark( FeFrameTimer::Script );
+
 	if ( video_tick() )
 		ret_val = true;
 
+	if ( m_snapshot && check_restored() )
+		ret_val = true;
+
+	ft.mark( FeFrameTimer::Video );
+
 	return ret_val;
 }
 
+void FePresent::idle_wait( sf::Time max_wait )
+{
+	FeFrameTimer::Wake reason = FeFrameTimer::WakeTimeout;
+	sf::Time timeout = max_wait;
+
+	// Frames are due at the refresh rate, counted from the last tick()
+	sf::Time frame = sf::seconds( 1.f / ( m_refresh_rate > 0 ? m_refresh_rate : 60 ));
+	sf::Time next_frame = std::max( frame - m_frame_clock.getElapsedTime(), sf::Time::Zero );
+
+	bool playing = false;
+	for ( std::vector<FeBaseTextureContainer *>::iterator itm=m_texturePool.begin();
+			itm != m_texturePool.end(); ++itm )
+	{
+		if ( (*itm)->get_play_state() || (*itm)->is_loading() )
+		{
+			playing = true;
+			break;
+		}
+	}
+
+	int saver_timeout = m_feSettings->get_screen_saver_timeout();
+
+	if ( has_tick_callbacks() && ( next_frame < timeout ))
+	{
+		reason = FeFrameTimer::WakeTick;
+		timeout = next_frame;
+	}
+	else if (( playing || m_snapshot ) && ( next_frame < timeout ))
+	{
+		reason = FeFrameTimer::WakeVideo;
+		timeout = next_frame;
+	}
+	else if (( saver_timeout > 0 )
+		&& ( m_feSettings->get_present_state() != FeSettings::ScreenSaver_Showing ))
+	{
+		sf::Time saver_due = sf::seconds( saver_timeout ) + sf::milliseconds( 1 )
+			- ( m_layout_time.getElapsedTime() - m_lastInput );
+
+		// Once it is past due, only the main loop starts the screen saver.
+		// Menus and dialogs keep waiting for max_wait
+		if (( saver_due > sf::Time::Zero ) && ( saver_due < timeout ))
+		{
+			reason = FeFrameTimer::WakeScreenSaver;
+			timeout = saver_due;
+		}
+	}
+
+	sf::Clock idle;
+	if (( timeout > sf::Time::Zero ) && m_window.wait_event( timeout ))
+		reason = FeFrameTimer::WakeInput;
+
+	FeFrameTimer::get_ref().add_wake( reason, idle.getElapsedTime() );
+}
+
 bool FePresent::video_tick()
 {
 	bool ret_val=false;
@@ -1313,7 +1445,10 @@ bool FePresent::video_tick()
 			itm != m_texturePool.end(); ++itm )
 	{
 		if ( (*itm)->tick( m_feSettings, m_playMovies ) )
+		{
+			(*itm)->flag_images_redraw();
 			ret_val=true;
+		}
 	}
 
 	// Check if we need to loop any script sounds that are set to loop
@@ -1405,11 +1540,31 @@ void FePresent::pre_run()
 	for ( std::vector<FeMusic *>::iterator its=m_musics.begin();
 				its != m_musics.end(); ++its )
 		(*its)->set_playing( false );
+
+	if ( m_feSettings->get_info_bool( FeSettings::ReleaseMemoryOnLaunch ) )
+		release_memory();
 }
 
 void FePresent::post_run()
 {
 	std::vector<FeSound *>::iterator its;
+	m_restore_clock.restart();
+
+	//
+	// Put the last frame back on screen before anything else, the released
+	// images and videos are loaded again behind it
+	//
+	if ( m_snapshot )
+	{
+		sf::RenderWindow &win = m_window.get_win();
+		win.setView( win.getDefaultView() );
+		win.clear();
+		win.draw( sf::Sprite( *m_snapshot ) );
+		win.display();
+
+		FeLog() << "First frame after game shown in "
+			<< m_restore_clock.getElapsedTime().asMilliseconds() << "ms" << std::endl;
+	}
 
 #ifndef NO_MOVIE
 	//
@@ -1425,6 +1580,8 @@ void FePresent::post_run()
 		(*its)->release_audio( false );
 #endif
 
+	restore_memory();
+
 	for ( std::vector<FeBaseTextureContainer *>::iterator itm=m_texturePool.begin();
 				itm != m_texturePool.end(); ++itm )
 		(*itm)->set_vol( m_feSettings->get_play_volume( FeSoundInfo::Movie ) );
@@ -1446,6 +1603,71 @@ void FePresent::post_run()
 	update_to( ToNewList, false );
 }
 
+//
+// Keep a copy of the current frame and free the images, videos and image
+// caches, so that they aren't held while a game is running
+//
+void FePresent::release_memory()
+{
+	sf::Clock clk;
+
+	sf::RenderTexture rt;
+	if ( rt.resize( m_window.get_win().getSize() ) )
+	{
+		rt.clear();
+		rt.draw( *this );
+		rt.display();
+		m_snapshot.reset( new sf::Texture( rt.getTexture() ) );
+	}
+
+	size_t bytes = 0;
+	for ( std::vector<FeBaseTextureContainer *>::iterator itm=m_texturePool.begin();
+				itm != m_texturePool.end(); ++itm )
+		bytes += (*itm)->release_memory();
+
+	bytes += FeImageLoader::get_ref().release_cache();
+	bytes += FeTextureAtlas::get_ref().release_pages();
+
+#ifdef __GLIBC__
+	// Give the freed heap back to the system
+	malloc_trim( 0 );
+#endif
+
+	FeLog() << "Released " << bytes / 1024 << "KB of images and videos in "
+		<< clk.getElapsedTime().asMilliseconds() << "ms" << std::endl;
+}
+
+void FePresent::restore_memory()
+{
+	for ( std::vector<FeBaseTextureContainer *>::iterator itm=m_texturePool.begin();
+				itm != m_texturePool.end(); ++itm )
+		(*itm)->restore_memory();
+}
+
+//
+// Stop showing the snapshot once the images have finished loading in the
+// background, or after a second so a slow load can't hold up the layout.
+// Returns true if the snapshot was removed
+//
+bool FePresent::check_restored()
+{
+	if ( m_restore_clock.getElapsedTime() < sf::seconds( 1 ) )
+	{
+		for ( std::vector<FeBaseTextureContainer *>::iterator itm=m_texturePool.begin();
+					itm != m_texturePool.end(); ++itm )
+		{
+			if ( (*itm)->is_loading() )
+				return false;
+		}
+	}
+
+	FeLog() << "Frontend restored in "
+		<< m_restore_clock.getElapsedTime().asMilliseconds() << "ms" << std::endl;
+
+	m_snapshot.reset();
+	return true;
+}
+
 void FePresent::toggle_movie()
 {
 	m_playMovies = !m_playMovies;
@@ -1659,11 +1881,54 @@ FeShader *FePresent::get_empty_shader()
 
 void FePresent::set_search_rule( const char *s )
 {
+	if ( m_hold_changes )
+	{
+		m_held_search = s;
+		m_search_held = true;
+		return;
+	}
+
 	m_feSettings->set_search_rule( s );
 	update_to( ToNewList, true );
 	on_transition( ToNewList, 0 );
 }
 
+bool FePresent::apply_held_list_changes()
+{
+	bool retval = false;
+
+	//
+	// Applied in the order that a script would usually make them: the
+	// search and filter pick the list, then the selection within it
+	//
+	if ( m_search_held )
+	{
+		m_search_held = false;
+		std::string rule;
+		rule.swap( m_held_search );
+		set_search_rule( rule.c_str() );
+		retval = true;
+	}
+
+	if ( m_held_filter >= 0 )
+	{
+		int idx = m_held_filter;
+		m_held_filter = -1;
+		set_filter_index( idx );
+		retval = true;
+	}
+
+	if ( m_held_selection >= 0 )
+	{
+		int idx = m_held_selection;
+		m_held_selection = -1;
+		set_selection_index( idx );
+		retval = true;
+	}
+
+	return retval;
+}
+
 const char *FePresent::get_search_rule()
 {
 	return m_feSettings->get_search_rule().c_str();
@@ -1702,11 +1967,41 @@ sf::Time FePresent::get_layout_time()
 	return m_layout_time.getElapsedTime();
 }
 
+sf::Time FePresent::get_idle_time()
+{
+	return m_layout_time.getElapsedTime() - m_lastInput;
+}
+
 float FePresent::get_layout_frame_time()
 {
 	return m_frame_time;
 }
 
+int FePresent::get_draw_calls()
+{
+	return m_draw_calls;
+}
+
+int FePresent::get_draw_batched()
+{
+	return m_draw_batched;
+}
+
+int FePresent::get_texture_binds()
+{
+	return m_texture_binds;
+}
+
+int FePresent::get_surfaces_rendered()
+{
+	return FeSurfaceTextureContainer::get_rendered_count();
+}
+
+int FePresent::get_surfaces_skipped()
+{
+	return FeSurfaceTextureContainer::get_skipped_count();
+}
+
 int FePresent::get_refresh_rate()
 {
 	return m_refresh_rate;
@@ -1734,7 +2029,7 @@ void FePresent::script_do_update( FeBasePresentable *bp )
 	{
 		bp->on_new_list( fep->m_feSettings );
 		bp->on_new_selection( fep->m_feSettings );
-		fep->flag_redraw();
+		bp->flag_redraw();
 	}
 }
 
@@ -1745,6 +2040,7 @@ void FePresent::script_do_update( FeBaseTextureContainer *tc )
 	{
 		tc->on_new_list( fep->m_feSettings, false );
 		tc->on_new_selection( fep->m_feSettings );
+		tc->flag_images_redraw();
 		fep->flag_redraw();
 	}
 }
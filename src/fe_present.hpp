@@ -24,6 +24,7 @@
 #define FE_PRESENT_HPP
 
 #include <SFML/Graphics.hpp>
+#include <memory>
 #include "fe_presentable.hpp"
 #include "fe_settings.hpp"
 #include "fe_music.hpp"
@@ -146,6 +147,9 @@ protected:
 	FeStableClock m_layout_time;
 	sf::Time m_layout_time_old;
 	float m_frame_time;
+	int m_draw_calls;
+	int m_draw_batched;
+	int m_texture_binds;
 	sf::Time m_lastInput;
 
 	FeSettings::RotationState m_baseRotation;
@@ -176,15 +180,37 @@ protected:
 	FeListBox *m_overlay_lb;
 	bool m_layout_loaded;
 
+	//
+	// Tick callbacks also run during transitions.  List changes that they
+	// make are held until the main loop is back in control, so that they
+	// don't start another transition in the middle of a navigation sequence
+	//
+	bool m_hold_changes;
+	int m_held_selection; // -1 if nothing held
+	int m_held_filter; // -1 if nothing held
+	bool m_search_held;
+	std::string m_held_search;
+
+	std::unique_ptr<sf::Texture> m_snapshot; // frame shown while memory is restored after a game
+	sf::Clock m_restore_clock;
+	sf::Clock m_frame_clock; // time since the last tick()
+
 	FePresent( const FePresent & );
 	FePresent &operator=( const FePresent & );
 
 	void toggle_movie();
 
+	// Free images, videos and caches while a game runs, see ReleaseMemoryOnLaunch
+	void release_memory();
+	void restore_memory();
+	bool check_restored();
+
 	void toggle_rotate( FeSettings::RotationState ); // toggle between none and provided state
 	FeSettings::RotationState get_actual_rotation();
 	void set_transforms();
 
+	bool apply_held_list_changes(); // apply list changes held during a transition, return true if any
+
 	// Overrides from base classes:
 	//
 	void sort_zorder();
@@ -210,6 +236,8 @@ protected:
 	void set_filter_index( int );
 	int get_current_filter_size() const;
 	bool get_clones_list_showing() const;
+	bool get_list_loading() const;
+	float get_list_progress() const;
 	int get_selection_index() const;
 	int get_sort_by() const;
 	bool get_reverse_order() const;
@@ -247,6 +275,12 @@ public:
 
 	bool tick(); // run vm on_tick and update videos.  return true if redraw required
 	bool video_tick(); // update videos only. return true if redraw required
+
+	//
+	// Wait for input when nothing needs to be redrawn, until the next tick
+	// or video frame is due, the screen saver starts or max_wait has passed
+	//
+	void idle_wait( sf::Time max_wait=sf::milliseconds( 250 ) );
 	void redraw(); // redraw the screen while doing computationally intensive loops
 
 	bool saver_activation_check();
@@ -293,7 +327,13 @@ public:
 
 	int get_layout_ms();
 	sf::Time get_layout_time();
+	sf::Time get_idle_time(); // time since the last user input
 	float get_layout_frame_time();
+	int get_draw_calls();
+	int get_draw_batched();
+	int get_texture_binds();
+	int get_surfaces_rendered();
+	int get_surfaces_skipped();
 	int get_refresh_rate();
 	bool get_mouse_pointer();
 	void set_mouse_pointer( bool );
@@ -315,6 +355,7 @@ public:
 	//
 	virtual bool on_new_layout()=0;
 	virtual bool on_tick()=0;
+	virtual bool has_tick_callbacks() const=0;
 	virtual void on_transition( FeTransitionType, int var )=0;
 	virtual void flag_redraw()=0;
 	virtual void flag_sort_zorder()=0;
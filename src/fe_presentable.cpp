@@ -22,6 +22,7 @@
 
 #include "fe_presentable.hpp"
 #include "fe_present.hpp"
+#include "fe_batch.hpp"
 
 FeBasePresentable::FeBasePresentable( FePresentableParent &p )
 	: m_parent( p ),
@@ -52,6 +53,11 @@ void FeBasePresentable::on_new_list( FeSettings * )
 {
 }
 
+void FeBasePresentable::batch( FeDrawBatch &b, const sf::RenderStates &states ) const
+{
+	b.draw( drawable(), states );
+}
+
 void FeBasePresentable::set_scale_factor( float, float )
 {
 }
@@ -192,7 +198,7 @@ void FeBasePresentable::set_visible( bool v )
 	if ( v != m_visible )
 	{
 		m_visible = v;
-		FePresent::script_flag_redraw();
+		flag_redraw();
 	}
 }
 
@@ -215,6 +221,13 @@ FeShader *FeBasePresentable::script_get_shader() const
 void FeBasePresentable::script_set_shader( FeShader *sh )
 {
 	m_shader = sh;
+	flag_redraw();
+}
+
+void FeBasePresentable::flag_redraw()
+{
+	m_parent.flag_dirty();
+	FePresent::script_flag_redraw();
 }
 
 int FeBasePresentable::get_zorder()
@@ -230,7 +243,7 @@ void FeBasePresentable::set_zorder( int pos )
 	m_zorder = pos;
 
 	FePresent::script_flag_sort_zorder();
-	FePresent::script_flag_redraw();
+	flag_redraw();
 }
 
 int FePresentableParent::get_nesting_level()
@@ -238,6 +251,10 @@ int FePresentableParent::get_nesting_level()
 	return m_nesting_level;
 }
 
+void FePresentableParent::flag_dirty()
+{
+}
+
 void FePresentableParent::set_nesting_level( int p )
 {
 	m_nesting_level = p;
@@ -29,11 +29,13 @@
 class FeSettings;
 class FeShader;
 class FePresentableParent;
+class FeDrawBatch;
 
 namespace sf
 {
 	class Drawable;
 	class Color;
+	struct RenderStates;
 };
 
 class FeBasePresentable
@@ -53,6 +55,9 @@ public:
 	virtual void set_scale_factor( float, float );
 
 	virtual const sf::Drawable &drawable() const=0;
+
+	// Draw using the batch.  The default draws drawable() unbatched
+	virtual void batch( FeDrawBatch &b, const sf::RenderStates &states ) const;
 	virtual sf::Vector2f getPosition() const=0;
 	virtual void setPosition( const sf::Vector2f & )=0;
 	virtual sf::Vector2f getSize() const=0;
@@ -95,9 +100,12 @@ public:
 	virtual bool get_visible() const;
 	void set_visible( bool );
 
+	// Flag that this element has changed and needs to be redrawn
+	void flag_redraw();
+
 	FeShader *get_shader() const;
 	FeShader *script_get_shader() const;
-	void script_set_shader( FeShader *s );
+	virtual void script_set_shader( FeShader *s );
 
 	int get_zorder();
 	void set_zorder( int );
@@ -120,6 +128,9 @@ public:
 	int get_nesting_level();
 	void set_nesting_level( int );
 
+	// Called when one of the elements has changed
+	virtual void flag_dirty();
+
 	FeImage *add_image(const char *,float, float, float, float);
 	FeImage *add_image(const char *, float, float);
 	FeImage *add_image(const char *);
@@ -0,0 +1,378 @@
+/*
+ *
+ *  Attract-Mode Plus frontend
+ *  Copyright (C) 2025 Andrew Mickelson & Radek Dutkiewicz
+ *
+ *  This file is part of Attract-Mode Plus
+ *
+ *  Attract-Mode Plus is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Attract-Mode Plus is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Attract-Mode Plus.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "fe_profiler.hpp"
+#include "fe_base.hpp" // logging
+#include "fe_util.hpp"
+
+#include "nowide/fstream.hpp"
+#include "rapidjson/prettywriter.h"
+#include "rapidjson/stringbuffer.h"
+
+#include <squirrel.h>
+#include <algorithm>
+
+namespace
+{
+	const size_t MAX_SAMPLES = 1000;
+	const std::string NO_SCRIPT;
+};
+
+const char *FeScriptProfiler::typeStrings[] =
+{
+	"tick",
+	"transition",
+	"signal",
+	"magic",
+	NULL
+};
+
+void FeScriptProfiler::Samples::add( float v )
+{
+	if ( values.size() < MAX_SAMPLES )
+		values.push_back( v );
+	else
+		values[next] = v;
+
+	next = ( next + 1 ) % MAX_SAMPLES;
+}
+
+float FeScriptProfiler::Samples::percentile( float p ) const
+{
+	if ( values.empty() )
+		return 0.f;
+
+	std::vector<float> temp( values );
+	size_t n = std::min( temp.size() - 1, (size_t)( p * temp.size() ));
+	std::nth_element( temp.begin(), temp.begin() + n, temp.end() );
+	return temp[n];
+}
+
+void FeScriptProfiler::FrameStat::add( float v, int frames )
+{
+	total += v;
+	min = ( frames == 0 ) ? v : std::min( min, v );
+	max = ( frames == 0 ) ? v : std::max( max, v );
+	samples.add( v );
+}
+
+FeScriptProfiler::FeScriptProfiler()
+	: m_frames( 0 ),
+	m_current_us( 0 ),
+	m_alloc_count( 0 ),
+	m_alloc_size( 0 ),
+	m_depth( 0 ),
+	m_enabled( false )
+{
+}
+
+FeScriptProfiler &FeScriptProfiler::get_ref()
+{
+	static FeScriptProfiler profiler;
+	return profiler;
+}
+
+void FeScriptProfiler::set_enabled( bool e )
+{
+	if ( e == m_enabled )
+		return;
+
+	m_enabled = e;
+	m_current_us = 0;
+	m_depth = 0;
+
+	SQUnsignedInteger count, size;
+	sq_getallocstats( &count, &size );
+	m_alloc_count = count;
+	m_alloc_size = size;
+
+	FeDebug() << "Script profiler " << ( e ? "enabled" : "disabled" ) << std::endl;
+}
+
+void FeScriptProfiler::reset()
+{
+	m_entries.clear();
+	m_lookup.clear();
+	m_frame_time = FrameStat();
+	m_frame_allocs = FrameStat();
+	m_frame_alloc_kb = FrameStat();
+	m_frames = 0;
+	m_current_us = 0;
+}
+
+void FeScriptProfiler::begin_call()
+{
+	m_depth++;
+}
+
+void FeScriptProfiler::end_call( Type t,
+	const std::string &name,
+	const std::string &script,
+	std::int64_t us )
+{
+	// Nested calls (a signal handler calling fe.layout.redraw()) are
+	// already included in the time of the outer call
+	if ( --m_depth <= 0 )
+	{
+		m_depth = 0;
+		m_current_us += us;
+	}
+
+	std::string key = typeStrings[t];
+	key += ':';
+	key += script;
+	key += ':';
+	key += name;
+
+	int idx;
+	std::map<std::string, int>::iterator itr = m_lookup.find( key );
+	if ( itr == m_lookup.end() )
+	{
+		idx = (int)m_entries.size();
+		m_entries.push_back( Entry() );
+		m_entries[idx].type = t;
+		m_entries[idx].name = name;
+		m_entries[idx].script = script;
+		m_lookup[ key ] = idx;
+	}
+	else
+		idx = (*itr).second;
+
+	const float ms = us / 1000.f;
+	Entry &e = m_entries[idx];
+	e.min = ( e.calls == 0 ) ? ms : std::min( e.min, ms );
+	e.max = ( e.calls == 0 ) ? ms : std::max( e.max, ms );
+	e.total += ms;
+	e.calls++;
+	e.samples.add( ms );
+}
+
+void FeScriptProfiler::end_frame()
+{
+	if ( !m_enabled )
+		return;
+
+	SQUnsignedInteger count, size;
+	sq_getallocstats( &count, &size );
+
+	m_frame_time.add( m_current_us / 1000.f, m_frames );
+	m_frame_allocs.add( (float)( count - m_alloc_count ), m_frames );
+	m_frame_alloc_kb.add( ( size - m_alloc_size ) / 1024.f, m_frames );
+	m_frames++;
+
+	m_current_us = 0;
+	m_alloc_count = count;
+	m_alloc_size = size;
+}
+
+const FeScriptProfiler::Entry *FeScriptProfiler::get_entry( int pos ) const
+{
+	if (( pos < 0 ) || ( pos >= (int)m_entries.size() ))
+		return NULL;
+
+	return &m_entries[pos];
+}
+
+const char *FeScriptProfiler::get_type_at( int pos ) const
+{
+	const Entry *e = get_entry( pos );
+	return e ? typeStrings[ e->type ] : "";
+}
+
+const char *FeScriptProfiler::get_name_at( int pos ) const
+{
+	const Entry *e = get_entry( pos );
+	return e ? e->name.c_str() : "";
+}
+
+const char *FeScriptProfiler::get_script_at( int pos ) const
+{
+	const Entry *e = get_entry( pos );
+	return e ? e->script.c_str() : "";
+}
+
+int FeScriptProfiler::get_calls_at( int pos ) const
+{
+	const Entry *e = get_entry( pos );
+	return e ? e->calls : 0;
+}
+
+float FeScriptProfiler::get_min_at( int pos ) const
+{
+	const Entry *e = get_entry( pos );
+	return e ? e->min : 0.f;
+}
+
+float FeScriptProfiler::get_avg_at( int pos ) const
+{
+	const Entry *e = get_entry( pos );
+	return ( e && e->calls ) ? (float)( e->total / e->calls ) : 0.f;
+}
+
+float FeScriptProfiler::get_p99_at( int pos ) const
+{
+	const Entry *e = get_entry( pos );
+	return e ? e->samples.percentile( 0.99f ) : 0.f;
+}
+
+float FeScriptProfiler::get_max_at( int pos ) const
+{
+	const Entry *e = get_entry( pos );
+	return e ? e->max : 0.f;
+}
+
+float FeScriptProfiler::get_frame_avg() const
+{
+	return m_frames ? (float)( m_frame_time.total / m_frames ) : 0.f;
+}
+
+float FeScriptProfiler::get_frame_p99() const
+{
+	return m_frame_time.samples.percentile( 0.99f );
+}
+
+float FeScriptProfiler::get_frame_allocs() const
+{
+	return m_frames ? (float)( m_frame_allocs.total / m_frames ) : 0.f;
+}
+
+float FeScriptProfiler::get_frame_alloc_kb() const
+{
+	return m_frames ? (float)( m_frame_alloc_kb.total / m_frames ) : 0.f;
+}
+
+bool FeScriptProfiler::dump( const char *filename ) const
+{
+	std::string fn = clean_path( filename );
+	nowide::ofstream out( fn.c_str() );
+	if ( !out.is_open() )
+	{
+		FeLog() << "Error writing script profile: " << fn << std::endl;
+		return false;
+	}
+
+	const char *frame_names[] = { "frame_time", "frame_allocs", "frame_alloc_kb" };
+	const FrameStat *frame_stats[] = { &m_frame_time, &m_frame_allocs, &m_frame_alloc_kb };
+
+	if ( tail_compare( fn, ".json" ) )
+	{
+		rapidjson::StringBuffer sb;
+		rapidjson::PrettyWriter<rapidjson::StringBuffer> w( sb );
+
+		w.StartObject();
+		w.Key( "frames" );
+		w.Int( m_frames );
+
+		for ( int i=0; i<3; i++ )
+		{
+			const FrameStat &f = *frame_stats[i];
+			w.Key( frame_names[i] );
+			w.StartObject();
+			w.Key( "min" ); w.Double( f.min );
+			w.Key( "avg" ); w.Double( m_frames ? f.total / m_frames : 0.0 );
+			w.Key( "p99" ); w.Double( f.samples.percentile( 0.99f ) );
+			w.Key( "max" ); w.Double( f.max );
+			w.EndObject();
+		}
+
+		w.Key( "functions" );
+		w.StartArray();
+		for ( int i=0; i<(int)m_entries.size(); i++ )
+		{
+			const Entry &e = m_entries[i];
+			w.StartObject();
+			w.Key( "type" ); w.String( typeStrings[e.type] );
+			w.Key( "script" ); w.String( e.script.c_str() );
+			w.Key( "function" ); w.String( e.name.c_str() );
+			w.Key( "calls" ); w.Int( e.calls );
+			w.Key( "total_ms" ); w.Double( e.total );
+			w.Key( "min_ms" ); w.Double( e.min );
+			w.Key( "avg_ms" ); w.Double( get_avg_at( i ) );
+			w.Key( "p99_ms" ); w.Double( get_p99_at( i ) );
+			w.Key( "max_ms" ); w.Double( e.max );
+			w.EndObject();
+		}
+		w.EndArray();
+		w.EndObject();
+
+		out << sb.GetString() << std::endl;
+	}
+	else
+	{
+		//
+		// Frame rows have the frame count in the calls column, and their
+		// min/avg/p99/max values are per frame in the units of their name
+		//
+		out << "type,script,function,calls,total_ms,min_ms,avg_ms,p99_ms,max_ms" << std::endl;
+
+		for ( int i=0; i<3; i++ )
+		{
+			const FrameStat &f = *frame_stats[i];
+			out << frame_names[i] << ",,," << m_frames << "," << f.total
+				<< "," << f.min << "," << ( m_frames ? f.total / m_frames : 0.0 )
+				<< "," << f.samples.percentile( 0.99f ) << "," << f.max << std::endl;
+		}
+
+		for ( int i=0; i<(int)m_entries.size(); i++ )
+		{
+			const Entry &e = m_entries[i];
+			out << typeStrings[e.type] << ",\"" << e.script << "\",\"" << e.name << "\","
+				<< e.calls << "," << e.total << "," << e.min << "," << get_avg_at( i )
+				<< "," << get_p99_at( i ) << "," << e.max << std::endl;
+		}
+	}
+
+	FeLog() << "Wrote script profile: " << fn << std::endl;
+	return true;
+}
+
+FeProfileTimer::FeProfileTimer( FeScriptProfiler::Type t,
+	const std::string &name,
+	const std::string &script )
+	: m_type( t ),
+	m_active( FeScriptProfiler::get_ref().is_enabled() )
+{
+	if ( m_active )
+	{
+		m_name = name;
+		m_script = script;
+		FeScriptProfiler::get_ref().begin_call();
+		m_start = std::chrono::steady_clock::now();
+	}
+}
+
+FeProfileTimer::FeProfileTimer( FeScriptProfiler::Type t,
+	const std::string &name )
+	: FeProfileTimer( t, name, NO_SCRIPT )
+{
+}
+
+FeProfileTimer::~FeProfileTimer()
+{
+	if ( !m_active )
+		return;
+
+	std::int64_t us = std::chrono::duration_cast<std::chrono::microseconds>(
+		std::chrono::steady_clock::now() - m_start ).count();
+
+	FeScriptProfiler::get_ref().end_call( m_type, m_name, m_script, us );
+}
@@ -0,0 +1,176 @@
+/*
+ *
+ *  Attract-Mode Plus frontend
+ *  Copyright (C) 2025 Andrew Mickelson & Radek Dutkiewicz
+ *
+ *  This file is part of Attract-Mode Plus
+ *
+ *  Attract-Mode Plus is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Attract-Mode Plus is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Attract-Mode Plus.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef FE_PROFILER_HPP
+#define FE_PROFILER_HPP
+
+#include <string>
+#include <vector>
+#include <map>
+#include <chrono>
+#include <cstdint>
+
+//
+// Records the time spent in each script tick, transition, signal handler
+// and magic string function, along with the script time and Squirrel
+// allocations per frame.
+//
+// Profiling is off until enabled from a script or with the --profile
+// command line option.  When off, timing a call is a single flag check.
+//
+class FeScriptProfiler
+{
+public:
+	enum Type
+	{
+		Tick=0,
+		Transition,
+		Signal,
+		Magic,
+		TypeCount
+	};
+
+	static const char *typeStrings[];
+
+	static FeScriptProfiler &get_ref();
+
+	bool is_enabled() const { return m_enabled; };
+	void set_enabled( bool e );
+
+	// Write the results to this file when the frontend exits
+	void set_output( const std::string &filename ) { m_output = filename; };
+	const std::string &get_output() const { return m_output; };
+
+	void reset();
+
+	// Record a call, times are in microseconds
+	void begin_call();
+	void end_call( Type t, const std::string &name, const std::string &script,
+		std::int64_t us );
+
+	// Close the current frame, call once per frame
+	void end_frame();
+
+	// Write the results as JSON if the filename ends in ".json", otherwise as CSV
+	bool dump( const char *filename ) const;
+
+	//
+	// Script access to the results.  Times are in milliseconds
+	//
+	int get_count() const { return (int)m_entries.size(); };
+	const char *get_type_at( int pos ) const;
+	const char *get_name_at( int pos ) const;
+	const char *get_script_at( int pos ) const;
+	int get_calls_at( int pos ) const;
+	float get_min_at( int pos ) const;
+	float get_avg_at( int pos ) const;
+	float get_p99_at( int pos ) const;
+	float get_max_at( int pos ) const;
+
+	int get_frames() const { return m_frames; };
+	float get_frame_avg() const;
+	float get_frame_p99() const;
+	float get_frame_allocs() const; // average Squirrel allocations per frame
+	float get_frame_alloc_kb() const; // average KB allocated by Squirrel per frame
+
+private:
+	FeScriptProfiler();
+	FeScriptProfiler( const FeScriptProfiler & );
+	FeScriptProfiler &operator=( const FeScriptProfiler & );
+
+	// A fixed number of recent samples are kept for percentiles
+	struct Samples
+	{
+		std::vector<float> values;
+		size_t next=0;
+
+		void add( float v );
+		float percentile( float p ) const;
+	};
+
+	struct Entry
+	{
+		int type=0;
+		std::string name;
+		std::string script;
+		int calls=0;
+		double total=0.0;
+		float min=0.f;
+		float max=0.f;
+		Samples samples;
+	};
+
+	struct FrameStat
+	{
+		double total=0.0;
+		float min=0.f;
+		float max=0.f;
+		Samples samples;
+
+		void add( float v, int frames );
+	};
+
+	const Entry *get_entry( int pos ) const;
+
+	std::vector<Entry> m_entries;
+	std::map<std::string, int> m_lookup;
+
+	FrameStat m_frame_time; // ms of script time
+	FrameStat m_frame_allocs;
+	FrameStat m_frame_alloc_kb;
+	int m_frames;
+
+	std::int64_t m_current_us;
+	std::uint64_t m_alloc_count;
+	std::uint64_t m_alloc_size;
+	int m_depth;
+	bool m_enabled;
+	std::string m_output;
+};
+
+//
+// Times a script call for the profiler, for as long as it is in scope
+//
+class FeProfileTimer
+{
+public:
+	FeProfileTimer( FeScriptProfiler::Type t,
+		const std::string &name,
+		const std::string &script );
+	FeProfileTimer( FeScriptProfiler::Type t,
+		const std::string &name );
+	~FeProfileTimer();
+
+private:
+	FeProfileTimer( const FeProfileTimer & );
+	FeProfileTimer &operator=( const FeProfileTimer & );
+
+	// Copies, the callback being timed may remove itself from the list
+	// that holds its name
+	FeScriptProfiler::Type m_type;
+	std::string m_name;
+	std::string m_script;
+	std::chrono::steady_clock::time_point m_start;
+	bool m_active;
+};
+
+#endif
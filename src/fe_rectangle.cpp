@@ -70,7 +70,7 @@ void FeRectangle::setPosition( const sf::Vector2f &p )
 	{
 		m_position = p;
 		scale();
-		FePresent::script_flag_redraw();
+		flag_redraw();
 	}
 }
 
@@ -85,7 +85,7 @@ void FeRectangle::setSize( const sf::Vector2f &s )
 	{
 		m_size = s;
 		scale();
-		FePresent::script_flag_redraw();
+		flag_redraw();
 	}
 }
 
@@ -100,7 +100,7 @@ void FeRectangle::setRotation( float r )
 	{
 		m_rotation = r;
 		scale();
-		FePresent::script_flag_redraw();
+		flag_redraw();
 	}
 }
 
@@ -120,7 +120,7 @@ void FeRectangle::setColor( sf::Color c )
 		return;
 
 	m_rect.setFillColor( c );
-	FePresent::script_flag_redraw();
+	flag_redraw();
 }
 
 void FeRectangle::setOutlineColor( sf::Color c )
@@ -129,7 +129,7 @@ void FeRectangle::setOutlineColor( sf::Color c )
 		return;
 
 	m_rect.setOutlineColor( c );
-	FePresent::script_flag_redraw();
+	flag_redraw();
 }
 
 float FeRectangle::get_outline()
@@ -142,7 +142,7 @@ void FeRectangle::set_outline( float o )
 	if ( o != m_rect.getOutlineThickness() )
 	{
 		m_rect.setOutlineThickness( o );
-		FePresent::script_flag_redraw();
+		flag_redraw();
 	}
 }
 
@@ -249,7 +249,7 @@ void FeRectangle::set_origin_x( float x )
 	{
 		m_origin.x = x;
 		scale();
-		FePresent::script_flag_redraw();
+		flag_redraw();
 	}
 }
 
@@ -259,7 +259,7 @@ void FeRectangle::set_origin_y( float y )
 	{
 		m_origin.y = y;
 		scale();
-		FePresent::script_flag_redraw();
+		flag_redraw();
 	}
 }
 
@@ -269,7 +269,7 @@ void FeRectangle::set_anchor( float x, float y )
 	{
 		m_anchor = sf::Vector2f( x, y );
 		scale();
-		FePresent::script_flag_redraw();
+		flag_redraw();
 	}
 }
 
@@ -286,7 +286,7 @@ void FeRectangle::set_rotation_origin( float x, float y )
 	{
 		m_rotation_origin = sf::Vector2f( x, y );
 		scale();
-		FePresent::script_flag_redraw();
+		flag_redraw();
 	}
 }
 
@@ -303,7 +303,7 @@ void FeRectangle::set_anchor_x( float x )
 	{
 		m_anchor.x = x;
 		scale();
-		FePresent::script_flag_redraw();
+		flag_redraw();
 	}
 }
 
@@ -313,7 +313,7 @@ void FeRectangle::set_anchor_y( float y )
 	{
 		m_anchor.y = y;
 		scale();
-		FePresent::script_flag_redraw();
+		flag_redraw();
 	}
 }
 
@@ -323,7 +323,7 @@ void FeRectangle::set_rotation_origin_x( float x )
 	{
 		m_rotation_origin.x = x;
 		scale();
-		FePresent::script_flag_redraw();
+		flag_redraw();
 	}
 }
 
@@ -333,7 +333,7 @@ void FeRectangle::set_rotation_origin_y( float y )
 	{
 		m_rotation_origin.y = y;
 		scale();
-		FePresent::script_flag_redraw();
+		flag_redraw();
 	}
 }
 
@@ -345,6 +345,7 @@ int FeRectangle::get_blend_mode() const
 void FeRectangle::set_blend_mode( int b )
 {
 	m_blend_mode = (FeBlend::Mode)b;
+	flag_redraw();
 }
 
 float FeRectangle::get_corner_radius() const
@@ -494,6 +495,8 @@ void FeRectangle::update_corner_points()
 		m_corner_point_actual = n;
 		m_rect.setCornerPointCount( m_corner_point_actual );
 	}
+
+	flag_redraw();
 }
 
 void FeRectangle::update_corner_radius()
@@ -30,6 +30,9 @@
 #include <algorithm>
 #include <numeric>
 #include <random>
+#include <thread>
+#include <cstring>
+#include <iomanip>
 
 #include <squirrel.h>
 #include <sqstdstring.h>
@@ -49,7 +52,81 @@ namespace
 	{
 		return r.get_info( FeRomInfo::Cloneof ).empty();
 	}
-};
+
+	const size_t ROMLIST_MIN_CHUNK = 256 * 1024; // smallest romlist chunk worth its own thread
+	const int DEBUG_MAX_LINES = 20;
+
+	bool is_space( char c )
+	{
+		return ( c == ' ' ) || ( c == '\t' ) || ( c == '\r' );
+	}
+}
+
+void romlist_chunk_bounds(
+	const char *data,
+	size_t size,
+	size_t chunks,
+	std::vector<size_t> &bounds )
+{
+	// Each boundary is moved forward to the start of a line
+	bounds.assign( chunks + 1, size );
+	bounds[0] = 0;
+	for ( size_t i=1; i<chunks; i++ )
+	{
+		size_t b = std::max( bounds[i-1], size / chunks * i );
+		const char *nl = ( b < size )
+			? static_cast<const char *>( memchr( data + b, '\n', size - b ))
+			: NULL;
+		bounds[i] = nl ? nl - data + 1 : size;
+	}
+}
+
+void parse_romlist_chunk(
+	const char *data,
+	size_t start,
+	size_t end,
+	std::vector<FeRomInfo> &roms,
+	const char *debug_name )
+{
+	std::string setting;
+	int count = 0;
+
+	while ( start < end )
+	{
+		const char *line = data + start;
+		const char *nl = static_cast<const char *>( memchr( line, '\n', end - start ));
+		size_t len = nl ? nl - line : end - start;
+		start += len + 1;
+
+		size_t pos = 0;
+		token_helper( line, len, pos, setting, ";" );
+
+		// Skip if empty or comment
+		if ( setting.empty() || ( setting[0] == '#' ))
+			continue;
+
+		// The value is the rest of the line, trimmed of whitespace
+		while (( pos < len ) && is_space( line[pos] ))
+			pos++;
+
+		size_t value_end = len;
+		while (( value_end > pos ) && is_space( line[value_end - 1] ))
+			value_end--;
+
+		size_t value_len = ( pos < value_end ) ? value_end - pos : 0;
+
+		if ( debug_name && ( count <= DEBUG_MAX_LINES ))
+		{
+			FeDebug() << "[" << debug_name << "] " << std::setw(15) << std::left << setting
+				<< " = " << std::string( line + pos, value_len ) << std::endl;
+			if ( ++count > DEBUG_MAX_LINES )
+				FeDebug() << "[" << debug_name << "] DEBUG_MAX_LINES exceeded, truncating further debug output from this file." << std::endl;
+		}
+
+		roms.emplace_back( setting );
+		roms.back().load_fields( line + pos, value_len );
+	}
+}
 
 void FeRomListSorter::init_title_rex( const std::string &re_mask )
 {
@@ -122,13 +199,194 @@ const char FeRomListSorter::get_first_letter( const FeRomInfo *one_info )
 	return title.empty() ? '0' : std::tolower( title.at( 0 ) );
 }
 
+namespace
+{
+	unsigned int get_trigram( const std::string &s, size_t pos )
+	{
+		return ( (unsigned char)s[pos] << 16 )
+			| ( (unsigned char)s[pos+1] << 8 )
+			| (unsigned char)s[pos+2];
+	}
+
+	bool is_letter( char c )
+	{
+		return std::isalpha( (unsigned char)c );
+	}
+}
+
+FeFilterNav::FeFilterNav()
+	: m_letters_built( false ),
+	m_favs_built( false ),
+	m_titles_built( false )
+{
+}
+
+void FeFilterNav::clear()
+{
+	m_run_start.clear();
+	m_run_letter.clear();
+	m_trigrams.clear();
+	m_letters_built = false;
+	m_titles_built = false;
+	clear_favs();
+}
+
+void FeFilterNav::clear_favs()
+{
+	m_favs.clear();
+	m_favs_built = false;
+}
+
+void FeFilterNav::build_letters( const std::vector<FeRomInfo*> &list )
+{
+	FeRomListSorter s;
+	for ( int i=0; i < (int)list.size(); i++ )
+	{
+		const char l = s.get_first_letter( list[i] );
+		if ( m_run_letter.empty() || ( m_run_letter.back() != l ))
+		{
+			m_run_start.push_back( i );
+			m_run_letter.push_back( l );
+		}
+	}
+
+	m_letters_built = true;
+}
+
+void FeFilterNav::build_favs( const std::vector<FeRomInfo*> &list )
+{
+	for ( int i=0; i < (int)list.size(); i++ )
+	{
+		if ( list[i]->get_info( FeRomInfo::Favourite ).compare( "1" ) == 0 )
+			m_favs.push_back( i );
+	}
+
+	m_favs_built = true;
+}
+
+void FeFilterNav::build_titles( const std::vector<FeRomInfo*> &list )
+{
+	for ( int i=0; i < (int)list.size(); i++ )
+	{
+		const std::string &title = list[i]->get_info( FeRomInfo::Title );
+		for ( size_t j=0; j + 3 <= title.size(); j++ )
+		{
+			std::vector<int> &positions = m_trigrams[ get_trigram( title, j ) ];
+			if ( positions.empty() || ( positions.back() != i ))
+				positions.push_back( i );
+		}
+	}
+
+	m_titles_built = true;
+}
+
+int FeFilterNav::get_next_letter( const std::vector<FeRomInfo*> &list, int idx, int step )
+{
+	if (( idx < 0 ) || ( idx >= (int)list.size() ))
+		return idx;
+
+	if ( !m_letters_built )
+		build_letters( list );
+
+	int runs = m_run_start.size();
+	int run = std::upper_bound( m_run_start.begin(), m_run_start.end(), idx ) - m_run_start.begin() - 1;
+	const char curr_l = m_run_letter[run];
+	bool is_alpha = is_letter( curr_l );
+
+	// Runs are the longest they can be, so the first entry reached in each
+	// run is the only one that needs testing
+	for ( int i=1; i < runs; i++ )
+	{
+		int r = ( step > 0 ) ? ( run + i ) % runs : ( run - i + runs ) % runs;
+		const char test_l = m_run_letter[r];
+
+		if ((( is_alpha ) && ( test_l != curr_l ))
+				|| ((!is_alpha) && ( is_letter( test_l ) )))
+		{
+			if ( step > 0 )
+				return m_run_start[r];
+
+			return ( r + 1 < runs ) ? m_run_start[r+1] - 1 : (int)list.size() - 1;
+		}
+	}
+
+	return idx;
+}
+
+int FeFilterNav::get_next_fav( const std::vector<FeRomInfo*> &list, int idx, int step )
+{
+	if ( !m_favs_built )
+		build_favs( list );
+
+	if ( m_favs.empty() )
+		return idx;
+
+	int retval;
+	if ( step > 0 )
+	{
+		std::vector<int>::iterator itr = std::upper_bound( m_favs.begin(), m_favs.end(), idx );
+		retval = ( itr == m_favs.end() ) ? m_favs.front() : *itr;
+	}
+	else
+	{
+		std::vector<int>::iterator itr = std::lower_bound( m_favs.begin(), m_favs.end(), idx );
+		retval = ( itr == m_favs.begin() ) ? m_favs.back() : *(itr - 1);
+	}
+
+	return retval;
+}
+
+void FeFilterNav::search( const std::vector<FeRomInfo*> &list,
+	const FeRule &rule,
+	std::vector<FeRomInfo*> &result )
+{
+	const std::string text = rule.get_required_text();
+
+	if (( rule.get_target() != FeRomInfo::Title ) || ( text.size() < 3 ))
+	{
+		for ( std::vector<FeRomInfo*>::const_iterator itr = list.begin(); itr != list.end(); ++itr )
+		{
+			if ( rule.apply_rule( **itr ) )
+				result.push_back( *itr );
+		}
+		return;
+	}
+
+	if ( !m_titles_built )
+		build_titles( list );
+
+	// Only titles containing every trigram of text can match, so test the
+	// titles with its least common trigram
+	const std::vector<int> *candidates = NULL;
+	for ( size_t i=0; i + 3 <= text.size(); i++ )
+	{
+		std::unordered_map<unsigned int, std::vector<int>>::const_iterator itr = m_trigrams.find( get_trigram( text, i ) );
+		if ( itr == m_trigrams.end() )
+			return;
+
+		if ( !candidates || ( (*itr).second.size() < candidates->size() ))
+			candidates = &(*itr).second;
+	}
+
+	for ( std::vector<int>::const_iterator itr = candidates->begin(); itr != candidates->end(); ++itr )
+	{
+		if ( rule.apply_rule( *list[*itr] ))
+			result.push_back( list[*itr] );
+	}
+}
+
 FeRomList::FeRomList( const std::string &config_path )
-	: m_config_path( config_path ),
+	: m_global_filter_ptr( NULL ),
+	m_config_path( config_path ),
 	m_fav_changed( false ),
 	m_tags_changed( false ),
 	m_availability_checked( false ),
 	m_played_stats_checked( false ),
-	m_group_clones( false )
+	m_group_clones( false ),
+	m_comparisons( 0 ),
+	m_pending_count( 0 ),
+	m_pending_displays( NULL ),
+	m_pending_display_idx( -1 )
 {
 }
 
@@ -142,6 +400,7 @@ void FeRomList::init_as_empty_list()
 	m_list.clear();
 	m_filtered_list.clear();
 	m_filtered_list.push_back( FeFilterEntry() ); // there always has to be at least one filter
+	clear_pending();
 	m_tags.clear();
 	m_extra_favs.clear();
 	m_extra_tags.clear();
@@ -153,6 +412,65 @@ void FeRomList::init_as_empty_list()
 	m_tags_changed = false;
 }
 
+void FeRomList::swap( FeRomList &other )
+{
+	// std::list and std::vector swaps keep their elements in place, so the
+	// filter entry pointers into m_list stay valid
+	m_list.swap( other.m_list );
+	m_filtered_list.swap( other.m_filtered_list );
+	m_tags.swap( other.m_tags );
+	m_extra_favs.swap( other.m_extra_favs );
+	m_extra_tags.swap( other.m_extra_tags );
+	m_romlist_path.swap( other.m_romlist_path );
+	m_romlist_name.swap( other.m_romlist_name );
+
+	std::swap( m_global_filter_ptr, other.m_global_filter_ptr );
+	std::swap( m_fav_changed, other.m_fav_changed );
+	std::swap( m_tags_changed, other.m_tags_changed );
+	std::swap( m_availability_checked, other.m_availability_checked );
+	std::swap( m_played_stats_checked, other.m_played_stats_checked );
+	std::swap( m_group_clones, other.m_group_clones );
+	std::swap( m_comparisons, other.m_comparisons );
+
+	m_filter_pending.swap( other.m_filter_pending );
+	m_pending_lookup.swap( other.m_pending_lookup );
+	std::swap( m_pending_count, other.m_pending_count );
+	std::swap( m_pending_displays, other.m_pending_displays );
+	std::swap( m_pending_display_idx, other.m_pending_display_idx );
+	m_pending_display_name.swap( other.m_pending_display_name );
+}
+
+size_t FeRomList::get_memory_size() const
+{
+	// Strings short enough for the small string buffer have no allocation
+	const size_t sso = sizeof( std::string );
+
+	size_t size = 0;
+	for ( FeRomInfoListType::const_iterator itr = m_list.begin(); itr != m_list.end(); ++itr )
+	{
+		size += sizeof( FeRomInfo ) + 2 * sizeof( void * )
+			+ FeRomInfo::LAST_INDEX * sizeof( std::string );
+
+		for ( int i=0; i<FeRomInfo::LAST_INDEX; i++ )
+		{
+			const std::string &s = (*itr).get_info( i );
+			if ( s.capacity() >= sso )
+				size += s.capacity() + 1;
+		}
+	}
+
+	for ( std::vector<FeFilterEntry>::const_iterator itr = m_filtered_list.begin(); itr != m_filtered_list.end(); ++itr )
+	{
+		size += (*itr).filter_list.capacity() * sizeof( FeRomInfo * );
+
+		for ( std::map<std::string, std::vector<FeRomInfo*>>::const_iterator itg = (*itr).clone_group.begin();
+				itg != (*itr).clone_group.end(); ++itg )
+			size += sizeof( *itg ) + (*itg).first.capacity() + (*itg).second.capacity() * sizeof( FeRomInfo * );
+	}
+
+	return size;
+}
+
 void FeRomList::mark_favs_and_tags_changed()
 {
 	m_fav_changed = true;
@@ -232,7 +550,7 @@ int FeRomList::load_romlist_data(
 	FeCache::save_display( display, *this );
 
 	// Load romlist from file
-	if ( !FeBaseConfigurable::load_from_file( m_romlist_path, ";" ) )
+	if ( !load_romlist_file( m_romlist_path ) )
 		return RomlistResponse::Loaded_None;
 
 	// If grouping by clones, partition the list so masters are ordered before clones
@@ -245,6 +563,52 @@ int FeRomList::load_romlist_data(
 		: RomlistResponse::Loaded_File;
 }
 
+//
+// Append the roms in a romlist file to m_list
+// - The file is memory mapped and split at line boundaries into chunks
+//   that are parsed in parallel, then appended in file order
+//
+bool FeRomList::load_romlist_file( const std::string &filename )
+{
+	FeMappedFile file;
+	if ( !file.open( filename ))
+		return false;
+
+	const char *data = file.data();
+	size_t size = file.size();
+
+	size_t chunks = std::max( (size_t)1, size / ROMLIST_MIN_CHUNK );
+	size_t threads = std::thread::hardware_concurrency();
+	if ( threads > 0 )
+		chunks = std::min( chunks, threads );
+
+	std::vector<size_t> bounds;
+	romlist_chunk_bounds( data, size, chunks, bounds );
+
+	std::vector< std::vector<FeRomInfo> > results( chunks );
+	std::vector<std::thread> workers;
+
+	for ( size_t i=1; i<chunks; i++ )
+		workers.emplace_back( parse_romlist_chunk, data, bounds[i], bounds[i+1], std::ref( results[i] ), (const char *)NULL );
+
+	parse_romlist_chunk( data, bounds[0], bounds[1], results[0], filename.c_str() );
+
+	for ( std::vector<std::thread>::iterator itr = workers.begin(); itr != workers.end(); ++itr )
+		(*itr).join();
+
+	for ( size_t i=0; i<chunks; i++ )
+	{
+		for ( std::vector<FeRomInfo>::iterator itr = results[i].begin(); itr != results[i].end(); ++itr )
+		{
+			(*itr).index = m_list.size(); // index for filter cache
+			m_list.push_back( std::move( *itr ));
+		}
+		std::vector<FeRomInfo>().swap( results[i] );
+	}
+
+	return true;
+}
+
 //
 // Used during load_from_file to append rom to m_list
 //
@@ -454,6 +818,7 @@ bool FeRomList::load_romlist(
 	m_played_stats_checked = !load_stats;
 	m_list.clear();
 	m_filtered_list.clear();
+	clear_pending();
 
 	sf::Clock load_timer;
 
@@ -528,6 +893,39 @@ inline void FeRomList::add_group_entry(
 	itg->second.push_back( &rom );
 }
 
+int FeRomList::get_next_letter_index( int filter_idx, int idx, int step )
+{
+	ensure_filter( filter_idx );
+
+	if ( filter_idx >= (int)m_filtered_list.size() )
+		return idx;
+
+	FeFilterEntry &entry = m_filtered_list[filter_idx];
+	return entry.nav.get_next_letter( entry.filter_list, idx, step );
+}
+
+int FeRomList::get_next_fav_index( int filter_idx, int idx, int step )
+{
+	ensure_filter( filter_idx );
+
+	if ( filter_idx >= (int)m_filtered_list.size() )
+		return idx;
+
+	FeFilterEntry &entry = m_filtered_list[filter_idx];
+	return entry.nav.get_next_fav( entry.filter_list, idx, step );
+}
+
+void FeRomList::search( int filter_idx, const FeRule &rule, std::vector<FeRomInfo*> &result )
+{
+	ensure_filter( filter_idx );
+
+	if ( filter_idx >= (int)m_filtered_list.size() )
+		return;
+
+	FeFilterEntry &entry = m_filtered_list[filter_idx];
+	entry.nav.search( entry.filter_list, rule, result );
+}
+
 //
 // Apply the given filter to populate the filter_list and clone_group
 //
@@ -650,8 +1048,30 @@ void FeRomList::get_clone_group(
 	}
 }
 
+void FeRomList::create_filters( FeDisplayInfo &display )
+{
+	internal_create_filters( display, -1 );
+}
+
 void FeRomList::create_filters(
-	FeDisplayInfo &display )
+	std::vector<FeDisplayInfo> &displays,
+	int display_idx,
+	int first_filter )
+{
+	if ( internal_create_filters( displays[display_idx], first_filter ))
+	{
+		m_pending_displays = &displays;
+		m_pending_display_idx = display_idx;
+		m_pending_display_name = displays[display_idx].get_name();
+	}
+}
+
+//
+// Returns true if filters other than first_filter were left pending
+//
+bool FeRomList::internal_create_filters(
+	FeDisplayInfo &display,
+	int first_filter )
 {
 	// create_filters may be called by update_romlist_after_edit
 	// - we must validate AGAIN to clear any filters the rom may now appear in
@@ -659,11 +1079,11 @@ void FeRomList::create_filters(
 	FeCache::validate_display( display, *this );
 
 	sf::Clock load_timer;
+	clear_pending();
 
 	// Prepare an indexed lookup for filter cache loading
 	std::map<int, FeRomInfo*> lookup;
-	for ( FeRomInfoListType::iterator it=m_list.begin(); it!=m_list.end(); ++it )
-		lookup[it->index] = &(*it);
+	build_lookup( lookup );
 
 	// If no filters configured create a single filter containing entire romlist
 	int filters_count = std::max( display.get_filter_count(), 1 );
@@ -672,21 +1092,32 @@ void FeRomList::create_filters(
 
 	// Apply filters
 	m_filtered_list.clear();
-	m_filtered_list.reserve( filters_count );
-	for ( int i=0; i<filters_count; i++ )
-	{
-		m_filtered_list.push_back( FeFilterEntry() );
+	m_filtered_list.resize( filters_count );
 
-		// Attempt to load filter from cache
-		if ( FeCache::load_filter( display, m_filtered_list[i], i, lookup ) )
-		{
+	// Only build the first filter now, the others are built later
+	if (( first_filter >= 0 ) && ( first_filter < filters_count ) && ( filters_count > 1 ))
+	{
+		if ( load_or_build_filter( display, first_filter, lookup ) )
 			filters_cached++;
-			continue;
-		}
 
-		// If no cache, build and save the filter from scratch
-		build_single_filter_list( display.get_filter( i ), m_filtered_list[i] );
-		FeCache::save_filter( display, m_filtered_list[i], i );
+		m_filter_pending.assign( filters_count, true );
+		m_filter_pending[first_filter] = false;
+		m_pending_count = filters_count - 1;
+		m_pending_lookup.swap( lookup );
+
+		FeLog() << " - Loaded filter in "
+			<< load_timer.getElapsedTime().asMilliseconds() << " ms ("
+			<< filters_cached << " from cache, "
+			<< m_comparisons << " comparisons, "
+			<< m_pending_count << " filters pending"
+			<< ")" << std::endl;
+		return true;
+	}
+
+	for ( int i=0; i<filters_count; i++ )
+	{
+		if ( load_or_build_filter( display, i, lookup ) )
+			filters_cached++;
 	}
 
 	FeLog() << " - Loaded filters in "
@@ -695,6 +1126,105 @@ void FeRomList::create_filters(
 		<< filters_cached << " from cache, "
 		<< m_comparisons << " comparisons"
 		<< ")" << std::endl;
+	return false;
+}
+
+//
+// Load the filter from cache, or build and save it if the cache is out of date.
+// Returns true if the filter was loaded from cache
+//
+bool FeRomList::load_or_build_filter(
+	FeDisplayInfo &display,
+	int filter_idx,
+	std::map<int, FeRomInfo*> &lookup )
+{
+	if ( FeCache::load_filter( display, m_filtered_list[filter_idx], filter_idx, lookup ) )
+		return true;
+
+	build_single_filter_list( display.get_filter( filter_idx ), m_filtered_list[filter_idx] );
+	FeCache::save_filter( display, m_filtered_list[filter_idx], filter_idx );
+	return false;
+}
+
+void FeRomList::build_lookup( std::map<int, FeRomInfo*> &lookup )
+{
+	for ( FeRomInfoListType::iterator it=m_list.begin(); it!=m_list.end(); ++it )
+		lookup[it->index] = &(*it);
+}
+
+void FeRomList::clear_pending()
+{
+	m_filter_pending.clear();
+	m_pending_lookup.clear();
+	m_pending_count = 0;
+	m_pending_displays = NULL;
+	m_pending_display_idx = -1;
+	m_pending_display_name.clear();
+}
+
+FeDisplayInfo *FeRomList::get_pending_display()
+{
+	if ( !m_pending_displays )
+		return NULL;
+
+	std::vector<FeDisplayInfo> &displays = *m_pending_displays;
+	if (( m_pending_display_idx >= 0 ) && ( m_pending_display_idx < (int)displays.size() )
+			&& ( displays[m_pending_display_idx].get_name() == m_pending_display_name ))
+		return &displays[m_pending_display_idx];
+
+	for ( int i=0; i<(int)displays.size(); i++ )
+	{
+		if ( displays[i].get_name() == m_pending_display_name )
+		{
+			m_pending_display_idx = i;
+			return &displays[i];
+		}
+	}
+
+	return NULL;
+}
+
+void FeRomList::build_pending_now( int filter_idx )
+{
+	if (( filter_idx < 0 ) || !is_pending( filter_idx ))
+		return;
+
+	// The display may have been removed or had its filters changed since
+	FeDisplayInfo *display = get_pending_display();
+	if ( !display || ( filter_idx >= display->get_filter_count() ))
+	{
+		FeDebug() << "Dropped pending filters for romlist: " << m_romlist_name << std::endl;
+		clear_pending();
+		return;
+	}
+
+	if ( m_pending_lookup.empty() )
+		build_lookup( m_pending_lookup );
+
+	m_filter_pending[filter_idx] = false;
+	m_pending_count--;
+
+	load_or_build_filter( *display, filter_idx, m_pending_lookup );
+
+	if ( m_pending_count <= 0 )
+	{
+		FeDebug() << "Finished loading filters for romlist: " << m_romlist_name << std::endl;
+		clear_pending();
+	}
+}
+
+bool FeRomList::build_pending_filter()
+{
+	for ( int i=0; i<(int)m_filter_pending.size(); i++ )
+	{
+		if ( m_filter_pending[i] )
+		{
+			build_pending_now( i );
+			return true;
+		}
+	}
+
+	return false;
 }
 
 //
@@ -822,6 +1352,10 @@ bool FeRomList::set_fav( FeRomInfo &rom, FeDisplayInfo &display, bool fav )
 
 	m_fav_changed = true;
 	rom.set_info( FeRomInfo::Favourite, fav ? "1" : "" );
+
+	for ( std::vector<FeFilterEntry>::iterator itr = m_filtered_list.begin(); itr != m_filtered_list.end(); ++itr )
+		(*itr).nav.clear_favs();
+
 	return fix_filters( display, { FeRomInfo::Favourite } );
 }
 
@@ -870,7 +1404,7 @@ bool FeRomList::set_tag( FeRomInfo &rom, FeDisplayInfo &display, const std::stri
 //
 bool FeRomList::fix_filters( FeDisplayInfo &display, std::set<FeRomInfo::Index> targets )
 {
-	FeCache::invalidate_rominfo( display.get_romlist_name(), targets );
+	FeCache::invalidate_rominfo( *this, targets );
 
 	bool retval = false;
 	for ( int i=0; i<display.get_filter_count(); i++ )
@@ -878,16 +1412,125 @@ bool FeRomList::fix_filters( FeDisplayInfo &display, std::set<FeRomInfo::Index>
 		FeFilter *f = display.get_filter( i );
 		ASSERT( f );
 
-		if ( f->test_for_targets( targets ) )
+		if ( !f->test_for_targets( targets ) )
+			continue;
+
+		// Pending filters are built from the changed data anyway, so
+		// only their cache needs clearing
+		if ( is_pending( i ))
 		{
-			build_single_filter_list( f, m_filtered_list[i] );
-			retval = true;
+			FeCache::invalidate_filter( display, i );
+			continue;
 		}
+
+		build_single_filter_list( f, m_filtered_list[i] );
+		retval = true;
 	}
 
 	return retval;
 }
 
+bool FeRomList::remove_filter_entry( FeFilterEntry &entry, FeRomInfo *rom )
+{
+	std::vector<FeRomInfo*>::iterator itr = std::find( entry.filter_list.begin(), entry.filter_list.end(), rom );
+	if ( itr == entry.filter_list.end() )
+		return false;
+
+	entry.filter_list.erase( itr );
+	return true;
+}
+
+bool FeRomList::update_entry( FeDisplayInfo &display,
+	const FeRomInfo &original,
+	const FeRomInfo *replacement,
+	bool insert )
+{
+	FeRomInfoListType::iterator it;
+	for ( it = m_list.begin(); it != m_list.end(); ++it )
+	{
+		if ( (*it).full_comparison( original ) )
+			break;
+	}
+
+	if ( it == m_list.end() )
+		return false;
+
+	// As in create_filters, validate again to clear any filters the rom may now appear in
+	FeCache::validate_display( display, *this );
+
+	int filters_count = std::min( std::max( display.get_filter_count(), 1 ), (int)m_filtered_list.size() );
+	std::vector<bool> was( filters_count, false );
+	std::vector<bool> rebuild( filters_count, false );
+	FeRomInfo *rom = &(*it);
+
+	// Take the rom out of the filters it was in, before it is changed
+	for ( int i=0; i<filters_count; i++ )
+	{
+		if ( is_pending( i ))
+			continue;
+
+		FeFilter *f = display.get_filter( i );
+		if ( f ) f->init();
+
+		was[i] = !insert && ( !f || f->apply_filter( original ));
+
+		// Clone groups and list limits depend on the other roms in the filter
+		if ( was[i] && ( m_group_clones || ( f && f->get_list_limit() )))
+			rebuild[i] = true;
+		else if ( !replacement && remove_filter_entry( m_filtered_list[i], rom ))
+		{
+			if ( f ) f->set_size( m_filtered_list[i].filter_list.size() );
+		}
+	}
+
+	if ( !replacement )
+	{
+		m_list.erase( it );
+		rom = NULL;
+	}
+	else if ( insert )
+		rom = &(*m_list.insert( it, *replacement ));
+	else
+		*rom = *replacement;
+
+	// Put the rom into the filters it is now in.  Pending filters will be
+	// built from the changed list, so only their cache needs clearing
+	m_pending_lookup.clear();
+	for ( int i=0; i<filters_count; i++ )
+	{
+		if ( is_pending( i ))
+		{
+			FeCache::invalidate_filter( display, i );
+			continue;
+		}
+
+		FeFilter *f = display.get_filter( i );
+		FeFilterEntry &entry = m_filtered_list[i];
+		bool now = rom && ( !f || f->apply_filter( *rom ));
+
+		if ( !rebuild[i] && now )
+		{
+			// A new member needs sorting in, as does one whose sort value changed
+			FeRomInfo::Index sort_by = f ? f->get_sort_by() : FeRomInfo::LAST_INDEX;
+			rebuild[i] = !was[i] || (( sort_by != FeRomInfo::LAST_INDEX )
+				&& ( original.get_info( sort_by ).compare( rom->get_info( sort_by )) != 0 ));
+		}
+		else if ( !rebuild[i] && rom && remove_filter_entry( entry, rom ))
+		{
+			if ( f ) f->set_size( entry.filter_list.size() );
+		}
+
+		if ( rebuild[i] )
+			build_single_filter_list( f, entry );
+		else
+			entry.nav.clear();
+
+		FeCache::save_filter( display, entry, i );
+	}
+
+	return true;
+}
+
 //
 // Check availability of all roms in m_list
 //
@@ -1201,3 +1844,104 @@ bool FeFilterIndexes::index_to_entry(
 	return indexes_to_filter_list( m_filter_list, entry.filter_list, lookup )
 		&& indexes_to_clone_group( m_clone_group, entry.clone_group, lookup );
 }
+
+FeRomListCache::FeRomListCache( const std::string &config_path )
+	: m_config_path( config_path ),
+	m_max_size( 0 ),
+	m_size( 0 )
+{
+}
+
+void FeRomListCache::set_max_size( size_t bytes )
+{
+	m_max_size = bytes;
+	trim();
+}
+
+void FeRomListCache::store( int display, FeRomList &rl )
+{
+	for ( std::list<Entry>::iterator itr = m_entries.begin(); itr != m_entries.end(); ++itr )
+	{
+		if ( (*itr).display == display )
+		{
+			m_size -= (*itr).size;
+			m_entries.erase( itr );
+			break;
+		}
+	}
+
+	if ( m_max_size == 0 )
+		return;
+
+	m_entries.emplace_front( m_config_path );
+	Entry &e = m_entries.front();
+	e.display = display;
+	e.rl.swap( rl );
+	e.size = e.rl.get_memory_size();
+	m_size += e.size;
+
+	FeDebug() << "Cached romlist '" << e.rl.get_romlist_name() << "' for display #" << display
+		<< " (" << e.size / 1024 << " KB, cache total " << m_size / 1024 << " KB)" << std::endl;
+
+	trim();
+}
+
+bool FeRomListCache::restore( int display, FeRomList &rl )
+{
+	for ( std::list<Entry>::iterator itr = m_entries.begin(); itr != m_entries.end(); ++itr )
+	{
+		if ( (*itr).display == display )
+		{
+			rl.swap( (*itr).rl );
+			m_size -= (*itr).size;
+			m_entries.erase( itr );
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool FeRomListCache::contains( int display ) const
+{
+	for ( std::list<Entry>::const_iterator itr = m_entries.begin(); itr != m_entries.end(); ++itr )
+	{
+		if ( (*itr).display == display )
+			return true;
+	}
+
+	return false;
+}
+
+void FeRomListCache::drop_romlist( const std::string &romlist_name )
+{
+	std::list<Entry>::iterator itr = m_entries.begin();
+	while ( itr != m_entries.end() )
+	{
+		if ( (*itr).rl.get_romlist_name() == romlist_name )
+		{
+			m_size -= (*itr).size;
+			itr = m_entries.erase( itr );
+		}
+		else
+			++itr;
+	}
+}
+
+void FeRomListCache::clear()
+{
+	m_entries.clear();
+	m_size = 0;
+}
+
+void FeRomListCache::trim()
+{
+	while ( !m_entries.empty() && ( m_size > m_max_size ))
+	{
+		FeDebug() << "Dropped cached romlist '" << m_entries.back().rl.get_romlist_name()
+			<< "' for display #" << m_entries.back().display << std::endl;
+
+		m_size -= m_entries.back().size;
+		m_entries.pop_back();
+	}
+}
@@ -28,6 +28,7 @@
 #include <map>
 #include <set>
 #include <list>
+#include <unordered_map>
 
 #include "cereal/cereal.hpp"
 #include <cereal/types/list.hpp>
@@ -41,6 +42,19 @@ extern const char *FE_ROMLIST_FILE_EXTENSION;
 extern const char *FE_ROMLIST_SUBDIR;
 extern const char *FE_STATS_SUBDIR;
 
+//
+// Romlist file parsing used by FeRomList::load_romlist_file().  The file
+// data is split into "chunks" ranges that start at the beginning of a line,
+// bounds gets the chunks + 1 range edges.  Each range can then be parsed on
+// its own, giving the same roms as FeBaseConfigurable::load_from_file().
+// Lines are logged when debug_name is set
+//
+void romlist_chunk_bounds( const char *data, size_t size, size_t chunks,
+	std::vector<size_t> &bounds );
+
+void parse_romlist_chunk( const char *data, size_t start, size_t end,
+	std::vector<FeRomInfo> &roms, const char *debug_name=NULL );
+
 //
 // Comparison used when sorting/merging FeRomLists
 //
@@ -76,6 +90,46 @@ public:
 	bool operator()( const FeRomInfo *one, const FeRomInfo *two ) const { return m_sorter.operator()(*one,*two); };
 };
 
+//
+// Navigation indexes for a filtered list, used for jumping between letters
+// and favourites and for searching.  Each index is built the first time it
+// is needed, and must be cleared whenever the list it was built from changes
+//
+class FeFilterNav
+{
+private:
+	std::vector<int> m_run_start; // list position where each run of titles with the same first letter starts
+	std::vector<char> m_run_letter;
+	std::vector<int> m_favs; // list positions of favourites
+	std::unordered_map<unsigned int, std::vector<int>> m_trigrams; // title trigram to list positions
+	bool m_letters_built;
+	bool m_favs_built;
+	bool m_titles_built;
+
+	void build_letters( const std::vector<FeRomInfo*> &list );
+	void build_favs( const std::vector<FeRomInfo*> &list );
+	void build_titles( const std::vector<FeRomInfo*> &list );
+
+public:
+	FeFilterNav();
+
+	void clear();
+	void clear_favs();
+
+	// Return the position of the next title starting with a different
+	// letter in the given direction, or idx if there is none
+	int get_next_letter( const std::vector<FeRomInfo*> &list, int idx, int step );
+
+	// Return the position of the next favourite in the given direction,
+	// or idx if there is none
+	int get_next_fav( const std::vector<FeRomInfo*> &list, int idx, int step );
+
+	// Append the list entries that match rule to result, in list order
+	void search( const std::vector<FeRomInfo*> &list,
+		const FeRule &rule,
+		std::vector<FeRomInfo*> &result );
+};
+
 class FeFilterEntry
 {
 public:
@@ -83,10 +137,13 @@ public:
 	std::vector<FeRomInfo*> filter_list;
 	// If clone grouping is on, this stores each clone groups pointers
 	std::map<std::string, std::vector<FeRomInfo*>> clone_group;
+	// Navigation indexes over filter_list
+	FeFilterNav nav;
 
 	void clear() {
 		filter_list.clear();
 		clone_group.clear();
+		nav.clear();
 	};
 };
 
@@ -178,14 +235,38 @@ private:
 	bool m_group_clones;
 	int m_comparisons; // for keeping stats during load
 
+	// Filters that create_filters() has left to be built later
+	std::vector<bool> m_filter_pending;
+	int m_pending_count;
+	std::vector<FeDisplayInfo> *m_pending_displays; // config mode can add and remove displays, so the
+	int m_pending_display_idx;                       // pending display is looked up again by index and name
+	std::string m_pending_display_name;
+	std::map<int, FeRomInfo*> m_pending_lookup; // for filter cache loading, rebuilt when empty
+
 	FeRomList( const FeRomList & );
 	FeRomList &operator=( const FeRomList & );
 
 	// helper function for building a single filter's list.  Used by create_filters() and fix_filters()
 	//
 	void build_single_filter_list( FeFilter *f, FeFilterEntry &result );
+	bool load_or_build_filter( FeDisplayInfo &display, int filter_idx, std::map<int, FeRomInfo*> &lookup );
+	bool internal_create_filters( FeDisplayInfo &display, int first_filter );
+	void build_lookup( std::map<int, FeRomInfo*> &lookup );
+	void clear_pending();
+	FeDisplayInfo *get_pending_display();
+	void build_pending_now( int filter_idx );
+	bool is_pending( int filter_idx ) const { return ( filter_idx < (int)m_filter_pending.size() ) && m_filter_pending[filter_idx]; };
+
+	// Build the given filter now if it is still pending.  A pending filter is
+	// built from the same data whenever that happens, so this is logically const
+	void ensure_filter( int filter_idx ) const
+	{
+		if ( m_pending_count > 0 )
+			const_cast<FeRomList *>( this )->build_pending_now( filter_idx );
+	};
 	void build_filter_entry( FeFilter *f, FeFilterEntry &result );
 	void sort_filter_entry( FeFilter *f, FeFilterEntry &result );
+	bool remove_filter_entry( FeFilterEntry &entry, FeRomInfo *rom );
 	inline void add_group_entry(
 		FeRomInfo &rom,
 		FeFilterEntry &result
@@ -208,6 +289,7 @@ private:
 
 	void get_romlist_map( std::map<std::string, std::vector<FeRomInfo*>> &rom_map );
 	int load_romlist_data( FeDisplayInfo &display );
+	bool load_romlist_file( const std::string &filename );
 	void load_fav_data( std::map<std::string, std::vector<FeRomInfo*>> &rom_map );
 	void load_tag_data( std::map<std::string, std::vector<FeRomInfo*>> &rom_map );
 	void load_shuffle_data();
@@ -220,6 +302,13 @@ public:
 
 	void init_as_empty_list();
 
+	// Exchange the loaded list, filters, favourites and tags with "other".
+	// Emulators are shared configuration and stay where they are
+	void swap( FeRomList &other );
+
+	// Approximate memory used by the loaded list and its filters, in bytes
+	size_t get_memory_size() const;
+
 	std::string get_fav_path();
 	std::vector<std::string> get_tag_names();
 	std::string get_tag_dir();
@@ -231,7 +320,21 @@ public:
 		bool group_clones,
 		bool load_stats );
 
-	void create_filters( FeDisplayInfo &display ); // called by load_romlist()
+	// Build the filters for display
+	void create_filters( FeDisplayInfo &display );
+
+	//
+	// Build the filters for the display at display_idx in displays.  Only
+	// first_filter is built now and the rest are left pending until
+	// build_pending_filter() gets to them, or until they are used
+	//
+	void create_filters( std::vector<FeDisplayInfo> &displays, int display_idx, int first_filter );
+
+	// Build the next pending filter, returns false if there were none
+	bool build_pending_filter();
+
+	int get_pending_filters() const { return m_pending_count; };
+	int get_filter_count() const { return (int)m_filtered_list.size(); };
 
 	int process_setting( const std::string &setting,
 		const std::string &value,
@@ -244,14 +347,19 @@ public:
 	void get_tags_list( FeRomInfo &rom, std::vector< std::pair<std::string, bool> > &tags_list ) const;
 	bool set_tag( FeRomInfo &rom, FeDisplayInfo &display, const std::string &tag, bool flag );
 
-	int filter_size( int filter_idx ) const { return ( filter_idx < (int)m_filtered_list.size() ) ? (int)m_filtered_list[filter_idx].filter_list.size() : 0; };
+	int filter_size( int filter_idx ) const { ensure_filter( filter_idx ); return ( filter_idx < (int)m_filtered_list.size() ) ? (int)m_filtered_list[filter_idx].filter_list.size() : 0; };
 
 	// Return rom directly by index
-	const FeRomInfo &lookup( int filter_idx, int idx) const { return *(m_filtered_list[filter_idx].filter_list[idx]); };
-	FeRomInfo &lookup( int filter_idx, int idx) { return *(m_filtered_list[filter_idx].filter_list[idx]); };
+	const FeRomInfo &lookup( int filter_idx, int idx) const { ensure_filter( filter_idx ); return *(m_filtered_list[filter_idx].filter_list[idx]); };
+	FeRomInfo &lookup( int filter_idx, int idx) { ensure_filter( filter_idx ); return *(m_filtered_list[filter_idx].filter_list[idx]); };
 
 	void get_clone_group( int filter_idx, int idx, std::vector < FeRomInfo * > &group );
 
+	// Navigation and search using the filter's indexes, see FeFilterNav
+	int get_next_letter_index( int filter_idx, int idx, int step );
+	int get_next_fav_index( int filter_idx, int idx, int step );
+	void search( int filter_idx, const FeRule &rule, std::vector<FeRomInfo*> &result );
+
 	FeRomInfoListType &get_list() { return m_list; };
 
 	void get_file_availability( std::map<std::string, std::vector<std::string>> emu_roms = {} );
@@ -259,6 +367,18 @@ public:
 
 	void load_stats( int filter_idx, int idx );
 
+	// Apply a single entry edit to m_list and update m_filtered_list to match,
+	// only rebuilding the filters whose contents might have changed order.
+	// The entry matching "original" is erased if replacement is NULL, or
+	// replacement is inserted before it if insert is set, otherwise updated
+	//
+	// returns false if no entry matches "original"
+	//
+	bool update_entry( FeDisplayInfo &display,
+		const FeRomInfo &original,
+		const FeRomInfo *replacement,
+		bool insert );
+
 	// Fixes m_filtered_list as needed using the filters in the given "display", with the
 	// assumption that the specified "target" attribute for all games might have been changed
 	//
@@ -284,4 +404,52 @@ public:
 
 CEREAL_CLASS_VERSION( FeRomList, FE_CACHE_VERSION );
 
+//
+// Keeps the romlists of recently shown displays loaded, so switching back
+// to one is a swap rather than a reload.  Least recently used lists are
+// dropped once the cache is over its size limit
+//
+class FeRomListCache
+{
+private:
+	struct Entry
+	{
+		Entry( const std::string &config_path ) : display( -1 ), size( 0 ), rl( config_path ) {};
+
+		int display;
+		size_t size;
+		FeRomList rl;
+	};
+
+	std::list<Entry> m_entries; // most recently used first
+	const std::string &m_config_path;
+	size_t m_max_size;
+	size_t m_size;
+
+	FeRomListCache( const FeRomListCache & );
+	FeRomListCache &operator=( const FeRomListCache & );
+
+	void trim();
+
+public:
+	FeRomListCache( const std::string &config_path );
+
+	void set_max_size( size_t bytes );
+
+	// Move the contents of "rl" into the cache as the list for "display",
+	// leaving "rl" empty
+	void store( int display, FeRomList &rl );
+
+	// Move the cached list for "display" into "rl", returns false if
+	// there isn't one
+	bool restore( int display, FeRomList &rl );
+
+	bool contains( int display ) const;
+
+	// Drop any cached lists loaded from the named romlist
+	void drop_romlist( const std::string &romlist_name );
+
+	void clear();
+};
+
 #endif
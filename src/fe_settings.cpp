@@ -35,6 +35,8 @@
 #include <iomanip>
 #include <algorithm>
 #include <random>
+#include <thread>
+#include <unordered_map>
 #include <stdlib.h>
 #include <cctype>
 #include <ctime>
@@ -317,6 +319,7 @@ std::vector<std::string> FeSettings::uiColorDispTokens =
 
 FeSettings::FeSettings( const std::string &config_path )
 	:  m_rl( m_config_path ),
+	m_rl_cache( m_config_path ),
 	m_inputmap(),
 	m_saver_params( FeLayoutInfo::ScreenSaver ),
 	m_intro_params( FeLayoutInfo::Intro ),
@@ -325,6 +328,8 @@ FeSettings::FeSettings( const std::string &config_path )
 	m_current_display( -1 ),
 	m_selected_display( 0 ),
 	m_actual_display_index( 0 ),
+	m_rl_display( -1 ),
+	m_prefetch_pos( 0 ),
 	m_current_config_object( NULL ),
 	m_ssaver_time( 600 ),
 	m_last_launch_display( 0 ),
@@ -356,6 +361,7 @@ FeSettings::FeSettings( const std::string &config_path )
 	m_selection_max_step( 128 ),
 	m_selection_speed( 40 ),
 	m_image_cache_mbytes( 100 ),
+	m_romlist_cache_mbytes( 0 ),
 #ifdef SFML_SYSTEM_MACOS
 	m_move_mouse_on_launch( false ), // hotcorners
 #else
@@ -373,6 +379,7 @@ FeSettings::FeSettings( const std::string &config_path )
 #endif
 	m_power_saving( false ),
 	m_check_for_updates( true ),
+	m_release_memory_on_launch( false ),
 	m_screen_rotation( RotateNone ),
 	m_antialiasing( 0 ),
 	m_anisotropic( 0 ),
@@ -405,6 +412,8 @@ void FeSettings::clear()
 
 	m_displays.clear();
 	m_rl.clear_emulators();
+	m_rl_cache.clear();
+	m_rl_display = -1;
 	m_plugins.clear();
 }
 
@@ -518,6 +527,8 @@ const char *FeSettings::configSettingStrings[] =
 	"menu_prompt",
 	"menu_layout",
 	"image_cache_mbytes",
+	"romlist_cache_mbytes",
+	"release_memory_on_launch",
 	NULL
 };
 
@@ -678,6 +689,23 @@ void FeSettings::init_display()
 	FeLog() << std::endl << "*** Initializing display: '" << get_current_display_title() << "'" << std::endl;
 
 	m_loaded_game_extras = false;
+	m_prefetch_pos = 0;
+	m_art_cache.clear();
+
+	//
+	// Keep the romlist of the display we are leaving in the cache.  Setting the
+	// same display again is a reset, in which case its romlist is reloaded.
+	// Other displays using the same romlist are dropped from the cache, as
+	// their favourites and tags may have been changed on this one
+	//
+	if (( m_rl_display >= 0 ) && ( m_rl_display != m_current_display ))
+	{
+		m_rl_cache.drop_romlist( m_rl.get_romlist_name() );
+		m_rl_cache.store( m_rl_display, m_rl );
+		m_rl.init_as_empty_list();
+	}
+
+	m_rl_display = -1;
 
 	//
 	// Setting new_index to negative causes us to do the 'Displays Menu' w/ custom layout
@@ -732,7 +760,14 @@ void FeSettings::init_display()
 		return;
 	}
 
-	m_path_cache.clear();
+	clear_path_cache();
+
+	if ( m_rl_cache.restore( m_current_display, m_rl ) )
+	{
+		FeLog() << " - Using cached romlist '" << romlist_name << "'" << std::endl;
+		m_rl_display = m_current_display;
+		return;
+	}
 
 	std::string list_path;
 	if ( !internal_resolve_config_file(
@@ -753,12 +788,100 @@ void FeSettings::init_display()
 		m_group_clones,
 		m_track_usage
 	))
-		m_rl.create_filters( m_displays[m_current_display] );
+	{
+		// Show the current filter as soon as it is ready, the others
+		// are built by build_pending_filter() as the frontend runs
+		m_rl.create_filters( m_displays, m_current_display,
+			m_displays[m_current_display].get_current_filter_index() );
+
+		m_rl_display = m_current_display;
+	}
 	else
 		FeLog() << "Error opening romlist: " << romlist_name << std::endl;
 
 }
 
+bool FeSettings::prefetch_romlists()
+{
+	if (( m_romlist_cache_mbytes <= 0 ) || ( m_current_display < 0 ) || ( m_display_cycle.size() < 2 ))
+		return false;
+
+	// Finish the current display's filters first
+	if ( m_rl.get_pending_filters() > 0 )
+		return false;
+
+	const int i = find_idx_in_vec( m_current_display, m_display_cycle );
+	const int n = m_display_cycle.size();
+
+	while ( m_prefetch_pos < 2 )
+	{
+		const int step = ( m_prefetch_pos++ == 0 ) ? 1 : -1;
+		const int idx = m_display_cycle[ ( i + step + n ) % n ];
+
+		if (( idx == m_current_display ) || ( idx >= (int)m_displays.size() ) || m_rl_cache.contains( idx ))
+			continue;
+
+		// Displays sharing the current romlist are dropped from the cache when
+		// we leave, in case their favourites or tags have been changed
+		const std::string &romlist_name = m_displays[idx].get_info( FeDisplayInfo::Romlist );
+		if ( romlist_name.empty() || ( romlist_name == m_rl.get_romlist_name() ))
+			continue;
+
+		std::string list_path;
+		if ( !internal_resolve_config_file(
+			m_config_path,
+			list_path,
+			FE_ROMLIST_SUBDIR,
+			romlist_name + FE_ROMLIST_FILE_EXTENSION
+		))
+			continue;
+
+		FeDebug() << "Prefetching romlist '" << romlist_name << "' for display: "
+			<< m_displays[idx].get_info( FeDisplayInfo::Name ) << std::endl;
+
+		FeRomList rl( m_config_path );
+		if ( rl.load_romlist(
+			list_path,
+			romlist_name,
+			m_displays[idx],
+			m_group_clones,
+			m_track_usage
+		))
+		{
+			rl.create_filters( m_displays[idx] );
+			m_rl_cache.store( idx, rl );
+		}
+
+		return true;
+	}
+
+	return false;
+}
+
+void FeSettings::clear_romlist_cache()
+{
+	m_rl_cache.clear();
+}
+
+bool FeSettings::build_pending_filter()
+{
+	return m_rl.build_pending_filter();
+}
+
+bool FeSettings::get_romlist_loading() const
+{
+	return ( m_rl.get_pending_filters() > 0 );
+}
+
+float FeSettings::get_romlist_progress() const
+{
+	int count = m_rl.get_filter_count();
+	if ( count <= 0 )
+		return 1.f;
+
+	return (float)( count - m_rl.get_pending_filters() ) / count;
+}
+
 void FeSettings::construct_display_maps()
 {
 	m_display_cycle.clear();
@@ -1102,6 +1225,7 @@ void FeSettings::set_search_rule( const std::string &rule_str )
 	m_current_search_index=0;
 	m_current_search_str.clear();
 	m_clone_index = -1;
+	m_search_nav.clear();
 
 	if ( rule_str.empty() )
 		return;
@@ -1112,13 +1236,7 @@ void FeSettings::set_search_rule( const std::string &rule_str )
 
 	rule.init();
 
-	int filter_index = get_current_filter_index();
-	for ( int i=0; i<m_rl.filter_size( filter_index ); i++ )
-	{
-		FeRomInfo &r = m_rl.lookup( filter_index, i );
-		if ( rule.apply_rule( r ) )
-			m_current_search.push_back( &r );
-	}
+	m_rl.search( get_current_filter_index(), rule, m_current_search );
 
 	if ( !m_current_search.empty() )
 		m_current_search_str = rule_str;
@@ -1180,6 +1298,7 @@ bool FeSettings::switch_to_clone_group( int idx )
 		}
 
 		m_current_search.swap( group );
+		m_search_nav.clear();
 		m_current_search_str = name_with_brackets_stripped( t );
 		m_clone_index = ri;
 
@@ -2080,6 +2199,7 @@ bool FeSettings::set_current_fav( bool status )
 	if ( !r )
 		return false;
 
+	m_search_nav.clear_favs();
 	return m_rl.set_fav( *r, m_displays[m_current_display], status );
 }
 
@@ -2088,18 +2208,10 @@ int FeSettings::get_prev_fav_offset()
 	int filter_index = get_current_filter_index();
 	int idx = get_rom_index( filter_index, 0 );
 
-	for ( int i=1; i < get_filter_size( filter_index ); i++ )
-	{
-		int t_idx = ( i <= idx ) ? ( idx - i )
-			: ( get_filter_size( filter_index ) - ( i - idx ) );
-
-		if ( get_rom_info_absolute( filter_index,
-				t_idx,
-				FeRomInfo::Favourite ).compare( "1" ) == 0 )
-			return ( t_idx - idx );
-	}
+	if ( !m_current_search.empty() )
+		return m_search_nav.get_next_fav( m_current_search, idx, -1 ) - idx;
 
-	return 0;
+	return m_rl.get_next_fav_index( filter_index, idx, -1 ) - idx;
 }
 
 int FeSettings::get_next_fav_offset()
@@ -2107,16 +2219,10 @@ int FeSettings::get_next_fav_offset()
 	int filter_index = get_current_filter_index();
 	int idx = get_rom_index( filter_index, 0 );
 
-	for ( int i=1; i < get_filter_size( filter_index ); i++ )
-	{
-		int t_idx = ( idx + i ) % get_filter_size( filter_index );
-		if ( get_rom_info_absolute( filter_index,
-				t_idx,
-				FeRomInfo::Favourite ).compare( "1" ) == 0 )
-			return ( t_idx - idx );
-	}
+	if ( !m_current_search.empty() )
+		return m_search_nav.get_next_fav( m_current_search, idx, 1 ) - idx;
 
-	return 0;
+	return m_rl.get_next_fav_index( filter_index, idx, 1 ) - idx;
 }
 
 int FeSettings::get_next_letter_offset( int step )
@@ -2124,30 +2230,10 @@ int FeSettings::get_next_letter_offset( int step )
 	int filter_index = get_current_filter_index();
 	int idx = get_rom_index( filter_index, 0 );
 
-	FeRomListSorter s;
-	const char curr_l = s.get_first_letter( get_rom_absolute( filter_index, idx ) );
-	bool is_alpha = std::isalpha( curr_l );
-	int retval = 0;
-
-	for ( int i=1; i < get_filter_size( filter_index ); i++ )
-	{
-		int t_idx;
-		if ( step > 0 )
-			t_idx = ( idx + i ) % get_filter_size( filter_index );
-		else
-			t_idx = ( i <= idx ) ? ( idx - i ) : ( get_filter_size( filter_index ) - ( i - idx ) );
-
-		const char test_l = s.get_first_letter( get_rom_absolute( filter_index, t_idx ) );
-
-		if ((( is_alpha ) && ( test_l != curr_l ))
-				|| ((!is_alpha) && ( std::isalpha( test_l ) )))
-		{
-			retval = t_idx - idx;
-			break;
-		}
-	}
+	if ( !m_current_search.empty() )
+		return m_search_nav.get_next_letter( m_current_search, idx, step ) - idx;
 
-	return retval;
+	return m_rl.get_next_letter_index( filter_index, idx, step ) - idx;
 }
 
 void FeSettings::get_current_tags_list(
@@ -2490,6 +2576,9 @@ bool FeSettings::update_stats( int play_count, int play_time )
 
 	rom->update_stats( path, play_count, play_time );
 
+	// Other displays may show the same game
+	m_rl_cache.clear();
+
 	bool fixed = m_rl.fix_filters( m_displays[m_current_display], std::set<FeRomInfo::Index>( FeRomInfo::Stats.begin(), FeRomInfo::Stats.end() ) );
 
 	if ( fixed && ( &m_rl.lookup( filter_index, rom_index ) != rom ))
@@ -2577,24 +2666,31 @@ void FeSettings::do_text_substitutions_absolute( std::string &str, int filter_in
 bool FeSettings::get_token_value( std::string &token, int filter_index, int rom_index, std::string &value )
 {
 	int i = get_token_index( FeRomInfo::indexStrings, token );
-	switch ( i )
+	if ( i < 0 )
+		return get_special_token_value( token, filter_index, rom_index, value );
+
+	get_index_token_value( (FeRomInfo::Index)i, filter_index, rom_index, value );
+	return true;
+}
+
+void FeSettings::get_index_token_value( FeRomInfo::Index index, int filter_index, int rom_index, std::string &value )
+{
+	switch ( index )
 	{
 		case FeRomInfo::Title:
 			// Don't strip brackets when showing a clones group
 			value = get_rom_info_absolute( filter_index, rom_index, FeRomInfo::Title );
 			if ( m_hide_brackets && m_clone_index < 0 ) value = name_with_brackets_stripped( value );
-			return true;
+			break;
 		case FeRomInfo::PlayedTime:
 			value = get_played_time_display_string( filter_index, rom_index );
-			return true;
+			break;
 		case FeRomInfo::PlayedLast:
 			value = get_played_last_display_string( filter_index, rom_index );
-			return true;
+			break;
 		default:
-			value = get_rom_info_absolute( filter_index, rom_index, (FeRomInfo::Index)i );
-			return true;
-		case -1:
-			return get_special_token_value( token, filter_index, rom_index, value );
+			value = get_rom_info_absolute( filter_index, rom_index, index );
+			break;
 	}
 }
 
@@ -2604,6 +2700,14 @@ bool FeSettings::get_token_value( std::string &token, int filter_index, int rom_
 bool FeSettings::get_special_token_value( std::string &token, int filter_index, int rom_index, std::string &value )
 {
 	int i = get_token_index( FeRomInfo::specialStrings, token );
+	if ( i < 0 )
+		return false;
+
+	return get_special_token_value( (FeRomInfo::Special)i, filter_index, rom_index, value );
+}
+
+bool FeSettings::get_special_token_value( FeRomInfo::Special i, int filter_index, int rom_index, std::string &value )
+{
 	switch ( i )
 	{
 		case FeRomInfo::DisplayName:
@@ -2642,8 +2746,8 @@ bool FeSettings::get_special_token_value( std::string &token, int filter_index,
 			bool reverse_sort;
 			int list_limit;
 			get_current_sort( sort_by, reverse_sort, list_limit );
-			std::string sort_token = FeRomInfo::indexStrings[ ( sort_by == FeRomInfo::LAST_INDEX ) ? FeRomInfo::Title : sort_by ];
-			return get_token_value( sort_token, filter_index, rom_index, value );
+			get_index_token_value( ( sort_by == FeRomInfo::LAST_INDEX ) ? FeRomInfo::Title : sort_by, filter_index, rom_index, value );
+			return true;
 		}
 		case FeRomInfo::System:
 		case FeRomInfo::SystemN:
@@ -2962,6 +3066,8 @@ const std::string FeSettings::get_info( int index ) const
 		return as_str( m_selection_speed );
 	case ImageCacheMBytes:
 		return as_str( m_image_cache_mbytes );
+	case RomlistCacheMBytes:
+		return as_str( m_romlist_cache_mbytes );
 	case StartupMode:
 		return startupTokens[ m_startup_mode ];
 	case ThegamesdbKey:
@@ -2988,6 +3094,7 @@ const std::string FeSettings::get_info( int index ) const
 	case ScrapeOverview:
 	case PowerSaving:
 	case CheckForUpdates:
+	case ReleaseMemoryOnLaunch:
 #ifdef SFML_SYSTEM_WINDOWS
 	case HideConsole:
 #endif
@@ -3060,6 +3167,8 @@ bool FeSettings::get_info_bool( int index ) const
 		return m_power_saving;
 	case CheckForUpdates:
 		return m_check_for_updates;
+	case ReleaseMemoryOnLaunch:
+		return m_release_memory_on_launch;
 #ifdef SFML_SYSTEM_WINDOWS
 	case HideConsole:
 		return m_hide_console;
@@ -3282,6 +3391,15 @@ bool FeSettings::set_info( int index, const std::string &value )
 		FeImageLoader::set_cache_size( m_image_cache_mbytes * 1024 * 1024 );
 		break;
 
+	case RomlistCacheMBytes:
+		m_romlist_cache_mbytes = as_int( value );
+		if ( m_romlist_cache_mbytes < 0 )
+			m_romlist_cache_mbytes = 0;
+
+		FeDebug() << "Setting romlist cache size to " << m_romlist_cache_mbytes << " MBytes." << std::endl;
+		m_rl_cache.set_max_size( (size_t)m_romlist_cache_mbytes * 1024 * 1024 );
+		break;
+
 	case MoveMouseOnLaunch:
 		m_move_mouse_on_launch = config_str_to_bool( value );
 		break;
@@ -3322,6 +3440,10 @@ bool FeSettings::set_info( int index, const std::string &value )
 		m_check_for_updates = config_str_to_bool( value );
 		break;
 
+	case ReleaseMemoryOnLaunch:
+		m_release_memory_on_launch = config_str_to_bool( value );
+		break;
+
 #ifdef SFML_SYSTEM_WINDOWS
 	case HideConsole:
 		m_hide_console = config_str_to_bool( value );
@@ -4023,16 +4145,10 @@ bool art_exists( const std::string &path, const std::string &base )
 }
 
 
-bool FeSettings::internal_get_best_artwork_file(
-	const FeRomInfo &rom,
+void FeSettings::get_art_paths( const std::string &emu_name,
 	const std::string &art_name,
-	std::vector<std::string> &vid_list,
-	std::vector<std::string> &image_list,
-	bool image_only,
-	bool ignore_emu )
+	std::vector<std::string> &art_paths )
 {
-	std::vector < std::string > art_paths;
-
 	// map boxart->flyer and banner->marquee so that artworks with those labels get
 	// scraped artworks
 	std::string scrape_art;
@@ -4043,6 +4159,39 @@ bool FeSettings::internal_get_best_artwork_file(
 	else
 		scrape_art = art_name;
 
+	std::string layout_path;
+	get_path( Current, layout_path );
+
+	FeEmulatorInfo *emu_info = get_emulator( emu_name );
+	if ( emu_info )
+	{
+		std::vector < std::string > temp_list;
+		emu_info->get_artwork( art_name, temp_list );
+		for ( std::vector< std::string >::iterator itr = temp_list.begin();
+			itr != temp_list.end(); ++itr )
+		{
+			art_paths.push_back(
+				emu_info->clean_path_with_wd( *itr, !is_supported_archive( *itr ) ) );
+
+			perform_substitution( art_paths.back(), "$LAYOUT", layout_path );
+		}
+	}
+
+	std::string scraper_path = get_config_dir() + FE_SCRAPER_SUBDIR + emu_name + "/" + scrape_art + "/";
+	if ( directory_exists( scraper_path ) )
+		art_paths.push_back( scraper_path );
+}
+
+bool FeSettings::internal_get_best_artwork_file(
+	const FeRomInfo &rom,
+	const std::string &art_name,
+	std::vector<std::string> &vid_list,
+	std::vector<std::string> &image_list,
+	bool image_only,
+	bool ignore_emu )
+{
+	std::vector < std::string > art_paths;
+
 	const std::string &romname = rom.get_info( FeRomInfo::Romname );
 	std::string emu_name = rom.get_info( FeRomInfo::Emulator );
 
@@ -4077,27 +4226,7 @@ bool FeSettings::internal_get_best_artwork_file(
 		}
 	}
 
-	std::string layout_path;
-	get_path( Current, layout_path );
-
-	FeEmulatorInfo *emu_info = get_emulator( emu_name );
-	if ( emu_info )
-	{
-		std::vector < std::string > temp_list;
-		emu_info->get_artwork( art_name, temp_list );
-		for ( std::vector< std::string >::iterator itr = temp_list.begin();
-			itr != temp_list.end(); ++itr )
-		{
-			art_paths.push_back(
-				emu_info->clean_path_with_wd( *itr, !is_supported_archive( *itr ) ) );
-
-			perform_substitution( art_paths.back(), "$LAYOUT", layout_path );
-		}
-	}
-
-	std::string scraper_path = get_config_dir() + FE_SCRAPER_SUBDIR + emu_name + "/" + scrape_art + "/";
-	if ( directory_exists( scraper_path ) )
-		art_paths.push_back( scraper_path );
+	get_art_paths( emu_name, art_name, art_paths );
 
 	if ( !art_paths.empty() )
 	{
@@ -4200,6 +4329,42 @@ void FeSettings::get_best_artwork_file(
 
 }
 
+const std::string &FeSettings::get_cached_artwork_file(
+	const FeRomInfo &rom,
+	const std::string &art_name,
+	bool image_only )
+{
+	// Layout fallback artwork depends on the layout being shown, so the cache
+	// is cleared whenever a layout is loaded or the display changes
+	std::string key = rom.get_info( FeRomInfo::Emulator );
+	key += '\n';
+	key += rom.get_info( FeRomInfo::Romname );
+	key += '\n';
+	key += art_name;
+	key += image_only ? "\n1" : "\n0";
+
+	std::map<std::string, std::string>::iterator itr = m_art_cache.find( key );
+	if ( itr != m_art_cache.end() )
+		return (*itr).second;
+
+	std::vector<std::string> vid_list, image_list;
+	get_best_artwork_file( rom, art_name, vid_list, image_list, image_only );
+
+	std::string &result = m_art_cache[ key ];
+	if ( !image_only && !vid_list.empty() )
+		result = absolute_path( vid_list.front() );
+	else if ( !image_list.empty() )
+		result = absolute_path( image_list.front() );
+
+	return result;
+}
+
+void FeSettings::clear_path_cache()
+{
+	m_path_cache.clear();
+	m_art_cache.clear();
+}
+
 bool FeSettings::has_artwork( const FeRomInfo &rom, const std::string &art_name )
 {
 	std::vector<std::string> temp1, temp2;
@@ -4220,6 +4385,151 @@ bool FeSettings::has_image_artwork( const FeRomInfo &rom, const std::string &art
 	return (!images.empty());
 }
 
+namespace
+{
+	enum { ArtImage=1, ArtVideo=2, ArtName=4 };
+
+	//
+	// The files in an artwork path, keyed by each lowercase prefix that
+	// ends before a '.', so "Name.1.png" is found as both "name" and
+	// "name.1".  Full filenames are flagged ArtName, as they may be
+	// subdirectories of artwork
+	//
+	typedef std::unordered_map<std::string, int> FeArtIndex;
+
+	void add_art_file( FeArtIndex &index, const std::string &file, size_t path_len, int flag )
+	{
+		std::string name = file.substr( path_len );
+		std::transform( name.begin(), name.end(), name.begin(), ::tolower );
+
+		for ( size_t pos = name.find( '.' ); pos != std::string::npos; pos = name.find( '.', pos + 1 ))
+			index[ name.substr( 0, pos ) ] |= flag;
+
+		index[ name ] |= ArtName;
+	}
+
+	void build_art_index( const std::string &path, FeArtIndex &index )
+	{
+		std::vector<std::string> images, others;
+		get_filename_from_base( images, others, path, "", FE_ART_EXTENSIONS );
+
+		index.reserve( ( images.size() + others.size() ) * 2 );
+
+		for ( std::vector<std::string>::iterator itr = images.begin(); itr != images.end(); ++itr )
+			add_art_file( index, *itr, path.size(), ArtImage );
+
+		for ( std::vector<std::string>::iterator itr = others.begin(); itr != others.end(); ++itr )
+		{
+#ifdef NO_MOVIE
+			add_art_file( index, *itr, path.size(), 0 );
+#else
+			add_art_file( index, *itr, path.size(),
+				FeMedia::is_supported_media_file( *itr ) ? ArtVideo : 0 );
+#endif
+		}
+	}
+};
+
+void FeSettings::check_artwork( const FeRomInfoListType &romlist,
+	const std::string &art_name,
+	ArtCheck check,
+	std::vector<bool> &result )
+{
+	result.assign( romlist.size(), false );
+
+	//
+	// Gather the artwork paths of each emulator in the list, then list and
+	// index each path on its own thread
+	//
+	std::map<std::string, std::vector<int>> emu_paths;
+	std::vector<std::string> paths;
+
+	for ( FeRomInfoListType::const_iterator itr = romlist.begin(); itr != romlist.end(); ++itr )
+	{
+		const std::string &emu_name = (*itr).get_info( FeRomInfo::Emulator );
+		if (( emu_name.compare( 0, 1, "@" ) == 0 ) || ( emu_paths.find( emu_name ) != emu_paths.end() ))
+			continue;
+
+		std::vector<std::string> temp;
+		get_art_paths( emu_name, art_name, temp );
+
+		std::vector<int> &ep = emu_paths[ emu_name ];
+		for ( std::vector<std::string>::iterator itp = temp.begin(); itp != temp.end(); ++itp )
+		{
+			std::vector<std::string>::iterator f = std::find( paths.begin(), paths.end(), *itp );
+			ep.push_back( f - paths.begin() );
+			if ( f == paths.end() )
+				paths.push_back( *itp );
+		}
+	}
+
+	std::vector<FeArtIndex> indexes( paths.size() );
+	std::vector<std::thread> workers;
+	for ( size_t i=0; i<paths.size(); i++ )
+		workers.emplace_back( build_art_index, std::cref( paths[i] ), std::ref( indexes[i] ));
+
+	for ( std::vector<std::thread>::iterator itr = workers.begin(); itr != workers.end(); ++itr )
+		(*itr).join();
+
+	int want = ( check == VideoArt ) ? ArtVideo
+		: ( check == ImageArt ) ? ArtImage
+		: ( ArtImage | ArtVideo );
+
+	size_t i=0;
+	for ( FeRomInfoListType::const_iterator itr = romlist.begin(); itr != romlist.end(); ++itr, i++ )
+	{
+		const std::string &emu_name = (*itr).get_info( FeRomInfo::Emulator );
+		if ( emu_name.compare( 0, 1, "@" ) == 0 )
+		{
+			result[i] = ( check == VideoArt ) ? has_video_artwork( *itr, art_name )
+				: ( check == ImageArt ) ? has_image_artwork( *itr, art_name )
+				: has_artwork( *itr, art_name );
+			continue;
+		}
+
+		const std::vector<int> &ep = emu_paths[ emu_name ];
+		if ( ep.empty() )
+			continue;
+
+		// The same names that internal_get_best_artwork_file() checks
+		const std::string &romname = (*itr).get_info( FeRomInfo::Romname );
+		const std::string &altname = (*itr).get_info( FeRomInfo::AltRomname );
+		const std::string &cloneof = (*itr).get_info( FeRomInfo::Cloneof );
+
+		std::vector<std::string> names( 1, romname );
+		if ( !altname.empty() && ( romname.compare( altname ) != 0 ))
+			names.push_back( altname );
+		if ( !cloneof.empty() && ( altname.compare( cloneof ) != 0 ))
+			names.push_back( cloneof );
+
+		int found=0;
+		for ( std::vector<std::string>::iterator itn = names.begin(); !( found & want ) && ( itn != names.end() ); ++itn )
+		{
+			std::string key = *itn;
+			std::transform( key.begin(), key.end(), key.begin(), ::tolower );
+
+			for ( std::vector<int>::const_iterator itp = ep.begin(); !( found & want ) && ( itp != ep.end() ); ++itp )
+			{
+				FeArtIndex::const_iterator f = indexes[ *itp ].find( key );
+				if ( f == indexes[ *itp ].end() )
+					continue;
+
+				if ( (*f).second & ( ArtImage | ArtVideo ))
+					found |= (*f).second;
+				else if ( (*f).second & ArtName )
+				{
+					// Possibly a subdirectory of artwork, check it the slow way
+					std::vector<std::string> one_path( 1, paths[ *itp ] ), vids, images;
+					gather_artwork_filenames( one_path, *itn, vids, images, false, NULL );
+					found |= ( vids.empty() ? 0 : ArtVideo ) | ( images.empty() ? 0 : ArtImage );
+				}
+			}
+		}
+
+		result[i] = ( found & want );
+	}
+}
+
 bool FeSettings::get_best_dynamic_image_file(
 	int filter_index,
 	int rom_index,
@@ -4272,15 +4582,14 @@ bool FeSettings::update_romlist_after_edit(
 	if ( !update_romlist_file( romlist_name, original, replacement, u_type ) )
 		return false;
 
-	// Update the current in-memory romlist entry
-	update_romlist_entry( original, replacement, u_type );
-
 	// Flag tags as changed so they get saved on exit
 	if (( u_type == EraseEntry ) || ( u_type == InsertEntry ) || ( original != replacement ))
 		m_rl.mark_favs_and_tags_changed();
 
-	// Re-create the filters to show the edited entry
-	m_rl.create_filters( m_displays[m_current_display] );
+	// Update the current in-memory romlist entry and the filters showing it,
+	// or re-create the filters if the entry isn't loaded
+	if ( !update_romlist_entry( original, replacement, u_type ) )
+		m_rl.create_filters( m_displays[m_current_display] );
 
 	return true;
 }
@@ -4294,29 +4603,19 @@ bool FeSettings::update_romlist_entry(
 	UpdateType u_type
 )
 {
-	FeRomInfoListType &rl = m_rl.get_list();
-	for ( FeRomInfoListType::iterator it = rl.begin(); it != rl.end(); ++it )
-	{
-		if ( (*it).full_comparison( original ) )
-		{
-			switch ( u_type )
-			{
-				case EraseEntry:
-					it = rl.erase( it );
-					return true;
-				case InsertEntry:
-					it = rl.insert( it, replacement );
-					return true;
-				default:
-				case UpdateEntry:
-					(*it) = replacement;
-					return true;
-			}
-		}
-	}
-	return false;
+	if ( m_current_display < 0 )
+		return false;
+
+	return m_rl.update_entry( m_displays[m_current_display],
+		original,
+		( u_type == EraseEntry ) ? NULL : &replacement,
+		u_type == InsertEntry );
 }
 
+//
+// Update the romlist file
+// - Only the edited line is parsed and replaced, the rest of the file is copied as is
+//
 bool FeSettings::update_romlist_file(
 	const std::string &romlist_name,
 	const FeRomInfo &original,
@@ -4333,46 +4632,98 @@ bool FeSettings::update_romlist_file(
 		return false;
 
 	// Exit early if cannot open infile
-	nowide::ifstream infile( in_path );
-	if ( !infile.is_open() )
+	FeMappedFile infile;
+	if ( !infile.open( in_path ) )
 		return false;
 
-	// Reload the ENTIRE romlist (ignoring all filters) and apply update
-	FeRomInfoListType temp_list;
+	const char *data = infile.data();
+	size_t size = infile.size();
+
+	//
+	// Find the original entry, only parsing the lines that start with its romname
+	//
+	const std::string &romname = original.get_info( FeRomInfo::Romname );
+	std::string line, setting, value;
+	size_t line_start = 0;
+	size_t line_end = 0;
 	bool found = false;
-	while ( infile.good() )
+
+	for ( size_t pos = 0; !found && ( pos < size ); pos = line_end )
 	{
-		std::string line, setting, value;
-		getline( infile, line );
+		const char *nl = static_cast<const char *>( memchr( data + pos, '\n', size - pos ));
+		line_start = pos;
+		line_end = nl ? nl - data + 1 : size;
+
+		// The line is parsed without its '\n', as parse_romlist_chunk() does
+		size_t len = ( nl ? nl - data : size ) - pos;
+
+		size_t token_pos = 0;
+		token_helper( data + pos, len, token_pos, setting, ";" );
+		if ( setting.empty() || ( setting[0] == '#' ) || ( setting.compare( romname ) != 0 ))
+			continue;
+
+		line.assign( data + pos, len );
 		if ( line_to_setting_and_value( line, setting, value, ";" ) )
 		{
 			FeRomInfo rom( setting );
 			rom.process_setting( setting, value, "" );
+			found = rom.full_comparison( original );
+		}
+	}
 
-			if ( !found && rom.full_comparison( original ) )
-			{
-				found=true;
-				switch ( u_type )
-				{
-					case UpdateEntry:
-						temp_list.push_back( replacement );
-						continue;
-					case InsertEntry:
-						temp_list.push_back( replacement );
-						break;
-					case EraseEntry:
-						continue;
-				}
-			}
-			temp_list.push_back( rom );
+	// Keep the file's line endings for the replacement
+	const char *eol = ( found && ( line_end - line_start > 1 ) && ( data[line_end - 2] == '\r' )) ? "\r\n" : "\n";
+	std::string out;
+	out.reserve( size + 1024 );
+
+	if ( size == 0 )
+	{
+		// Output romlist header
+		int i=0;
+		out += "#";
+		out += FeRomInfo::indexStrings[i++];
+		while ( i < FeRomInfo::LAST_INFO )
+		{
+			out += ";";
+			out += FeRomInfo::indexStrings[i++];
 		}
+		out += eol;
 	}
-	infile.close();
 
-	// If we didn't find the original, add this as a new rom at the end
-	// This way if the user edits on an empty list, they can create a first entry
-	if ( !found && ( u_type == UpdateEntry || u_type == InsertEntry ))
-		temp_list.push_back( replacement );
+	if ( found )
+	{
+		out.append( data, line_start );
+		switch ( u_type )
+		{
+			case UpdateEntry:
+				out += replacement.as_output() + eol;
+				break;
+			case InsertEntry:
+				out += replacement.as_output() + eol;
+				line_end = line_start;
+				break;
+			case EraseEntry:
+				break;
+		}
+		out.append( data + line_end, size - line_end );
+	}
+	else
+	{
+		if ( size > 0 )
+			out.append( data, size );
+
+		// If we didn't find the original, add this as a new rom at the end
+		// This way if the user edits on an empty list, they can create a first entry
+		if ( u_type == UpdateEntry || u_type == InsertEntry )
+		{
+			if (( size > 0 ) && ( data[size - 1] != '\n' ))
+				out += eol;
+
+			out += replacement.as_output() + eol;
+		}
+	}
+
+	infile.close();
 
 	// NOTE: We do NOT delete stats file upon during erase
 	// - Stats are linked against the emulator, which may be used in other romlists!
@@ -4382,7 +4733,16 @@ bool FeSettings::update_romlist_file(
 		+ FE_ROMLIST_SUBDIR
 		+ romlist_name
 		+ FE_ROMLIST_FILE_EXTENSION;
-	return write_romlist( out_path, temp_list );
+
+	FeLog() << " + Updating entry in: " << out_path << std::endl;
+
+	nowide::ofstream outfile( out_path, std::ios::binary );
+	if ( !outfile.is_open() )
+		return false;
+
+	outfile.write( out.data(), out.size() );
+	outfile.close();
+	return true;
 }
 
 //
@@ -75,6 +75,8 @@ public:
 	std::string file_name;
 };
 
+class FeRomlistBuild;
+
 class FeLanguage
 {
 public:
@@ -169,6 +171,8 @@ public:
 		MenuPrompt, // 'Displays Menu' prompt
 		MenuLayout, // 'Displays Menu' layout
 		ImageCacheMBytes,
+		RomlistCacheMBytes,
+		ReleaseMemoryOnLaunch,
 		LAST_INDEX
 	};
 
@@ -203,13 +207,16 @@ private:
 	std::vector<FePlugInfo> m_plugins;
 	std::vector<FeLayoutInfo> m_layout_params;
 	std::vector<FeRomInfo *> m_current_search;
+	FeFilterNav m_search_nav; // navigation indexes for m_current_search
 	std::vector<int> m_display_cycle; // display indices to show in cycle
 	std::vector<int> m_display_menu; // display indices to show in menu
 	std::map<GameExtra,std::string> m_game_extras; // "extra" rom settings for the current rom
 	std::deque<int> m_display_stack; // stack for displays to navigate to when "back" button pressed (and
 					// display shortcuts are used)
 	FeRomList m_rl;
+	FeRomListCache m_rl_cache; // romlists of other recently shown displays
 	FePathCache m_path_cache;
+	std::map<std::string, std::string> m_art_cache; // resolved artwork, see get_cached_artwork_file()
 
 	FeInputMap m_inputmap;
 	FeSoundInfo m_sounds;
@@ -224,6 +231,8 @@ private:
 	int m_current_display; // The index of the current display, -1 if showing a custom displays_menu
 	int m_selected_display; // The index of the displays_menu selected display, -1 if EXIT is selected. Equals m_current_display if displays_menu not shown.
 	int m_actual_display_index; // The most recent actual display index that was selected (for saving)
+	int m_rl_display; // The display that m_rl is loaded for, -1 if it is not a display's romlist
+	int m_prefetch_pos; // The next neighbouring display for prefetch_romlists() to check
 	FeBaseConfigurable *m_current_config_object;
 	int m_ssaver_time;
 	int m_last_launch_display;
@@ -251,6 +260,7 @@ private:
 	int m_selection_max_step; // max selection acceleration step.  0 to disable accel
 	int m_selection_speed;
 	int m_image_cache_mbytes; // image cache size (in Megabytes)
+	int m_romlist_cache_mbytes; // cache size for the romlists of other displays (in Megabytes)
 	bool m_move_mouse_on_launch; // configure whether mouse gets moved to bottom right corner on launch
 	bool m_scrape_snaps;
 	bool m_scrape_marquees;
@@ -264,6 +274,7 @@ private:
 #endif
 	bool m_power_saving;
 	bool m_check_for_updates;
+	bool m_release_memory_on_launch; // free artwork and videos while a game is running
 	RotationState m_screen_rotation;
 	int m_antialiasing;
 	int m_anisotropic;
@@ -306,10 +317,19 @@ private:
 		bool image_only,
 		bool ignore_emu );
 
+	void clear_path_cache();
+
+	// Append the artwork paths configured for emu_name plus its scraper path
+	void get_art_paths( const std::string &emu_name,
+		const std::string &art_name,
+		std::vector<std::string> &art_paths );
+
 	bool simple_scraper( FeImporterContext &, const char *, const char *, const char *, const char *, bool = false );
 	bool general_mame_scraper( FeImporterContext & );
 	bool thegamesdb_scraper( FeImporterContext & );
 	bool apply_xml_import( FeImporterContext & );
+	void run_romlist_build( FeRomlistBuild & );
+	bool run_romlist_builds( std::deque<FeRomlistBuild> &, UiUpdate, void * );
 
 	bool load_game_extras(
 		const std::string &romlist_name,
@@ -390,6 +410,24 @@ public:
 	int displays_count() const;
 
 	bool navigate_display( int step, bool wrap_mode=false );
+
+	// Load the romlist of the next or previous display in the cycle into
+	// the romlist cache, so that switching to it doesn't have to.  Loads at
+	// most one romlist per call, returns false once there is nothing to load
+	//
+	bool prefetch_romlists();
+
+	// Drop the cached romlists of other displays, call when the settings change
+	void clear_romlist_cache();
+
+	// Build one of the current display's filters that are still loading,
+	// returns false if there are none
+	bool build_pending_filter();
+
+	// Whether the current display's filters are still loading, and the
+	// fraction of them that have loaded
+	bool get_romlist_loading() const;
+	float get_romlist_progress() const;
 	bool navigate_filter( int step );
 
 	int get_current_filter_index() const;
@@ -441,6 +479,10 @@ public:
 	bool get_token_value( std::string &token, int filter_index, int rom_index, std::string &value );
 	bool get_special_token_value( std::string &token, int filter_index, int rom_index, std::string &value );
 
+	// As above, for tokens already resolved to a FeRomInfo::Index or FeRomInfo::Special
+	void get_index_token_value( FeRomInfo::Index index, int filter_index, int rom_index, std::string &value );
+	bool get_special_token_value( FeRomInfo::Special special, int filter_index, int rom_index, std::string &value );
+
 	void get_current_sort( FeRomInfo::Index &idx, bool &rev, int &limit );
 
 	const std::string &get_current_display_title() const;
@@ -465,7 +507,7 @@ public:
 
 	//
 	FePresentState get_present_state() const { return m_present_state; };
-	void set_present_state( FePresentState s ) { m_present_state=s; };
+	void set_present_state( FePresentState s ) { m_present_state=s; m_art_cache.clear(); }; // a layout is being loaded
 
 	int ui_font_size() const { return m_ui_font_size; }
 	void set_window_topmost( bool window_topmost ) { m_window_topmost = window_topmost; }
@@ -508,10 +550,30 @@ public:
 		std::vector<std::string> &image_list,
 		bool image_only );
 
+	// Return the absolute path of the best artwork file for rom, videos
+	// are preferred unless image_only is set.  Results are kept until the
+	// path cache is cleared
+	const std::string &get_cached_artwork_file(
+		const FeRomInfo &rom,
+		const std::string &art_name,
+		bool image_only );
+
 	bool has_artwork( const FeRomInfo &rom, const std::string &art_name );
 	bool has_video_artwork( const FeRomInfo &rom, const std::string &art_name );
 	bool has_image_artwork( const FeRomInfo &rom, const std::string &art_name );
 
+	//
+	// Check every rom in romlist for artwork in one pass, setting result to
+	// what has_artwork(), has_video_artwork() or has_image_artwork() would
+	// return for each.  Each artwork path is listed once and its filenames
+	// are hashed, so this is much faster than checking roms one at a time
+	//
+	enum ArtCheck { AnyArt, VideoArt, ImageArt };
+	void check_artwork( const FeRomInfoListType &romlist,
+		const std::string &art_name,
+		ArtCheck check,
+		std::vector<bool> &result );
+
 	bool get_best_dynamic_image_file(
 		int filter_index,
 		int rom_index,
@@ -27,7 +27,9 @@
 #include <iostream>
 
 FeShader::FeShader()
-	: m_type( Empty )
+	: m_type( Empty ),
+	m_version( 0 ),
+	m_image_texture( false )
 {
 }
 
@@ -66,6 +68,7 @@ void FeShader::set_param( const char *name, float x )
 	if ( m_type != Empty )
 	{
 		m_shader.setUniform( name, x );
+		m_version++;
 		FePresent::script_flag_redraw();
 	}
 }
@@ -75,6 +78,7 @@ void FeShader::set_param( const char *name, float x, float y )
 	if ( m_type != Empty )
 	{
 		m_shader.setUniform( name, sf::Glsl::Vec2( x, y ) );
+		m_version++;
 		FePresent::script_flag_redraw();
 	}
 }
@@ -84,6 +88,7 @@ void FeShader::set_param( const char *name, float x, float y, float z )
 	if ( m_type != Empty )
 	{
 		m_shader.setUniform( name, sf::Glsl::Vec3( x, y, z ) );
+		m_version++;
 		FePresent::script_flag_redraw();
 	}
 }
@@ -93,6 +98,7 @@ void FeShader::set_param( const char *name, float x, float y, float z, float w )
 	if ( m_type != Empty )
 	{
 		m_shader.setUniform( name, sf::Glsl::Vec4( x, y, z, w ) );
+		m_version++;
 		FePresent::script_flag_redraw();
 	}
 }
@@ -102,6 +108,7 @@ void FeShader::set_texture_param( const char *name )
 	if ( m_type != Empty )
 	{
 		m_shader.setUniform( name, sf::Shader::CurrentTexture );
+		m_version++;
 		FePresent::script_flag_redraw();
 	}
 }
@@ -110,11 +117,14 @@ void FeShader::set_texture_param( const char *name, FeImage *image )
 {
 	if (( m_type != Empty ) && ( image ))
 	{
+		image->leave_atlas();
 		const sf::Texture *texture = image->get_texture();
 
 		if ( texture )
 		{
 			m_shader.setUniform( name, *texture );
+			m_version++;
+			m_image_texture = true;
 			FePresent::script_flag_redraw();
 		}
 	}
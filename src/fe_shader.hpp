@@ -54,12 +54,21 @@ public:
 	const sf::Shader *get_shader() const { return ( m_type != Empty ) ? &m_shader : NULL; };
 	Type get_type() const { return m_type; };
 
+	// incremented each time a parameter is set
+	unsigned int get_version() const { return m_version; };
+
+	// true if an image's texture has been bound, which can change without
+	// the shader itself being touched
+	bool has_image_texture() const { return m_image_texture; };
+
 private:
 	FeShader( const FeShader & );
 	const FeShader &operator=( const FeShader & );
 
 	Type m_type;
 	sf::Shader m_shader;
+	unsigned int m_version;
+	bool m_image_texture;
 };
 
 #endif
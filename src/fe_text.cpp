@@ -25,6 +25,7 @@
 #include "fe_util.hpp"
 #include "fe_shader.hpp"
 #include "fe_present.hpp"
+#include "fe_batch.hpp"
 #include <iostream>
 
 FeText::FeText( FePresentableParent &p, const std::string &str,
@@ -45,6 +46,7 @@ FeText::FeText( FePresentableParent &p, const std::string &str,
 void FeText::setFont( const sf::Font &f )
 {
 	m_draw_text.setFont( f );
+	flag_redraw();
 }
 
 sf::Vector2f FeText::getPosition() const
@@ -88,7 +90,7 @@ void FeText::setColor( sf::Color c )
 		sf::Color o = m_draw_text.getOutlineColor();
 		o.a = c.a;
 		m_draw_text.setOutlineColor( o );
-		FePresent::script_flag_redraw();
+		flag_redraw();
 	}
 }
 
@@ -151,13 +153,12 @@ void FeText::update_font_size()
 
 void FeText::on_new_selection( FeSettings *feSettings )
 {
-	std::string str = m_string;
+	int filter_index = feSettings->get_filter_index_from_offset( m_filter_offset );
+	int rom_index = feSettings->get_rom_index( filter_index, m_index_offset );
 
-	FePresent::script_process_magic_strings( str,
-			m_filter_offset,
-			m_index_offset );
-
-	feSettings->do_text_substitutions( str, m_filter_offset, m_index_offset );
+	std::string str;
+	m_template.set_format( m_string );
+	m_template.expand( str, feSettings, filter_index, rom_index, m_filter_offset, m_index_offset );
 
 	m_draw_text.setString( str );
 }
@@ -182,6 +183,18 @@ void FeText::draw( sf::RenderTarget &target, sf::RenderStates states ) const
 	target.draw( m_draw_text, states );
 }
 
+void FeText::batch( FeDrawBatch &b, const sf::RenderStates &rs ) const
+{
+	const FeShader *s = get_shader();
+	if ( s && s->get_shader() )
+	{
+		b.draw( drawable(), rs );
+		return;
+	}
+
+	m_draw_text.batch( b, rs );
+}
+
 void FeText::set_word_wrap( bool w )
 {
 	m_draw_text.setWordWrap( w );
@@ -354,7 +367,7 @@ void FeText::set_bgr(int r)
 	{
 		c.r=r;
 		m_draw_text.setBgColor(c);
-		FePresent::script_flag_redraw();
+		flag_redraw();
 	}
 }
 
@@ -366,7 +379,7 @@ void FeText::set_bgg(int g)
 	{
 		c.g=g;
 		m_draw_text.setBgColor(c);
-		FePresent::script_flag_redraw();
+		flag_redraw();
 	}
 }
 
@@ -378,7 +391,7 @@ void FeText::set_bgb(int b)
 	{
 		c.b=b;
 		m_draw_text.setBgColor(c);
-		FePresent::script_flag_redraw();
+		flag_redraw();
 	}
 }
 
@@ -393,7 +406,7 @@ void FeText::set_bga(int a)
 		sf::Color o = m_draw_text.getBgOutlineColor();
 		o.a = c.a;
 		m_draw_text.setBgOutlineColor( o );
-		FePresent::script_flag_redraw();
+		flag_redraw();
 	}
 }
 
@@ -411,7 +424,7 @@ void FeText::set_bg_rgb(int r, int g, int b )
 			c.a = 255;
 
 		m_draw_text.setBgColor(c);
-		FePresent::script_flag_redraw();
+		flag_redraw();
 	}
 }
 
@@ -429,7 +442,7 @@ void FeText::set_bg_outline_rgb(int r, int g, int b )
 			c.a = 255;
 
 		m_draw_text.setBgOutlineColor(c);
-		FePresent::script_flag_redraw();
+		flag_redraw();
 	}
 }
 
@@ -447,7 +460,7 @@ void FeText::set_outline_rgb(int r, int g, int b )
 			c.a = 255;
 
 		m_draw_text.setOutlineColor(c);
-		FePresent::script_flag_redraw();
+		flag_redraw();
 	}
 }
 
@@ -481,7 +494,7 @@ void FeText::set_style(int s)
 	if ( s != m_draw_text.getStyle() )
 	{
 		m_draw_text.setStyle(s);
-		FePresent::script_flag_redraw();
+		flag_redraw();
 	}
 }
 
@@ -25,6 +25,7 @@
 
 #include <SFML/Graphics.hpp>
 #include "fe_presentable.hpp"
+#include "fe_magic.hpp"
 #include "tp.hpp"
 
 class FeSettings;
@@ -57,6 +58,7 @@ public:
 	void set_scale_factor( float, float );
 
 	const sf::Drawable &drawable() const { return (const sf::Drawable &)*this; };
+	void batch( FeDrawBatch &b, const sf::RenderStates &states ) const;
 
 	int getIndexOffset() const;
 	void setIndexOffset( int );
@@ -127,6 +129,7 @@ private:
 	FeTextPrimitive m_draw_text;
 	std::string m_string;
 	std::string m_string_wrapped;
+	FeMagicTemplate m_template;
 	std::string m_font_name;
 	int m_index_offset;
 	int m_filter_offset;
@@ -36,6 +36,7 @@
 #include <cctype>
 #include <cstring>
 #include <regex>
+#include <mutex>
 
 #include <unistd.h>
 #include <sys/stat.h>
@@ -60,12 +61,20 @@
 #else
 #include <sys/wait.h>
 #include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <fcntl.h>
 #include <pwd.h>
 #include <signal.h>
 #include <errno.h>
 #include <wordexp.h>
 #endif
 
+#ifdef SFML_SYSTEM_LINUX
+#include <poll.h>
+#include <sys/inotify.h>
+#include <sys/syscall.h>
+#endif
+
 #ifdef SFML_SYSTEM_MACOS
 #include "fe_util_osx.hpp"
 #endif
@@ -268,6 +277,16 @@ time_t file_mtime( const std::string &file )
 	return ( buffer.st_mode == 0 ) ? 0 : buffer.st_mtime;
 }
 
+// Returns size of file
+std::uint64_t file_size( const std::string &file )
+{
+	nowide::stat_t buffer;
+	if ( nowide::stat( file.c_str(), &buffer ) != 0 )
+		return 0;
+
+	return buffer.st_size;
+}
+
 bool path_exists( const std::string &file )
 {
 	return check_path( file ) & ( FeVM::IsFile | FeVM::IsDirectory );
@@ -694,6 +713,70 @@ bool get_filename_from_base(
 
 bool token_helper( const std::string &from,
 	size_t &pos, std::string &token, const char *sep )
+{
+	return token_helper( from.data(), from.size(), pos, token, sep );
+}
+
+namespace
+{
+	//
+	// Character set searches over a length bounded buffer, with the same
+	// results as the std::string find functions.  Single character sets
+	// use memchr, which the C library vectorises
+	//
+	inline bool in_set( char c, const char *set )
+	{
+		for ( ; *set; set++ )
+			if ( *set == c ) return true;
+
+		return false;
+	}
+
+	size_t find_first_of( const char *from, size_t len, const char *set, size_t pos )
+	{
+		if ( pos >= len )
+			return std::string::npos;
+
+		if ( set[0] && !set[1] )
+		{
+			const char *p = (const char *)memchr( from + pos, set[0], len - pos );
+			return p ? p - from : std::string::npos;
+		}
+
+		for ( ; pos < len; pos++ )
+			if ( in_set( from[pos], set ) ) return pos;
+
+		return std::string::npos;
+	}
+
+	size_t find_first_not_of( const char *from, size_t len, const char *set, size_t pos )
+	{
+		for ( ; pos < len; pos++ )
+			if ( !in_set( from[pos], set ) ) return pos;
+
+		return std::string::npos;
+	}
+
+	size_t find_last_not_of( const char *from, size_t len, const char *set, size_t pos )
+	{
+		if ( len == 0 )
+			return std::string::npos;
+
+		if ( pos >= len )
+			pos = len - 1;
+
+		for ( ;; pos-- )
+		{
+			if ( !in_set( from[pos], set ) ) return pos;
+			if ( pos == 0 ) break;
+		}
+
+		return std::string::npos;
+	}
+}
+
+bool token_helper( const char *from, size_t len,
+	size_t &pos, std::string &token, const char *sep )
 {
 	bool retval( false ), in_quotes( false ), escaped( false );
 	size_t end;
@@ -701,11 +784,11 @@ bool token_helper( const std::string &from,
 	//
 	// Skip leading whitespace
 	//
-	pos = from.find_first_not_of( FE_WHITESPACE, pos );
+	pos = find_first_not_of( from, len, FE_WHITESPACE, pos );
 	if ( pos == std::string::npos )
 	{
 		token.clear();
-		pos = from.size();
+		pos = len;
 		return false;
 	}
 
@@ -718,23 +801,23 @@ bool token_helper( const std::string &from,
 		// Find the next quote character that is not preceded
 		// by a backslash
 		//
-		end = from.find_first_of( '"', pos );
+		end = find_first_of( from, len, "\"", pos );
 		while (( end != std::string::npos ) &&
 				( from[ end - 1 ] == '\\' ))
 		{
 			escaped = true;
-			end = from.find_first_of( '"', end + 1 );
+			end = find_first_of( from, len, "\"", end + 1 );
 		}
 	}
 	else
 	{
-		end = from.find_first_of( sep, pos );
+		end = find_first_of( from, len, sep, pos );
 	}
 
 	size_t old_pos = pos;
 	if ( end == std::string::npos )
 	{
-		pos = from.size();
+		pos = len;
 	}
 	else
 	{
@@ -748,7 +831,7 @@ bool token_helper( const std::string &from,
 
 	// clean out leading and trailing whitespace from token
 	//
-	size_t f = from.find_first_not_of( FE_WHITESPACE, old_pos );
+	size_t f = find_first_not_of( from, len, FE_WHITESPACE, old_pos );
 
 	if (( f == std::string::npos ) || ( f == end ))
 	{
@@ -756,8 +839,8 @@ bool token_helper( const std::string &from,
 	}
 	else
 	{
-		size_t l = from.find_last_not_of( FE_WHITESPACE, end-1 );
-		token = from.substr( f, l-f+1 );
+		size_t l = find_last_not_of( from, len, FE_WHITESPACE, end-1 );
+		token.assign( from + f, l-f+1 );
 	}
 
 	if ( escaped )
@@ -1120,6 +1203,207 @@ void windows_wait_process(
 
 #else
 
+#ifdef SFML_SYSTEM_LINUX
+namespace
+{
+	//
+	// Sleeps until the child process exits or there is input, instead of
+	// waking every POLL_FOR_EXIT_MS to check the hotkeys.  The process is
+	// watched with a pidfd (Linux 5.3 and later) and input with the
+	// /dev/input devices.  Devices plugged in while the game runs are
+	// opened when inotify reports them.  Without a pidfd or inotify, or
+	// while any input device can't be read (the user needs to be in the
+	// "input" group), waits still time out after POLL_FOR_EXIT_MS so that
+	// no hotkey press is missed
+	//
+	// The hotkey state is read through SFML, which on X11 asks the X server.
+	// The server may not have seen the event that woke us yet, so waits keep
+	// timing out after POLL_FOR_EXIT_MS for INPUT_SETTLE_MS after any input
+	//
+	const int INPUT_SETTLE_MS=300;
+
+	bool is_input_device( const char *name )
+	{
+		return ( strncmp( name, "event", 5 ) == 0 )
+			|| ( strncmp( name, "js", 2 ) == 0 );
+	}
+
+	class FeProcessWatch
+	{
+	public:
+		FeProcessWatch( pid_t pid, bool watch_input )
+			: m_inputs_begin( 0 ),
+			m_has_pidfd( false ),
+			m_has_inotify( false ),
+			m_settling( false )
+		{
+			if ( !watch_input )
+				return;
+
+#ifdef SYS_pidfd_open
+			int fd = (int)syscall( SYS_pidfd_open, pid, 0 );
+			if ( fd >= 0 )
+			{
+				add_fd( fd, "" );
+				m_has_pidfd = true;
+			}
+#endif
+
+			int ifd = inotify_init1( IN_NONBLOCK | IN_CLOEXEC );
+			if ( ifd >= 0 )
+			{
+				if ( inotify_add_watch( ifd, "/dev/input", IN_CREATE | IN_ATTRIB | IN_DELETE ) >= 0 )
+				{
+					add_fd( ifd, "" );
+					m_has_inotify = true;
+				}
+				else
+					close( ifd );
+			}
+
+			m_inputs_begin = m_fds.size();
+
+			DIR *dir = opendir( "/dev/input" );
+			if ( !dir )
+				return;
+
+			struct dirent *de;
+			while (( de = readdir( dir ) ) != NULL )
+			{
+				if ( is_input_device( de->d_name ))
+					open_device( de->d_name );
+			}
+			closedir( dir );
+
+			FeDebug() << "Watching process " << pid << ( m_has_pidfd ? " with" : " without" )
+				<< " pidfd, " << m_fds.size() - m_inputs_begin << " input devices"
+				<< ( m_has_inotify ? "" : " (no hotplug)" )
+				<< ( m_unreadable.empty() ? "" : " (some unreadable)" ) << std::endl;
+		}
+
+		~FeProcessWatch()
+		{
+			for ( std::vector<struct pollfd>::iterator itr=m_fds.begin(); itr!=m_fds.end(); ++itr )
+				close( (*itr).fd );
+		}
+
+		// Wait for the process to exit or for input
+		void wait()
+		{
+			if ( m_settling
+					&& ( m_settle_clock.getElapsedTime().asMilliseconds() >= INPUT_SETTLE_MS ))
+				m_settling = false;
+
+			int timeout = ( is_blocking() && !m_settling ) ? -1 : POLL_FOR_EXIT_MS;
+			if ( poll( m_fds.data(), m_fds.size(), timeout ) <= 0 )
+				return;
+
+			for ( size_t i=m_inputs_begin; i<m_fds.size(); )
+			{
+				if ( m_fds[i].revents & POLLIN )
+				{
+					// We only need to know that there was input, the hotkey
+					// state is read from SFML
+					char buf[1024];
+					while ( read( m_fds[i].fd, buf, sizeof( buf ) ) > 0 ) {}
+
+					m_settling = true;
+					m_settle_clock.restart();
+				}
+				else if ( m_fds[i].revents & ( POLLERR | POLLHUP | POLLNVAL ))
+				{
+					// Device unplugged.  If its node is still there, waits are
+					// timed until inotify reports it gone or it is opened again
+					if ( access( ( "/dev/input/" + m_names[i] ).c_str(), F_OK ) == 0 )
+						m_unreadable.insert( m_names[i] );
+
+					close( m_fds[i].fd );
+					m_fds.erase( m_fds.begin() + i );
+					m_names.erase( m_names.begin() + i );
+					continue;
+				}
+				i++;
+			}
+
+			if ( m_has_inotify && ( m_fds[m_inputs_begin-1].revents & POLLIN ))
+				read_hotplug( m_fds[m_inputs_begin-1].fd );
+		}
+
+		// Wait up to timeout_ms for the process to exit
+		void wait_for_exit( int timeout_ms )
+		{
+			if ( m_has_pidfd )
+				poll( m_fds.data(), 1, std::max( timeout_ms, 0 ) );
+			else
+				sf::sleep( sf::milliseconds( std::min( timeout_ms, POLL_FOR_EXIT_MS ) ) );
+		}
+
+	private:
+		// m_fds[0] is the pidfd if m_has_pidfd, followed by the inotify fd if
+		// m_has_inotify.  The input devices start at m_inputs_begin
+		std::vector<struct pollfd> m_fds;
+		std::vector<std::string> m_names; // device names, parallel to m_fds
+		std::set<std::string> m_unreadable; // devices that couldn't be opened
+		size_t m_inputs_begin;
+		bool m_has_pidfd;
+		bool m_has_inotify;
+		bool m_settling; // true while waits time out after input
+		sf::Clock m_settle_clock; // time since the last input
+
+		// true if waits have no timeout
+		bool is_blocking() const
+		{
+			return m_has_pidfd && m_has_inotify && m_unreadable.empty()
+				&& ( m_fds.size() > m_inputs_begin );
+		}
+
+		void add_fd( int fd, const std::string &name )
+		{
+			m_fds.push_back( { fd, POLLIN, 0 } );
+			m_names.push_back( name );
+		}
+
+		void open_device( const std::string &name )
+		{
+			if ( std::find( m_names.begin() + m_inputs_begin, m_names.end(), name ) != m_names.end() )
+				return;
+
+			std::string path = "/dev/input/" + name;
+			int fd = open( path.c_str(), O_RDONLY | O_NONBLOCK | O_CLOEXEC );
+			if ( fd >= 0 )
+			{
+				add_fd( fd, name );
+				m_unreadable.erase( name );
+			}
+			else
+				m_unreadable.insert( name ); // udev may not have set the permissions yet
+		}
+
+		void read_hotplug( int fd )
+		{
+			alignas( struct inotify_event ) char buf[4096];
+			ssize_t len;
+			while (( len = read( fd, buf, sizeof( buf ) ) ) > 0 )
+			{
+				for ( char *p = buf; p < buf + len; )
+				{
+					const struct inotify_event *ev = (const struct inotify_event *)p;
+					p += sizeof( struct inotify_event ) + ev->len;
+
+					if (( ev->len == 0 ) || !is_input_device( ev->name ))
+						continue;
+
+					if ( ev->mask & IN_DELETE )
+						m_unreadable.erase( ev->name );
+					else
+						open_device( ev->name );
+				}
+			}
+		}
+	};
+};
+#endif
+
 void unix_wait_process( unsigned int pid, run_program_options_class *opt )
 
 {
@@ -1130,6 +1414,13 @@ void unix_wait_process( unsigned int pid, run_program_options_class *opt )
 	FeInputMapEntry exit_is( opt->exit_hotkey );
 	FeInputMapEntry pause_is( opt->pause_hotkey );
 
+#ifdef SFML_SYSTEM_LINUX
+	FeProcessWatch watch( pid, k == WNOHANG );
+#endif
+
+	// Time since the last wake up, for the hotkey to signal latency
+	sf::Clock wake_clock;
+
 	while (1)
 	{
 		pid_t w = waitpid( pid, &status, k );
@@ -1147,8 +1438,9 @@ void unix_wait_process( unsigned int pid, run_program_options_class *opt )
 				sf::sleep( sf::milliseconds( 100 ) );
 				if ( kill( pid, 0 ) == 0 )
 				{
-					FeLog() << " - Exit Hotkey pressed, sending SIGTERM signal to process " << pid << std::endl;
 					kill( pid, SIGTERM );
+					FeLog() << " - Exit Hotkey pressed, sent SIGTERM signal to process " << pid
+						<< " (" << wake_clock.getElapsedTime().asMilliseconds() << "ms after input)" << std::endl;
 
 					//
 					// Give the process TERM_TIMEOUT ms to respond to sig term
@@ -1159,7 +1451,11 @@ void unix_wait_process( unsigned int pid, run_program_options_class *opt )
 					while (( term_clock.getElapsedTime().asMilliseconds() < TERM_TIMEOUT )
 						&& ( waitpid( pid, &status, WNOHANG ) == 0 ))
 					{
+#ifdef SFML_SYSTEM_LINUX
+						watch.wait_for_exit( TERM_TIMEOUT - term_clock.getElapsedTime().asMilliseconds() );
+#else
 						sf::sleep( sf::milliseconds( POLL_FOR_EXIT_MS ) );
+#endif
 					}
 
 					//
@@ -1203,10 +1499,17 @@ void unix_wait_process( unsigned int pid, run_program_options_class *opt )
 #endif
 				opt->running_pid = pid;
 				kill( pid, SIGSTOP );
+				FeDebug() << "Sent SIGSTOP " << wake_clock.getElapsedTime().asMilliseconds()
+					<< "ms after input" << std::endl;
 				break; // leave do/while loop
 			}
 
+#ifdef SFML_SYSTEM_LINUX
+			watch.wait();
+#else
 			sf::sleep( sf::milliseconds( POLL_FOR_EXIT_MS ) );
+#endif
+			wake_clock.restart();
 		}
 		else
 		{
@@ -1220,6 +1523,16 @@ void unix_wait_process( unsigned int pid, run_program_options_class *opt )
 }
 #endif
 
+namespace
+{
+	//
+	// Held while a program is being started, so that programs started
+	// from different threads don't inherit each other's output pipes (or
+	// on Windows, start in each other's working directory)
+	//
+	std::mutex g_spawn_mutex;
+};
+
 bool run_program( const std::string &prog,
 	const std::string &args,
 	const std::string &cwork_dir,
@@ -1259,6 +1572,8 @@ bool run_program( const std::string &prog,
 	ZeroMemory( &pi, sizeof(pi) );
 	si.cb = sizeof(si);
 
+	std::unique_lock<std::mutex> spawn_lock( g_spawn_mutex );
+
 	if (( NULL != callback )
 		&& CreatePipe( &child_output_read, &child_output_write, &satts, 0 ))
 	{
@@ -1296,6 +1611,8 @@ bool run_program( const std::string &prog,
 	if ( child_output_write )
 		CloseHandle( child_output_write );
 
+	spawn_lock.unlock();
+
 	//
 	// Cleanup our allocated values now
 	//
@@ -1381,6 +1698,7 @@ bool run_program( const std::string &prog,
 	wordexp_t we;
 
 	int mypipe[2] = { 0, 0 }; // mypipe[0] = read end, mypipe[1] = write end
+	std::unique_lock<std::mutex> spawn_lock( g_spawn_mutex );
 	if (( NULL != callback ) && block && ( pipe( mypipe ) ))
 		FeLog() << "Error, pipe() failed" << std::endl;
 
@@ -1432,10 +1750,14 @@ bool run_program( const std::string &prog,
 		_exit(127);
 
 	default: // parent process
+		if ( mypipe[0] )
+			close( mypipe[1] );
+
+		spawn_lock.unlock();
+
 		if ( mypipe[0] )
 		{
 			FILE *fp = fdopen( mypipe[0], "r" );
-			close( mypipe[1] );
 
 			const int BUFF_SIZE = 2048;
 			char buffer[ BUFF_SIZE ];
@@ -1862,6 +2184,131 @@ bool line_to_setting_and_value( const std::string &line,
 	return true;
 }
 
+FeMappedFile::FeMappedFile()
+	: m_data( NULL ),
+	m_size( 0 ),
+	m_mapped( false )
+#ifdef SFML_SYSTEM_WINDOWS
+	, m_file( INVALID_HANDLE_VALUE ),
+	m_mapping( NULL )
+#endif
+{
+}
+
+FeMappedFile::~FeMappedFile()
+{
+	close();
+}
+
+bool FeMappedFile::open( const std::string &filename )
+{
+	close();
+
+#ifdef SFML_SYSTEM_WINDOWS
+	m_file = CreateFileW( nowide::widen( filename ).c_str(), GENERIC_READ, FILE_SHARE_READ,
+		NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL );
+
+	if ( m_file != INVALID_HANDLE_VALUE )
+	{
+		LARGE_INTEGER size;
+		size.QuadPart = -1;
+		GetFileSizeEx( m_file, &size );
+
+		if ( size.QuadPart == 0 )
+		{
+			// Nothing to map
+			CloseHandle( m_file );
+			m_file = INVALID_HANDLE_VALUE;
+			return true;
+		}
+
+		if ( size.QuadPart > 0 )
+			m_mapping = CreateFileMappingW( m_file, NULL, PAGE_READONLY, 0, 0, NULL );
+		if ( m_mapping )
+		{
+			m_data = (const char *)MapViewOfFile( m_mapping, FILE_MAP_READ, 0, 0, 0 );
+			if ( m_data )
+			{
+				m_size = (size_t)size.QuadPart;
+				m_mapped = true;
+				return true;
+			}
+		}
+	}
+#else
+	int fd = ::open( filename.c_str(), O_RDONLY );
+	if ( fd >= 0 )
+	{
+		struct stat st;
+		void *addr = MAP_FAILED;
+
+		if ( fstat( fd, &st ) == 0 )
+		{
+			if ( st.st_size == 0 )
+			{
+				// Nothing to map
+				::close( fd );
+				return true;
+			}
+
+			if ( S_ISREG( st.st_mode ))
+				addr = mmap( NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0 );
+		}
+
+		::close( fd );
+
+		if ( addr != MAP_FAILED )
+		{
+			madvise( addr, st.st_size, MADV_SEQUENTIAL );
+			m_data = (const char *)addr;
+			m_size = st.st_size;
+			m_mapped = true;
+			return true;
+		}
+	}
+#endif
+
+	close();
+
+	// Fall back to reading the whole file
+	nowide::ifstream file( filename, std::ios::binary );
+	if ( !file.is_open() )
+		return false;
+
+	m_buffer.assign( std::istreambuf_iterator<char>( file ), std::istreambuf_iterator<char>() );
+	m_data = m_buffer.data();
+	m_size = m_buffer.size();
+	return true;
+}
+
+void FeMappedFile::close()
+{
+	if ( m_mapped )
+	{
+#ifdef SFML_SYSTEM_WINDOWS
+		UnmapViewOfFile( m_data );
+#else
+		munmap( (void *)m_data, m_size );
+#endif
+	}
+
+#ifdef SFML_SYSTEM_WINDOWS
+	if ( m_mapping )
+		CloseHandle( m_mapping );
+
+	if ( m_file != INVALID_HANDLE_VALUE )
+		CloseHandle( m_file );
+
+	m_mapping = NULL;
+	m_file = INVALID_HANDLE_VALUE;
+#endif
+
+	m_buffer.clear();
+	m_data = NULL;
+	m_size = 0;
+	m_mapped = false;
+}
+
 bool get_console_stdin( std::string &str )
 {
 //
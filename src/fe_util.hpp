@@ -50,6 +50,10 @@ namespace FeUtil
 bool token_helper( const std::string &from,
 	size_t &pos, std::string &token, const char *sep=";" );
 
+// As above, for the "len" characters at "from" (which needn't be terminated)
+bool token_helper( const char *from, size_t len,
+	size_t &pos, std::string &token, const char *sep=";" );
+
 //
 // Substitute all occurrences of "from" that appear in "target" with the text from "to"
 // - Returns the number of substitutions made
@@ -193,6 +197,9 @@ std::string sanitize_filename( const std::string &file );
 // Returns the modified time of the file
 time_t file_mtime( const std::string &file );
 
+// Returns the size of the file in bytes, 0 if it doesn't exist
+std::uint64_t file_size( const std::string &file );
+
 // return true if path exists (file or directory)
 bool path_exists( const std::string &file );
 
@@ -401,6 +408,36 @@ bool line_to_setting_and_value( const std::string &line,
 // return the name of the process that currently has window focus
 std::string get_focus_process();
 
+//
+// Read-only view of a whole file, memory mapped where possible and read
+// into memory otherwise
+//
+class FeMappedFile
+{
+public:
+	FeMappedFile();
+	~FeMappedFile();
+
+	bool open( const std::string &filename );
+	void close();
+
+	const char *data() const { return m_data; };
+	size_t size() const { return m_size; };
+
+private:
+	FeMappedFile( const FeMappedFile & );
+	FeMappedFile &operator=( const FeMappedFile & );
+
+	const char *m_data;
+	size_t m_size;
+	bool m_mapped;
+	std::vector<char> m_buffer;
+#ifdef SFML_SYSTEM_WINDOWS
+	void *m_file;
+	void *m_mapping;
+#endif
+};
+
 //
 // Non-blocking check for input on stdin
 // return true if input found, false otherwise
@@ -23,6 +23,7 @@
 #include "fe_util_sq.hpp"
 #include "fe_util.hpp" // perform_substitution
 #include <sqrat.h>
+#include <map>
 
 // Convert SQChar to std::string
 std::string scstdstr( const SQChar* s )
@@ -305,3 +306,74 @@ std::string fe_to_json_string( HSQOBJECT obj, int indent )
 	return retval;
 }
 
+namespace
+{
+	// Kept per vm, so closing a temporary vm leaves the caches of the
+	// others alone.  An entry outlives its vm, as a new vm can be created
+	// at the same address
+	std::map<HSQUIRRELVM, unsigned int> g_vm_generation;
+}
+
+void fe_sq_vm_closed( HSQUIRRELVM vm )
+{
+	g_vm_generation[ vm ]++;
+}
+
+unsigned int fe_sq_vm_generation( HSQUIRRELVM vm )
+{
+	std::map<HSQUIRRELVM, unsigned int>::const_iterator itr = g_vm_generation.find( vm );
+	return ( itr == g_vm_generation.end() ) ? 0 : (*itr).second;
+}
+
+FeSqArrayCache::FeSqArrayCache()
+	: m_vm( NULL ),
+	m_generation( 0 )
+{
+	sq_resetobject( &m_obj );
+}
+
+FeSqArrayCache::~FeSqArrayCache()
+{
+	release();
+}
+
+void FeSqArrayCache::release()
+{
+	if ( m_vm && ( m_generation == fe_sq_vm_generation( m_vm ) ))
+		sq_release( m_vm, &m_obj );
+
+	m_vm = NULL;
+	sq_resetobject( &m_obj );
+}
+
+HSQOBJECT FeSqArrayCache::fill( HSQUIRRELVM vm, const float *values, int count, int size )
+{
+	if (( m_vm != vm ) || ( m_generation != fe_sq_vm_generation( vm ) ))
+	{
+		release();
+
+		sq_newarray( vm, size );
+		sq_getstackobj( vm, -1, &m_obj );
+		sq_addref( vm, &m_obj );
+		sq_pop( vm, 1 );
+
+		m_vm = vm;
+		m_generation = fe_sq_vm_generation( vm );
+	}
+
+	sq_pushobject( vm, m_obj );
+
+	// Scripts are free to modify the array they were given
+	if ( sq_getsize( vm, -1 ) != size )
+		sq_arrayresize( vm, -1, size );
+
+	for ( int i=0; i<size; i++ )
+	{
+		sq_pushinteger( vm, i );
+		sq_pushfloat( vm, ( i < count ) ? values[i] : 0.0f );
+		sq_set( vm, -3 );
+	}
+
+	sq_pop( vm, 1 );
+	return m_obj;
+}
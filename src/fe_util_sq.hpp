@@ -77,4 +77,38 @@ void fe_register_global_func(
 
 std::string fe_to_json_string( HSQOBJECT obj, int indent=0 );
 
+//
+// Incremented whenever the given squirrel vm is closed.  Native code that
+// keeps references to script objects compares against the generation of
+// their vm before using or releasing them
+//
+void fe_sq_vm_closed( HSQUIRRELVM vm );
+unsigned int fe_sq_vm_generation( HSQUIRRELVM vm );
+
+//
+// Holds a squirrel array that native code refills in place, so values that
+// scripts read every frame don't need a new array each time.  The reference
+// is dropped without being released if its vm has since been closed.
+//
+class FeSqArrayCache
+{
+public:
+	FeSqArrayCache();
+	~FeSqArrayCache();
+
+	// Return the cached array (created in "vm" if needed) with "size"
+	// entries, the first "count" set from "values" and the rest zero
+	HSQOBJECT fill( HSQUIRRELVM vm, const float *values, int count, int size );
+
+private:
+	FeSqArrayCache( const FeSqArrayCache & );
+	FeSqArrayCache &operator=( const FeSqArrayCache & );
+
+	void release();
+
+	HSQUIRRELVM m_vm;
+	HSQOBJECT m_obj;
+	unsigned int m_generation;
+};
+
 #endif
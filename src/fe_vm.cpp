@@ -42,6 +42,9 @@
 
 #include "fe_util.hpp"
 #include "fe_util_sq.hpp"
+#include "fe_cache.hpp"
+#include "fe_profiler.hpp"
+#include "fe_frametime.hpp"
 #include "image_loader.hpp"
 #include "zip.hpp"
 
@@ -59,6 +62,8 @@
 #include <ctime>
 #include <stdarg.h>
 #include <algorithm>
+#include <chrono>
+#include <cstring>
 
 const char *FE_SCRIPT_NV_FILE = "script.nv";
 
@@ -97,6 +102,177 @@ namespace
 		return false;
 	}
 
+	//
+	// Compiled scripts are cached, keyed by the script's path, size and
+	// modified time.  Squirrel substitutes constants and enums into the
+	// bytecode when compiling, so the cache is also keyed by a hash of the
+	// const table at compile time.
+	//
+	std::uint32_t hash_bytes( const void *data, size_t len, std::uint32_t hash )
+	{
+		// FNV-1a
+		const unsigned char *p = (const unsigned char *)data;
+		for ( size_t i=0; i<len; i++ )
+		{
+			hash ^= p[i];
+			hash *= 16777619u;
+		}
+		return hash;
+	}
+
+	std::uint32_t hash_table( HSQUIRRELVM vm );
+
+	std::uint32_t hash_value( HSQUIRRELVM vm, SQInteger idx, std::uint32_t hash )
+	{
+		SQObjectType t = sq_gettype( vm, idx );
+		hash = hash_bytes( &t, sizeof( t ), hash );
+
+		switch ( t )
+		{
+		case OT_INTEGER:
+			{
+				SQInteger i;
+				sq_getinteger( vm, idx, &i );
+				return hash_bytes( &i, sizeof( i ), hash );
+			}
+		case OT_FLOAT:
+			{
+				SQFloat f;
+				sq_getfloat( vm, idx, &f );
+				return hash_bytes( &f, sizeof( f ), hash );
+			}
+		case OT_BOOL:
+			{
+				SQBool b;
+				sq_getbool( vm, idx, &b );
+				return hash_bytes( &b, sizeof( b ), hash );
+			}
+		case OT_STRING:
+			{
+				const SQChar *str;
+				sq_getstring( vm, idx, &str );
+				return hash_bytes( str, sq_getsize( vm, idx ) * sizeof( SQChar ), hash );
+			}
+		case OT_TABLE: // enum
+			{
+				sq_push( vm, idx );
+				hash ^= hash_table( vm );
+				sq_pop( vm, 1 );
+				return hash;
+			}
+		default:
+			return hash;
+		}
+	}
+
+	// Hash the table on top of the stack, independent of iteration order
+	std::uint32_t hash_table( HSQUIRRELVM vm )
+	{
+		std::uint32_t hash = 0;
+
+		sq_pushnull( vm );
+		while ( SQ_SUCCEEDED( sq_next( vm, -2 ) ))
+		{
+			hash += hash_value( vm, -1, hash_value( vm, -2, 2166136261u ) );
+			sq_pop( vm, 2 );
+		}
+		sq_pop( vm, 1 );
+
+		return hash;
+	}
+
+	std::uint32_t hash_const_table( HSQUIRRELVM vm )
+	{
+		sq_pushconsttable( vm );
+		std::uint32_t hash = hash_table( vm );
+		sq_pop( vm, 1 );
+		return hash;
+	}
+
+	const std::uint32_t SCRIPT_INTERPRETER = SQUIRREL_VERSION_NUMBER * 1000
+		+ sizeof( SQInteger ) * 100 + sizeof( SQFloat ) * 10 + sizeof( SQChar );
+
+	struct ScriptStream
+	{
+		std::vector<std::uint8_t> &data;
+		size_t pos;
+	};
+
+	SQInteger script_write( SQUserPointer up, SQUserPointer src, SQInteger size )
+	{
+		std::vector<std::uint8_t> &data = ((ScriptStream *)up)->data;
+		data.insert( data.end(), (std::uint8_t *)src, (std::uint8_t *)src + size );
+		return size;
+	}
+
+	SQInteger script_read( SQUserPointer up, SQUserPointer dest, SQInteger size )
+	{
+		ScriptStream &s = *(ScriptStream *)up;
+		if ( s.pos + size > s.data.size() )
+			return -1;
+
+		memcpy( dest, s.data.data() + s.pos, size );
+		s.pos += size;
+		return size;
+	}
+
+	double elapsed_ms( const std::chrono::steady_clock::time_point &start )
+	{
+		return std::chrono::duration<double, std::milli>(
+			std::chrono::steady_clock::now() - start ).count();
+	}
+
+	//
+	// Push the closure for the script at path, from the cache if it is
+	// current, otherwise compiled from source.  Throws on compile errors
+	//
+	void compile_script( HSQUIRRELVM vm, const std::string &path )
+	{
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+		FeCacheScript script;
+		script.path = path;
+		script.mtime = file_mtime( path );
+		script.size = file_size( path );
+		script.interpreter = SCRIPT_INTERPRETER;
+		script.consts = hash_const_table( vm );
+
+		FeCacheScript cached;
+		if ( FeCache::load_script( path, script.consts, cached )
+			&& ( cached.path == script.path )
+			&& ( cached.mtime == script.mtime )
+			&& ( cached.size == script.size )
+			&& ( cached.interpreter == script.interpreter )
+			&& ( cached.consts == script.consts ))
+		{
+			ScriptStream in = { cached.bytecode, 0 };
+			if ( SQ_SUCCEEDED( sq_readclosure( vm, script_read, &in ) ))
+			{
+				FeDebug() << "Loaded cached script: " << path
+					<< " (" << elapsed_ms( start ) << " ms)" << std::endl;
+				return;
+			}
+		}
+
+		if ( SQ_FAILED( sqstd_loadfile( vm, path.c_str(), SQTrue ) ))
+			throw Sqrat::Exception( Sqrat::LastErrorString( vm ) );
+
+		FeDebug() << "Compiled script: " << path
+			<< " (" << elapsed_ms( start ) << " ms)" << std::endl;
+
+		//
+		// Constants and enums are added to the const table by the compiler,
+		// running cached bytecode wouldn't declare them, so scripts that
+		// declare any aren't cached
+		//
+		if ( hash_const_table( vm ) != script.consts )
+			return;
+
+		ScriptStream out = { script.bytecode, 0 };
+		if ( SQ_SUCCEEDED( sq_writeclosure( vm, script_write, &out ) ))
+			FeCache::save_script( script );
+	}
+
 	bool run_script( const std::string &path,
 		const std::string &filename,
 		bool silent=false )
@@ -104,16 +280,22 @@ namespace
 		std::string path_to_run=path;
 		try
 		{
-			Sqrat::Script sc;
+			HSQUIRRELVM vm = Sqrat::DefaultVM::Get();
 			path_to_run += filename;
 
 			if ( !path_exists( path_to_run ) )
 				return false;
 
-			sc.CompileFile( path_to_run );
+			compile_script( vm, path_to_run );
 
 			FeDebug() << "Running script: " << path_to_run << std::endl;
-			sc.Run();
+			sq_pushroottable( vm );
+			SQRESULT result = sq_call( vm, 1, SQFalse, SQTrue );
+			sq_pop( vm, 1 );
+
+			if ( SQ_FAILED( result ))
+				throw Sqrat::Exception( Sqrat::LastErrorString( vm ) );
+
 			FeDebug() << "Done script: " << path_to_run << std::endl;
 		}
 		catch( const Sqrat::Exception &e )
@@ -289,6 +471,11 @@ FeVM::FeVM( FeSettings &fes, FeWindow &wnd, FeMusic &ambient_sound, bool console
 	m_ambient_sound( ambient_sound ),
 	m_redraw_triggered( false ),
 	m_sort_zorder_triggered( false ),
+	m_in_tick( false ),
+	m_held_display( -1 ),
+	m_held_display_stack( false ),
+	m_held_display_reload( false ),
+	m_held_reset_window( false ),
 	m_process_console_input( console_input ),
 	m_script_cfg( NULL ),
 	m_script_id( -1 )
@@ -355,9 +542,10 @@ void FeVM::post_command( FeInputMap::Command c )
 	m_posted_commands.push( c );
 }
 
-bool FeVM::poll_command( FeInputMap::Command &c, std::optional<sf::Event> &ev, bool &from_ui )
+bool FeVM::poll_command( FeInputMap::Command &c, std::optional<sf::Event> &ev, bool &from_ui, FeWindow::EventTime &when )
 {
 	from_ui = false;
+	when = std::chrono::steady_clock::now();
 
 	if ( !m_posted_commands.empty() )
 	{
@@ -370,6 +558,7 @@ bool FeVM::poll_command( FeInputMap::Command &c, std::optional<sf::Event> &ev, b
 		if ( event.has_value() )
 		{
 			ev = event;
+			when = m_window.get_event_time();
 			int t = m_layout_time.getElapsedTime().asMilliseconds();
 
 			// Debounce to stop multiples when triggered by a key combo
@@ -444,6 +633,7 @@ void FeVM::vm_close()
 	HSQUIRRELVM vm = Sqrat::DefaultVM::Get();
 	if ( vm )
 	{
+		fe_sq_vm_closed( vm );
 		sq_close( vm );
 		Sqrat::DefaultVM::Set( NULL );
 	}
@@ -930,6 +1120,11 @@ bool FeVM::on_new_layout()
 		.Prop(_SC("preserve_aspect_ratio"), &FePresent::get_preserve_aspect_ratio, &FePresent::set_preserve_aspect_ratio )
 		.Prop(_SC("time"), &FePresent::get_layout_ms )
 		.Prop(_SC("frame_time"), &FePresent::get_layout_frame_time )
+		.Prop(_SC("draw_calls"), &FePresent::get_draw_calls )
+		.Prop(_SC("draw_batched"), &FePresent::get_draw_batched )
+		.Prop(_SC("texture_binds"), &FePresent::get_texture_binds )
+		.Prop(_SC("surfaces_rendered"), &FePresent::get_surfaces_rendered )
+		.Prop(_SC("surfaces_skipped"), &FePresent::get_surfaces_skipped )
 		.Prop(_SC("mouse_pointer"), &FePresent::get_mouse_pointer, &FePresent::set_mouse_pointer )
 		.Func(_SC("redraw"), &FePresent::redraw )
 	);
@@ -942,6 +1137,8 @@ bool FeVM::on_new_layout()
 		.Prop( _SC("search_rule"), &FePresent::get_search_rule, &FePresent::set_search_rule )
 		.Prop( _SC("size"), &FePresent::get_current_filter_size )
 		.Prop( _SC("clones_list"), &FePresent::get_clones_list_showing )
+		.Prop( _SC("loading"), &FePresent::get_list_loading )
+		.Prop( _SC("progress"), &FePresent::get_list_progress )
 
 		// The following are deprecated as of version 1.5 in favour of using the fe.filters array:
 		.Prop( _SC("filter"), &FePresent::get_filter_name )	// deprecated as of 1.5
@@ -1057,6 +1254,31 @@ bool FeVM::on_new_layout()
 		.Func( _SC("name_at"), &FeImageLoader::cache_get_name_at )
 		.Func( _SC("size_at"), &FeImageLoader::cache_get_size_at )
 		.Prop( _SC("bg_load"), &FeImageLoader::get_background_loading, &FeImageLoader::set_background_loading )
+		.Prop( _SC("atlas_max"), &FeImageLoader::get_atlas_max, &FeImageLoader::set_atlas_max )
+		.Prop( _SC("atlas_pages"), &FeImageLoader::atlas_pages )
+		.Prop( _SC("atlas_count"), &FeImageLoader::atlas_count )
+		.Prop( _SC("atlas_usage"), &FeImageLoader::atlas_usage )
+		.Prop( _SC("atlas_upload_time"), &FeImageLoader::atlas_upload_time )
+	);
+
+	fe.Bind( _SC("Profiler"), Class <FeScriptProfiler, NoConstructor>()
+		.Prop( _SC("enabled"), &FeScriptProfiler::is_enabled, &FeScriptProfiler::set_enabled )
+		.Prop( _SC("count"), &FeScriptProfiler::get_count )
+		.Prop( _SC("frames"), &FeScriptProfiler::get_frames )
+		.Prop( _SC("frame_time"), &FeScriptProfiler::get_frame_avg )
+		.Prop( _SC("frame_time_p99"), &FeScriptProfiler::get_frame_p99 )
+		.Prop( _SC("frame_allocs"), &FeScriptProfiler::get_frame_allocs )
+		.Prop( _SC("frame_alloc_kb"), &FeScriptProfiler::get_frame_alloc_kb )
+		.Func( _SC("type_at"), &FeScriptProfiler::get_type_at )
+		.Func( _SC("name_at"), &FeScriptProfiler::get_name_at )
+		.Func( _SC("script_at"), &FeScriptProfiler::get_script_at )
+		.Func( _SC("calls_at"), &FeScriptProfiler::get_calls_at )
+		.Func( _SC("min_at"), &FeScriptProfiler::get_min_at )
+		.Func( _SC("avg_at"), &FeScriptProfiler::get_avg_at )
+		.Func( _SC("p99_at"), &FeScriptProfiler::get_p99_at )
+		.Func( _SC("max_at"), &FeScriptProfiler::get_max_at )
+		.Func( _SC("reset"), &FeScriptProfiler::reset )
+		.Func( _SC("dump"), &FeScriptProfiler::dump )
 	);
 
 	//
@@ -1102,6 +1324,7 @@ bool FeVM::on_new_layout()
 	fe.Overload<const char* (*)(int)>(_SC("game_info"), &FeVM::cb_game_info);
 	fe.Overload<const char* (*)(int, int)>(_SC("game_info"), &FeVM::cb_game_info);
 	fe.Overload<const char* (*)(int, int, int)>(_SC("game_info"), &FeVM::cb_game_info);
+	fe.SquirrelFunc( _SC("game_info_range"), &FeVM::cb_game_info_range );
 	fe.Overload<const char* (*)(const char *, int, int, int)>(_SC("get_art"), &FeVM::cb_get_art);
 	fe.Overload<const char* (*)(const char *, int, int)>(_SC("get_art"), &FeVM::cb_get_art);
 	fe.Overload<const char* (*)(const char *, int)>(_SC("get_art"), &FeVM::cb_get_art);
@@ -1170,6 +1393,7 @@ bool FeVM::on_new_layout()
 
 	FeImageLoader &il = FeImageLoader::get_ref();
 	fe.SetInstance( _SC("image_cache"), &il );
+	fe.SetInstance( _SC("profiler"), &FeScriptProfiler::get_ref() );
 	fe.SetValue( _SC("plugin"), Table() ); // an empty table for plugins to use/abuse
 
 	// We keep a "non-volatile" table for use by layouts/plugins, the
@@ -1323,6 +1547,16 @@ bool FeVM::process_console_input()
 bool FeVM::on_tick()
 {
 	using namespace Sqrat;
+
+	//
+	// A tick callback can start a transition (by changing the selection),
+	// and transitions run the tick callbacks on each frame.  Don't run
+	// them again while they are already running
+	//
+	if ( m_in_tick )
+		return false;
+
+	FeScriptProfiler::get_ref().end_frame();
 	m_redraw_triggered = process_console_input();
 
 	if ( m_sort_zorder_triggered )
@@ -1331,6 +1565,7 @@ bool FeVM::on_tick()
 		m_sort_zorder_triggered = false;
 	}
 
+	m_in_tick = true;
 	for ( std::vector<FeCallback>::iterator itr = m_ticks.begin();
 		itr != m_ticks.end(); )
 	{
@@ -1342,6 +1577,7 @@ bool FeVM::on_tick()
 		bool remove=false;
 		try
 		{
+			FeProfileTimer pt( FeScriptProfiler::Tick, (*itr).m_fn, (*itr).m_file );
 			Function &func = (*itr).get_fn();
 			if ( !func.IsNull() )
 				func.Execute( m_layout_time.getElapsedTime().asMilliseconds() );
@@ -1362,6 +1598,7 @@ bool FeVM::on_tick()
 		else
 			++itr;
 	}
+	m_in_tick = false;
 
 	m_layout_time.tick();
 
@@ -1379,6 +1616,10 @@ void FeVM::on_transition(
 	FeStableClock clk;
 	int ttime = 0;
 
+	int frames = 0;
+	sf::Clock frame_clock;
+	sf::Time longest;
+
 	std::vector<FeCallback *> worklist( m_trans.size() );
 	for ( unsigned int i=0; i < m_trans.size(); i++ )
 		worklist[i] = &(m_trans[i]);
@@ -1404,6 +1645,7 @@ void FeVM::on_transition(
 			bool keep=false;
 			try
 			{
+				FeProfileTimer pt( FeScriptProfiler::Transition, (*itr)->m_fn, (*itr)->m_file );
 				Function &func = (*itr)->get_fn();
 				if ( !func.IsNull() )
 				{
@@ -1429,33 +1671,93 @@ void FeVM::on_transition(
 		//
 		if (( !worklist.empty() ) && ( m_window.isOpen() ))
 		{
-			video_tick();
+			FeFrameTimer &ft = FeFrameTimer::get_ref();
+			ft.begin_frame();
+
+			//
+			// Run the same frame as the main loop, so that tick callbacks,
+			// videos and background image loads carry on during the
+			// transition.  List changes made by the tick callbacks are
+			// held until the main loop applies them.  on_tick() advances
+			// the layout clock, unless the transition was started by a
+			// tick callback and the callbacks aren't run again
+			//
+			bool clock_ticked = false;
+			if ( is_layout_loaded() )
+			{
+				clock_ticked = !m_in_tick;
+				bool hold = m_hold_changes;
+				m_hold_changes = true;
+				tick();
+				m_hold_changes = hold;
+			}
+			else
+				video_tick();
+
 			clk.tick();
 
 			redraw_surfaces();
+			ft.mark( FeFrameTimer::Surfaces );
+
 			m_window.clear();
 			m_window.draw( *this );
+			ft.draw_overlay( m_window.get_win(), get_default_font() );
+			ft.mark( FeFrameTimer::Draw );
+
 			m_window.display();
+			ft.mark( FeFrameTimer::Present );
+
 			ttime = clk.getElapsedTime().asMilliseconds();
-			m_layout_time.tick();
+			if ( !clock_ticked )
+				m_layout_time.tick();
 
-#ifdef SFML_SYSTEM_LINUX
 			//
-			// On SFML 2.2-2.3 Linux, I am getting flicker on a
-			// multi monitor setup during animated transitions.
-			// Processing window events between each draw fixes
-			// it.
+			// Process window events between draws, which stops flicker
+			// during animated transitions on multi monitor Linux setups.
+			// The events are kept for the main loop so no input is lost
 			//
-			// TODO: It is probably a good idea to do this for
-			// every platform... needs investigation.
-			//
-			while ( const std::optional ev = m_window.pollEvent() )
-			{
-				//sf::sleep( sf::milliseconds( 10 ) );
-			}
-#endif
+			m_window.queue_events();
+
+			frames++;
+			longest = std::max( longest, frame_clock.restart() );
 		}
 	}
+
+	if ( !m_trans.empty() )
+	{
+		sf::Time duration = sf::milliseconds( ttime );
+		FeFrameTimer::get_ref().add_transition( transitionTypeStrings[t], frames, duration, longest );
+
+		FeDebug() << "[Transition] " << transitionTypeStrings[t] << " done, " << frames
+			<< " frames in " << ttime << "ms, longest frame "
+			<< longest.asMilliseconds() << "ms" << std::endl;
+	}
+
+}
+
+bool FeVM::apply_held_changes()
+{
+	bool retval = false;
+
+	if ( m_held_reset_window )
+	{
+		m_held_reset_window = false;
+		cb_signal( "reset_window" );
+		retval = true;
+	}
+
+	if ( apply_held_list_changes() )
+		retval = true;
+
+	if ( m_held_display >= 0 )
+	{
+		int idx = m_held_display;
+		m_held_display = -1;
+		cb_set_display( idx, m_held_display_stack, m_held_display_reload );
+		retval = true;
+	}
+
+	return retval;
 }
 
 bool FeVM::script_handle_event( FeInputMap::Command c )
@@ -1472,6 +1774,7 @@ bool FeVM::script_handle_event( FeInputMap::Command c )
 
 		try
 		{
+			FeProfileTimer pt( FeScriptProfiler::Signal, (*itr).m_fn, (*itr).m_file );
 			Function &func = (*itr).get_fn();
 			if (( !func.IsNull() )
 					&& ( func.Evaluate<bool>( FeInputMap::commandStrings[ c ] )))
@@ -1650,6 +1953,7 @@ void FePresent::script_process_magic_strings( std::string &str,
 			Sqrat::Function func( Sqrat::RootTable(), magic.c_str() );
 			if ( !func.IsNull() )
 			{
+				FeProfileTimer pt( FeScriptProfiler::Magic, magic );
 				std::string result;
 
 				switch ( fe_get_num_params( vm, func.GetFunc(), func.GetEnv() ) )
@@ -1866,6 +2170,7 @@ public:
 	{
 		// reset to our usual VM and close the temp vm
 		Sqrat::DefaultVM::Set( m_stored_vm );
+		fe_sq_vm_closed( m_vm );
 		sq_close( m_vm );
 	};
 
@@ -2649,6 +2954,123 @@ const char *FeVM::cb_game_info( int index )
 	return cb_game_info( index, 0, 0 );
 }
 
+//
+// fe.game_info_range( fields, offset, count [, filter_offset [, rows]] )
+//
+// Return an array of count rows starting at offset, each row an array
+// with a value for each entry in fields.  Integer fields are Info
+// values as used by game_info(), string fields are artwork labels
+// resolved as get_art() does.  If rows is an array it is filled and
+// returned instead of a new array, reusing its row arrays.
+//
+SQInteger FeVM::cb_game_info_range( HSQUIRRELVM vm )
+{
+	SQInteger top = sq_gettop( vm );
+	if (( top < 4 ) || ( top > 6 ))
+		return sq_throwerror( vm, "game_info_range(): 3 to 5 parameters expected" );
+
+	if ( sq_gettype( vm, 2 ) != OT_ARRAY )
+		return sq_throwerror( vm, "game_info_range(): fields must be an array" );
+
+	SQInteger offset, count, filter_offset=0;
+	if ( SQ_FAILED( sq_getinteger( vm, 3, &offset ))
+			|| SQ_FAILED( sq_getinteger( vm, 4, &count ))
+			|| (( top >= 5 ) && SQ_FAILED( sq_getinteger( vm, 5, &filter_offset ))))
+		return sq_throwerror( vm, "game_info_range(): incorrect parameter" );
+
+	if ( count < 0 )
+		count = 0;
+
+	struct Field
+	{
+		int index;
+		std::string art; // artwork label if index < 0
+	};
+
+	std::vector<Field> fields( sq_getsize( vm, 2 ) );
+	for ( int f=0; f<(int)fields.size(); f++ )
+	{
+		sq_pushinteger( vm, f );
+		sq_get( vm, 2 );
+
+		SQInteger i;
+		const SQChar *str;
+		if ( SQ_SUCCEEDED( sq_getinteger( vm, -1, &i ) )
+				&& ( i >= 0 ) && ( i <= FeRomInfo::LAST_INDEX+3 ))
+			fields[f].index = i;
+		else if ( SQ_SUCCEEDED( sq_getstring( vm, -1, &str ) ))
+		{
+			fields[f].index = -1;
+			fields[f].art = str;
+		}
+		else
+		{
+			sq_pop( vm, 1 );
+			return sq_throwerror( vm, "game_info_range(): fields must be Info values or artwork labels" );
+		}
+
+		sq_pop( vm, 1 );
+	}
+
+	FeVM *fev = (FeVM *)sq_getforeignptr( vm );
+	FeSettings *fes = fev->m_feSettings;
+	int filter_index = fes->get_filter_index_from_offset( filter_offset );
+
+	if (( top >= 6 ) && ( sq_gettype( vm, 6 ) == OT_ARRAY ))
+		sq_push( vm, 6 );
+	else
+		sq_newarray( vm, 0 );
+
+	sq_arrayresize( vm, -1, count );
+
+	for ( SQInteger r=0; r<count; r++ )
+	{
+		sq_pushinteger( vm, r );
+		if ( SQ_FAILED( sq_get( vm, -2 ) ))
+			sq_pushnull( vm );
+
+		if ( sq_gettype( vm, -1 ) != OT_ARRAY )
+		{
+			sq_pop( vm, 1 );
+			sq_newarray( vm, 0 );
+		}
+
+		sq_arrayresize( vm, -1, fields.size() );
+
+		int rom_index = fes->get_rom_index( filter_index, offset + r );
+		FeRomInfo *rom = NULL;
+
+		for ( int f=0; f<(int)fields.size(); f++ )
+		{
+			const Field &fd = fields[f];
+			const char *value;
+
+			if ( fd.index < 0 )
+			{
+				if ( !rom )
+					rom = fes->get_rom_absolute( filter_index, rom_index );
+
+				value = rom ? fes->get_cached_artwork_file( *rom, fd.art, false ).c_str() : "";
+			}
+			else if ( fd.index < FeRomInfo::LAST_INDEX )
+				value = fes->get_rom_info_absolute( filter_index, rom_index, (FeRomInfo::Index)fd.index ).c_str();
+			else
+				value = cb_game_info( fd.index, offset + r, filter_offset );
+
+			sq_pushinteger( vm, f );
+			sq_pushstring( vm, value, -1 );
+			sq_set( vm, -3 );
+		}
+
+		sq_pushinteger( vm, r );
+		sq_push( vm, -2 );
+		sq_set( vm, -4 );
+		sq_pop( vm, 1 );
+	}
+
+	return 1;
+}
+
 const char *FeVM::cb_get_art( const char *art, int index_offset, int filter_offset, int art_flags )
 {
 	HSQUIRRELVM vm = Sqrat::DefaultVM::Get();
@@ -2665,6 +3087,15 @@ const char *FeVM::cb_get_art( const char *art, int index_offset, int filter_offs
 	if ( !rom )
 		return retval.c_str();
 
+	// We force our return value to an absolute path, to work
+	// around Attract-Mode's tendency to assume that relative
+	// paths are relative to the layout directory.
+	//
+	// We are almost certain that is not the case here...
+	//
+	if ( !(art_flags&AF_FullList) )
+		return fes->get_cached_artwork_file( *rom, art, (art_flags&AF_ImagesOnly) ).c_str();
+
 	std::vector<std::string> vid_list, image_list;
 	fes->get_best_artwork_file(
 			*rom,
@@ -2673,46 +3104,15 @@ const char *FeVM::cb_get_art( const char *art, int index_offset, int filter_offs
 			image_list,
 			(art_flags&AF_ImagesOnly) );
 
-	if ( art_flags&AF_FullList )
-	{
-		std::vector<std::string>::iterator itr;
-		if ( !(art_flags&AF_ImagesOnly) &&  !vid_list.empty() )
-		{
-			for ( itr=vid_list.begin(); itr!=vid_list.end(); ++itr )
-			{
-				if ( !retval.empty() )
-					retval += ";";
+	const std::vector<std::string> &list = ( !(art_flags&AF_ImagesOnly) && !vid_list.empty() )
+		? vid_list : image_list;
 
-				// see note below re: need for absolute path
-				retval += absolute_path( *itr );
-			}
-		}
-		else
-		{
-			for ( itr=image_list.begin(); itr!=image_list.end(); ++itr )
-			{
-				if ( !retval.empty() )
-					retval += ";";
-
-				// see note below re: need for absolute path
-				retval += absolute_path( *itr );
-			}
-		}
-	}
-	else
+	for ( std::vector<std::string>::const_iterator itr=list.begin(); itr!=list.end(); ++itr )
 	{
-		if ( !(art_flags&AF_ImagesOnly) &&  !vid_list.empty() )
-			retval = vid_list.front();
-		else if ( !image_list.empty() )
-			retval = image_list.front();
+		if ( !retval.empty() )
+			retval += ";";
 
-		// We force our return value to an absolute path, to work
-		// around Attract-Mode's tendency to assume that relative
-		// paths are relative to the layout directory.
-		//
-		// We are almost certain that is not the case here...
-		//
-		retval = absolute_path( retval );
+		retval += absolute_path( *itr );
 	}
 
 	return retval.c_str();
@@ -2792,6 +3192,12 @@ void FeVM::cb_signal( const char *sig )
 
 	if ( strcmp( "reset_window", sig ) == 0 )
 	{
+		if ( fev->m_hold_changes )
+		{
+			fev->m_held_reset_window = true;
+			return;
+		}
+
 		fev->m_window.on_exit();
 		fev->m_window.initial_create();
 		fev->init_monitors();
@@ -2819,6 +3225,14 @@ void FeVM::cb_set_display( int idx, bool stack_previous, bool reload )
 	if ( idx < 0 )
 		idx = 0;
 
+	if ( fev->m_hold_changes )
+	{
+		fev->m_held_display = idx;
+		fev->m_held_display_stack = stack_previous;
+		fev->m_held_display_reload = reload;
+		return;
+	}
+
 	if ( fes->set_display( idx, stack_previous ) || reload )
 		fev->post_command( FeInputMap::Reload );
 	else
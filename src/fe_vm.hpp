@@ -88,6 +88,11 @@ private:
 
 	bool m_redraw_triggered;
 	bool m_sort_zorder_triggered;
+	bool m_in_tick; // true while the tick callbacks are running
+	int m_held_display; // display set by a tick during a transition, -1 if none
+	bool m_held_display_stack;
+	bool m_held_display_reload;
+	bool m_held_reset_window;
 	bool m_process_console_input;
 	const FeScriptConfigurable *m_script_cfg;
 	int m_script_id;
@@ -120,7 +125,7 @@ public:
 	void flag_sort_zorder() { m_sort_zorder_triggered = true; };
 	void clear_commands();
 	void post_command( FeInputMap::Command c );
-	bool poll_command( FeInputMap::Command &c, std::optional<sf::Event> &ev, bool &from_ui );
+	bool poll_command( FeInputMap::Command &c, std::optional<sf::Event> &ev, bool &from_ui, FeWindow::EventTime &when );
 	void clear_handlers();
 	void clear_layout(); // override of base class clear_layout()
 
@@ -137,7 +142,13 @@ public:
 	void vm_init();
 	bool on_new_layout();
 	bool on_tick();
+	bool has_tick_callbacks() const { return !m_ticks.empty(); };
 	void on_transition( FeTransitionType, int var );
+
+	// Apply the changes that tick callbacks made during transitions.  Called
+	// by the main loop once the current navigation sequence is complete.
+	// Return true if anything was applied
+	bool apply_held_changes();
 	void init_with_default_layout();
 	int get_script_id() { return m_script_id; };
 	void set_script_id( int id ) { m_script_id=id; };
@@ -240,6 +251,7 @@ public:
 	static const char *cb_game_info( int,int,int);
 	static const char *cb_game_info(int,int);
 	static const char *cb_game_info(int);
+	static SQInteger cb_game_info_range( HSQUIRRELVM );
 
 	enum ArtFlags
 	{
@@ -27,6 +27,7 @@
 #include "fe_settings.hpp"
 #include "fe_window.hpp"
 #include "fe_present.hpp"
+#include "fe_frametime.hpp"
 #include "base64.hpp"
 
 #ifdef SFML_SYSTEM_WINDOWS
@@ -161,6 +162,14 @@ void FeWindow::display()
 		DwmFlush();
 	check_for_sleep();
 #endif
+
+	if ( m_has_input )
+	{
+		FeFrameTimer::get_ref().add_latency( std::chrono::duration<float, std::milli>(
+			std::chrono::steady_clock::now() - m_input_time ).count() );
+
+		m_has_input = false;
+	}
 }
 
 #ifdef SFML_SYSTEM_WINDOWS
@@ -805,5 +814,40 @@ void FeWindow::draw( const sf::Drawable &d, const sf::RenderStates &r )
 
 const std::optional<sf::Event> FeWindow::pollEvent()
 {
+	if ( !m_pending_events.empty() )
+	{
+		std::optional<sf::Event> ev( m_pending_events.front().first );
+		m_event_time = m_pending_events.front().second;
+		m_pending_events.pop_front();
+		return ev;
+	}
+
+	m_event_time = std::chrono::steady_clock::now();
 	return m_window->pollEvent();
 }
+
+bool FeWindow::wait_event( sf::Time timeout )
+{
+	if ( m_pending_events.empty() )
+	{
+		// A zero timeout would wait forever
+		if ( const std::optional ev = m_window->waitEvent( std::max( timeout, sf::milliseconds( 1 ) ) ) )
+			m_pending_events.emplace_back( *ev, std::chrono::steady_clock::now() );
+	}
+
+	return !m_pending_events.empty();
+}
+
+void FeWindow::queue_events()
+{
+	while ( const std::optional ev = m_window->pollEvent() )
+		m_pending_events.emplace_back( *ev, std::chrono::steady_clock::now() );
+}
+
+void FeWindow::track_input( EventTime t )
+{
+	if ( !m_has_input || ( t < m_input_time ))
+		m_input_time = t;
+
+	m_has_input = true;
+}
@@ -28,11 +28,17 @@
 #endif
 
 #include <SFML/Graphics.hpp>
+#include <deque>
+#include <chrono>
 
 class FeSettings;
 
 class FeWindow
 {
+public:
+	typedef std::chrono::steady_clock::time_point EventTime;
+
+private:
 	friend void launch_callback( void *o );
 	friend void wait_callback( void *o );
 
@@ -52,6 +58,10 @@ private:
 #endif
 	int m_win_mode;
 	bool m_mouse_outside = true;
+	std::deque<std::pair<sf::Event, EventTime>> m_pending_events; // received by wait_event() or queue_events(), returned by pollEvent()
+	EventTime m_event_time; // when the last event returned by pollEvent() was received
+	EventTime m_input_time; // earliest handled input not yet shown by display()
+	bool m_has_input = false;
 
 public:
 	FeWindow( FeSettings &fes );
@@ -73,6 +83,20 @@ public:
 	void draw( const sf::Drawable &d, const sf::RenderStates &t=sf::RenderStates::Default );
 	const std::optional<sf::Event> pollEvent();
 
+	// Block until there is an event or the timeout expires, returns true
+	// if there is an event for pollEvent()
+	bool wait_event( sf::Time timeout );
+
+	// Process the window's events now but keep them for pollEvent()
+	void queue_events();
+
+	// Return when the last event returned by pollEvent() was received
+	EventTime get_event_time() const { return m_event_time; };
+
+	// Record input received at the given time that the next display() will
+	// show.  Its latency is added to the frame timer
+	void track_input( EventTime t );
+
 	sf::RenderWindow &get_win();
 };
 
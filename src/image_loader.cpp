@@ -40,6 +40,7 @@
 #endif
 
 #include "image_loader.hpp"
+#include "fe_atlas.hpp"
 
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
@@ -702,6 +703,19 @@ void FeImageLoader::set_cache_size( size_t s )
 		il.m_imp->m_cache->resize( s );
 }
 
+size_t FeImageLoader::release_cache()
+{
+	if ( !m_imp->m_cache )
+		return 0;
+
+	size_t bytes = m_imp->m_cache->get_size();
+	size_t max_bytes = m_imp->m_cache->get_max_size();
+
+	m_imp->m_cache->resize( 0 );
+	m_imp->m_cache->resize( max_bytes );
+	return bytes;
+}
+
 void FeImageLoader::set_background_loading( bool flag )
 {
 	FeImageLoader &il = get_ref();
@@ -716,6 +730,36 @@ bool FeImageLoader::get_background_loading()
 	return il.m_imp->m_load_images_in_bg;
 }
 
+void FeImageLoader::set_atlas_max( int s )
+{
+	FeTextureAtlas::get_ref().set_max_image_size( s );
+}
+
+int FeImageLoader::get_atlas_max()
+{
+	return FeTextureAtlas::get_ref().get_max_image_size();
+}
+
+int FeImageLoader::atlas_pages()
+{
+	return FeTextureAtlas::get_ref().get_page_count();
+}
+
+int FeImageLoader::atlas_count()
+{
+	return FeTextureAtlas::get_ref().get_image_count();
+}
+
+float FeImageLoader::atlas_usage()
+{
+	return FeTextureAtlas::get_ref().get_occupancy();
+}
+
+float FeImageLoader::atlas_upload_time()
+{
+	return FeTextureAtlas::get_ref().get_upload_time();
+}
+
 //
 //
 void FeImageLoader::cache_image( const char *fn )
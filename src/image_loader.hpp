@@ -91,6 +91,9 @@ public:
 	// set the cache size for the image loader's cache of uncompressed images (in bytes)
 	static void set_cache_size( size_t cache_size );
 
+	// empty the cache, returns the number of bytes released
+	size_t release_cache();
+
 #ifndef NO_MOVIE
 	// destroy vid (on our background thread which will wait on the video threads to stop)
 	void reap_video( FeMedia *vid );
@@ -108,6 +111,15 @@ public:
 
 	void set_background_loading( bool flag );
 	bool get_background_loading();
+
+	// Texture atlas settings and stats
+	void set_atlas_max( int s );
+	int get_atlas_max();
+	int atlas_pages();
+	int atlas_count();
+	float atlas_usage();
+	float atlas_upload_time();
+
 	bool image_in_cache( const std::string &filename );
 	void add_to_cache(const std::string &key, FeImageLoaderEntry *entry);
 private:
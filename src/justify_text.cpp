@@ -34,9 +34,13 @@
 #include <SFML/Graphics/Font.hpp>
 #include <SFML/Graphics/RenderTarget.hpp>
 #include "justify_text.hpp" // AM+
+#include "fe_batch.hpp" // AM+
 #include <SFML/Graphics/Texture.hpp>
 
 #include <algorithm>
+#include <array>
+#include <memory>
+#include <unordered_map>
 #include <utility>
 
 #include <cmath>
@@ -89,6 +93,103 @@ void addGlyphQuad(sf::VertexArray& vertices, sf::Vector2f position, sf::Color co
 
 namespace sf
 {
+////////////////////////////////////////////////////////////
+struct GlyphTable::Pages // AM+
+{
+    using Page = std::array<const Glyph*, 256>;
+
+    std::array<std::unique_ptr<Page>, 256> pages;
+};
+
+
+namespace
+{
+struct GlyphTableKey // AM+
+{
+    const Font*  font;
+    unsigned int characterSize;
+    bool         bold;
+    float        outlineThickness;
+
+    bool operator==(const GlyphTableKey& o) const
+    {
+        return font == o.font && characterSize == o.characterSize && bold == o.bold &&
+               outlineThickness == o.outlineThickness;
+    }
+};
+
+struct GlyphTableKeyHash // AM+
+{
+    std::size_t operator()(const GlyphTableKey& k) const
+    {
+        std::size_t h = std::hash<const Font*>()(k.font);
+        h ^= std::hash<unsigned int>()(k.characterSize) + 0x9e3779b9 + (h << 6) + (h >> 2);
+        h ^= std::hash<float>()(k.outlineThickness) + 0x9e3779b9 + (h << 6) + (h >> 2);
+        return h ^ static_cast<std::size_t>(k.bold);
+    }
+};
+
+using GlyphTableMap = std::unordered_map<GlyphTableKey, std::unique_ptr<GlyphTable::Pages>, GlyphTableKeyHash>; // AM+
+
+// Deliberately never destroyed, fonts may be invalidated during static destruction
+GlyphTableMap& getGlyphTables() // AM+
+{
+    static auto* tables = new GlyphTableMap();
+    return *tables;
+}
+} // namespace
+
+
+////////////////////////////////////////////////////////////
+GlyphTable::GlyphTable(const Font& font, unsigned int characterSize, bool bold, float outlineThickness) : // AM+
+m_font(&font),
+m_characterSize(characterSize),
+m_bold(bold),
+m_outlineThickness(outlineThickness)
+{
+    std::unique_ptr<Pages>& pages = getGlyphTables()[{&font, characterSize, bold, outlineThickness}];
+    if (!pages)
+        pages = std::make_unique<Pages>();
+
+    m_pages = pages.get();
+}
+
+
+////////////////////////////////////////////////////////////
+const Glyph& GlyphTable::getGlyph(std::uint32_t codePoint) const // AM+
+{
+    if (codePoint > 0xFFFF)
+        return m_font->getGlyph(codePoint, m_characterSize, m_bold, m_outlineThickness);
+
+    std::unique_ptr<Pages::Page>& page = m_pages->pages[codePoint >> 8];
+    if (!page)
+    {
+        page = std::make_unique<Pages::Page>();
+        page->fill(nullptr);
+    }
+
+    const Glyph*& glyph = (*page)[codePoint & 0xFF];
+    if (!glyph)
+        glyph = &m_font->getGlyph(codePoint, m_characterSize, m_bold, m_outlineThickness);
+
+    return *glyph;
+}
+
+
+////////////////////////////////////////////////////////////
+void GlyphTable::invalidate(const Font& font) // AM+
+{
+    GlyphTableMap& tables = getGlyphTables();
+    for (auto it = tables.begin(); it != tables.end();)
+    {
+        if (it->first.font == &font)
+            it = tables.erase(it);
+        else
+            ++it;
+    }
+}
+
+
 ////////////////////////////////////////////////////////////
 JustifyText::JustifyText(const Font& font, String string, unsigned int characterSize) :
 m_string(std::move(string)),
@@ -318,7 +419,8 @@ Vector2f JustifyText::findCharacterPos(std::size_t index) const
 
     // Precompute the variables needed by the algorithm
     const bool  isBold          = m_style & Bold;
-    float       whitespaceWidth = m_font->getGlyph(U' ', m_characterSize, isBold).advance;
+    const GlyphTable glyphs(*m_font, m_characterSize, isBold); // AM+
+    float       whitespaceWidth = glyphs.getGlyph(U' ').advance;
     const float letterSpacing   = (whitespaceWidth / 3.f) * (m_letterSpacingFactor - 1.f);
     whitespaceWidth += letterSpacing;
     const float lineSpacing = m_font->getLineSpacing(m_characterSize) * m_lineSpacingFactor;
@@ -350,7 +452,7 @@ Vector2f JustifyText::findCharacterPos(std::size_t index) const
         }
 
         // For regular characters, add the advance offset of the glyph
-        position.x += m_font->getGlyph(curChar, m_characterSize, isBold).advance + letterSpacing;
+        position.x += glyphs.getGlyph(curChar).advance + letterSpacing;
     }
 
     // Transform the position to global coordinates
@@ -390,6 +492,21 @@ void JustifyText::draw(RenderTarget& target, RenderStates states) const
     target.draw(m_vertices, states);
 }
 
+// AM+
+void JustifyText::batch(FeDrawBatch& b, RenderStates states) const
+{
+    ensureGeometryUpdate();
+
+    states.transform *= getTransform();
+    states.texture        = &m_font->getTexture(m_characterSize);
+    states.coordinateType = CoordinateType::Pixels;
+
+    if (m_outlineThickness != 0)
+        b.add(m_outlineVertices, states);
+
+    b.add(m_vertices, states);
+}
+
 // Use the difference between bounds and width to update the spacing
 void JustifyText::justifySpacing(float &whitespaceWidth, float &letterSpacing, bool isBold, float italicShear) const
 {
@@ -401,6 +518,7 @@ void JustifyText::justifySpacing(float &whitespaceWidth, float &letterSpacing, b
     auto minX = static_cast<float>(m_characterSize);
     float maxX = 0.f;
     float x = 0.f;
+    const GlyphTable glyphs(*m_font, m_characterSize, isBold);
 
     // Calculate maxX using the same method as `ensureGeometryUpdate`
     for (const std::uint32_t curChar : m_string)
@@ -432,7 +550,7 @@ void JustifyText::justifySpacing(float &whitespaceWidth, float &letterSpacing, b
             maxX = std::max(maxX, x);
             continue;
         }
-        const Glyph& glyph = m_font->getGlyph(curChar, m_characterSize, isBold);
+        const Glyph& glyph = glyphs.getGlyph(curChar);
         const Vector2f p1 = glyph.bounds.position;
         const Vector2f p2 = glyph.bounds.position + glyph.bounds.size;
         minX = std::min(minX, x + p1.x - italicShear * p2.y);
@@ -486,14 +604,15 @@ void JustifyText::ensureGeometryUpdate() const
     const float italicShear        = (m_style & Italic) ? degrees(12).asRadians() : 0.f;
     const float underlineOffset    = m_font->getUnderlinePosition(m_characterSize);
     const float underlineThickness = m_font->getUnderlineThickness(m_characterSize);
+    const GlyphTable glyphs(*m_font, m_characterSize, isBold); // AM+
 
     // Compute the location of the strike through dynamically
     // We use the center point of the lowercase 'x' glyph as the reference
     // We reuse the underline thickness as the thickness of the strike through as well
-    const float strikeThroughOffset = m_font->getGlyph(U'x', m_characterSize, isBold).bounds.getCenter().y;
+    const float strikeThroughOffset = glyphs.getGlyph(U'x').bounds.getCenter().y;
 
     // Precompute the variables needed by the algorithm
-    float       whitespaceWidth = m_font->getGlyph(U' ', m_characterSize, isBold).advance;
+    float       whitespaceWidth = glyphs.getGlyph(U' ').advance;
     float letterSpacing   = (whitespaceWidth / 3.f) * (m_letterSpacingFactor - 1.f); // AM+
     whitespaceWidth += letterSpacing;
     const float lineSpacing = m_font->getLineSpacing(m_characterSize) * m_lineSpacingFactor;
@@ -511,6 +630,7 @@ void JustifyText::ensureGeometryUpdate() const
     float px = 0.f;
     bool is_justify = ( m_justify == Word || m_justify == Character );
     if (is_justify) justifySpacing(whitespaceWidth, letterSpacing, isBold, italicShear);
+    const GlyphTable outlineGlyphs(*m_font, m_characterSize, isBold, m_outlineThickness);
     // --- AM+
 
     for (const std::uint32_t curChar : m_string)
@@ -577,14 +697,14 @@ void JustifyText::ensureGeometryUpdate() const
         // Apply the outline
         if (m_outlineThickness != 0)
         {
-            const Glyph& glyph = m_font->getGlyph(curChar, m_characterSize, isBold, m_outlineThickness);
+            const Glyph& glyph = outlineGlyphs.getGlyph(curChar); // AM+
 
             // Add the outline glyph to the vertices
             addGlyphQuad(m_outlineVertices, Vector2f(px, y), m_outlineColor, glyph, italicShear);
         }
 
         // Extract the current glyph's description
-        const Glyph& glyph = m_font->getGlyph(curChar, m_characterSize, isBold);
+        const Glyph& glyph = glyphs.getGlyph(curChar); // AM+
 
         // Add the glyph to the vertices
         addGlyphQuad(m_vertices, Vector2f(px, y), m_fillColor, glyph, italicShear);
@@ -50,10 +50,48 @@
 #include <cstdint>
 
 
+class FeDrawBatch; // AM+
+
 namespace sf
 {
 class Font;
 class RenderTarget;
+struct Glyph;
+
+////////////////////////////////////////////////////////////
+/// \brief Dense glyph lookup for a font, size and style (AM+)
+///
+/// `Font::getGlyph` resolves the glyph index and hashes the
+/// code point, size, bold flag and outline on every call.
+/// This table remembers the resulting glyphs for the Basic
+/// Multilingual Plane in lazily allocated pages, so repeated
+/// lookups are two array indexes. Code points outside the BMP
+/// fall through to `Font::getGlyph`.
+///
+/// The tables are shared by every text using the same font,
+/// size and style. They refer to glyphs owned by the font, so
+/// `invalidate` must be called before a font is reloaded or
+/// destroyed.
+///
+////////////////////////////////////////////////////////////
+class SFML_GRAPHICS_API GlyphTable
+{
+public:
+    GlyphTable(const Font& font, unsigned int characterSize, bool bold, float outlineThickness = 0.f);
+
+    [[nodiscard]] const Glyph& getGlyph(std::uint32_t codePoint) const;
+
+    static void invalidate(const Font& font);
+
+    struct Pages;
+
+private:
+    const Font*  m_font;
+    unsigned int m_characterSize;
+    bool         m_bold;
+    float        m_outlineThickness;
+    Pages*       m_pages;
+};
 
 ////////////////////////////////////////////////////////////
 /// \brief Graphical text that can be drawn to a render target
@@ -443,6 +481,12 @@ public:
     ////////////////////////////////////////////////////////////
     [[nodiscard]] FloatRect getGlobalBounds() const;
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Add the text to a draw batch (AM+)
+    ///
+    ////////////////////////////////////////////////////////////
+    void batch(FeDrawBatch& b, RenderStates states) const;
+
 private:
     ////////////////////////////////////////////////////////////
     /// \brief Draw the text to a render target
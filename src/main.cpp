@@ -35,6 +35,8 @@
 #include "fe_vm.hpp"
 #include "fe_blend.hpp"
 #include "fe_net.hpp"
+#include "fe_profiler.hpp"
+#include "fe_frametime.hpp"
 #include <iostream>
 #include <cmath>
 #include <cstdlib>
@@ -193,17 +195,34 @@ int main(int argc, char *argv[])
 	std::optional<sf::Event> move_event;
 	int move_last_triggered( 0 );
 
+	FeFrameTimer &frame_timer = FeFrameTimer::get_ref();
+
 	// go straight into config mode if there are no lists configured for
 	// display
 	//
 	bool config_mode = ( feSettings.displays_count() < 1 );
 
+	if ( config_mode && frame_timer.is_benchmark() )
+	{
+		FeLog() << "Layout benchmark needs at least one configured display." << std::endl;
+		return 1;
+	}
+
 #ifdef USE_LIBCURL
 	if ( feSettings.get_info_bool( FeSettings::CheckForUpdates ) )
 		versionChecker.initiate();
 #endif
 
-	if ( !config_mode )
+	if ( !config_mode && frame_timer.is_benchmark() )
+	{
+		// Benchmarks skip the intro and startup mode, and time the current display's layout
+		feSettings.set_display( feSettings.get_selected_display_index() );
+		feVM.load_layout( initial_load );
+		initial_load = false;
+
+		FeLog() << "Layout benchmark on display: " << feSettings.get_current_display_title() << std::endl;
+	}
+	else if ( !config_mode )
 	{
 		// Attempt to start the intro now
 		if ( !feVM.load_intro() )
@@ -216,6 +235,23 @@ int main(int argc, char *argv[])
 
 	while (window.isOpen() && (!exit_selected))
 	{
+		frame_timer.begin_frame();
+
+		if ( frame_timer.is_benchmark() && !config_mode )
+		{
+			FeInputMap::Command bc;
+			if ( !frame_timer.benchmark_next( bc ) )
+			{
+				frame_timer.log_report();
+				break;
+			}
+
+			if ( bc != FeInputMap::LAST_COMMAND )
+				feVM.post_command( bc );
+
+			redraw = true;
+		}
+
 		if ( config_mode )
 		{
 			//
@@ -241,6 +277,7 @@ int main(int argc, char *argv[])
 				}
 
 				// Settings have changed, reload the display
+				feSettings.clear_romlist_cache();
 				feSettings.set_display( feSettings.has_custom_displays_menu()
 					? feSettings.get_current_display_index()
 					: feSettings.get_selected_display_index() // in case config has removed custom display
@@ -341,7 +378,8 @@ int main(int argc, char *argv[])
 		FeInputMap::Command c;
 		std::optional<sf::Event> ev;
 		bool from_ui;
-		while ( feVM.poll_command( c, ev, from_ui ) )
+		FeWindow::EventTime when;
+		while ( feVM.poll_command( c, ev, from_ui, when ) )
 		{
 			if ( ev.has_value() )
 			{
@@ -448,6 +486,9 @@ int main(int argc, char *argv[])
 					&& ( from_ui || ( move_triggered != FeInputMap::LAST_COMMAND )))
 				continue;
 
+			// Time from receiving this input to the next frame being shown
+			window.track_input( when );
+
 			if ( from_ui )
 			{
 				// setup variables to test for when the navigation keys are held down
@@ -1006,6 +1047,7 @@ int main(int argc, char *argv[])
 			if ( cont )
 			{
 				const int TRIG_CHANGE_MS = 400;
+				const int MAX_REPEATS = 8;
 				int t = move_timer.getElapsedTime().asMilliseconds();
 				if (( t > TRIG_CHANGE_MS ) && ( t - move_last_triggered > feSettings.selection_speed() ))
 				{
@@ -1033,10 +1075,22 @@ int main(int argc, char *argv[])
 					{
 						soundsys.sound_event( c );
 
+						//
+						// Repeats that came due while the last frame was being drawn are
+						// coalesced into one bigger step, so that scrolling keeps up with the
+						// repeat rate when a selection change is slow to draw.  A long stall
+						// (a layout reload) only catches up on MAX_REPEATS steps, and the
+						// coalesced step is still limited to the user's selection max step.
+						// Nothing is coalesced when acceleration is off (max step 0 or 1)
+						//
+						int max_step = feSettings.selection_max_step();
+						int repeats = 1;
+						if (( max_step > 1 ) && ( move_last_triggered > 0 ) && ( feSettings.selection_speed() > 0 ))
+							repeats = std::min( ( t - move_last_triggered ) / feSettings.selection_speed(), MAX_REPEATS );
+
 						move_last_triggered = t;
 						int step = 1;
 
-						int max_step = feSettings.selection_max_step();
 						if ( max_step > 1 )
 						{
 							int s = t / TRIG_CHANGE_MS;
@@ -1056,11 +1110,13 @@ int main(int argc, char *argv[])
 									shift = 11;
 								step = 1 << ( shift );
 							}
-
-							if ( step > max_step )      // make sure we don't go over user specified max
-								step = max_step;
 						}
 
+						step *= repeats;
+
+						if (( max_step > 0 ) && ( step > max_step ))      // make sure we don't go over user specified max
+							step = max_step;
+
 						switch ( move_triggered )
 						{
 						// Key repeat. First press in FePresent::handle_event()
@@ -1151,24 +1207,46 @@ int main(int argc, char *argv[])
 		else
 			has_focus = window.hasFocus();
 
+		// Build one of the filters still loading for the current display
+		bool busy = feSettings.build_pending_filter();
+
 		if ( feVM.tick() )
 			redraw=true;
 
+		// Apply the list changes that tick callbacks made during transitions
+		if ( feVM.apply_held_changes() )
+			redraw=true;
+
 		if ( feVM.saver_activation_check() )
 			soundsys.sound_event( FeInputMap::ScreenSaver );
 
-		if ( redraw || !feSettings.get_info_bool( FeSettings::PowerSaving ) )
+		// Load the romlists of the neighbouring displays while the user is idle
+		if (( feVM.get_idle_time() > sf::seconds( 2 ) ) && feSettings.prefetch_romlists() )
+			busy = true;
+
+		if ( redraw || frame_timer.get_overlay() || !feSettings.get_info_bool( FeSettings::PowerSaving ) )
 		{
 			feVM.redraw_surfaces();
+			frame_timer.mark( FeFrameTimer::Surfaces );
 
 			// begin drawing
 			window.clear();
 			window.draw( feVM );
+			frame_timer.draw_overlay( window.get_win(), feVM.get_default_font() );
+			frame_timer.mark( FeFrameTimer::Draw );
+
 			window.display();
+			frame_timer.mark( FeFrameTimer::Present );
 			redraw=false;
 		}
-		else
-			sf::sleep( sf::milliseconds( 15 ) );
+		else if ( !busy )
+		{
+			// Held keys and a pending launch are checked every 10ms
+			if (( move_state != FeInputMap::LAST_COMMAND ) || launch_game )
+				feVM.idle_wait( sf::milliseconds( 10 ) );
+			else
+				feVM.idle_wait();
+		}
 
 		soundsys.tick();
 	}
@@ -1184,6 +1262,10 @@ int main(int argc, char *argv[])
 	soundsys.stop();
 	feSettings.save_state();
 
+	FeScriptProfiler &profiler = FeScriptProfiler::get_ref();
+	if ( !profiler.get_output().empty() )
+		profiler.dump( profiler.get_output().c_str() );
+
 #ifdef USE_LIBCURL
 	curl_global_cleanup();
 #endif
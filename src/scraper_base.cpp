@@ -28,6 +28,7 @@
 #include <cstdio>
 #include <iostream>
 #include <iomanip>
+#include <sstream>
 #include "nowide/fstream.hpp"
 
 #include <expat.h>
@@ -109,12 +110,14 @@ std::string get_crc( const std::string &full_path,
 
 	if ( is_supported_archive( full_path ) )
 	{
-		std::vector<std::string> contents;
-		if ( !fe_zip_get_dir( full_path.c_str(), contents ) )
+		std::shared_ptr<const FeArchiveToc> toc = fe_zip_get_toc( full_path );
+		if ( !toc )
 			return "";
 
+		const std::vector<FeArchiveToc::Entry> &contents = toc->get_entries();
+
 		// check for extension matches
-		std::vector<std::string>::iterator itr;
+		std::vector<FeArchiveToc::Entry>::const_iterator itr;
 		for ( itr=contents.begin(); itr != contents.end(); ++itr )
 		{
 			//
@@ -122,10 +125,26 @@ std::string get_crc( const std::string &full_path,
 			// in the archive or if this file matches one of the
 			// supported extensions
 			//
-			if ( tail_compare( *itr, exts ) || ( contents.size() == 1 ) )
+			if ( tail_compare( (*itr).name, exts ) || ( contents.size() == 1 ) )
 			{
+				if ( (*itr).size > (std::uint64_t)MAX_CRC_FILE_SIZE )
+					return "";
+
+				//
+				// Use the crc recorded in the archive's table of contents
+				// where the file contents don't need correcting first
+				//
+				if ( (*itr).has_crc && !tail_compare( (*itr).name, "nes" ) )
+				{
+					std::ostringstream ss;
+					ss.fill('0');
+					ss << std::hex << std::setw(8) << (*itr).crc;
+					FeDebug() << "CRC: " << full_path << "=" << ss.str() << " (archive toc)" << std::endl;
+					return ss.str();
+				}
+
 				FeZipStream zs( full_path );
-				zs.open( *itr );
+				zs.open( (*itr).name );
 
 				char *buff = zs.getData();
 				std::optional<size_t> size = zs.getSize();
@@ -138,7 +157,7 @@ std::string get_crc( const std::string &full_path,
 				if ( size_int > MAX_CRC_FILE_SIZE )
 					return "";
 
-				correct_buff_for_format( buff, size_int, *itr );
+				correct_buff_for_format( buff, size_int, (*itr).name );
 				std::string retval = get_crc32( buff, size_int );
 				FeDebug() << "CRC: " << full_path << "=" << retval << std::endl;
 				return retval;
@@ -263,6 +282,7 @@ FeImporterContext::FeImporterContext( const FeEmulatorInfo &e, FeRomInfoListType
 	uiupdatedata( NULL ),
 	full( false ),
 	use_net( true ),
+	console_progress( true ),
 	progress_past( 0 ),
 	progress_range( 100 ),
 	download_count( 0 )
@@ -39,6 +39,7 @@ public:
 	void *uiupdatedata;
 	bool full;
 	bool use_net;
+	bool console_progress; // show the percentage complete on stdout
 	int progress_past;
 	int progress_range;
 	int download_count;
@@ -22,6 +22,7 @@
 
 #include <string>
 #include <map>
+#include <mutex>
 
 #include "nowide/fstream.hpp"
 #include "rapidjson/document.h"
@@ -676,8 +677,20 @@ void create_single_id_query(
 	q_total++;
 }
 
+namespace
+{
+	//
+	// Romlists can be built in parallel, but only one scrape of
+	// thegamesdb.net runs at a time.  They share the local id files and
+	// the API allowance
+	//
+	std::mutex g_tgdb_mutex;
+};
+
 bool FeSettings::thegamesdb_scraper( FeImporterContext &c )
 {
+	std::lock_guard<std::mutex> l( g_tgdb_mutex );
+
 	FeLog() << " - scraping thegamesdb.net..." << std::endl;
 
 	int remaining_allowance = -1;
@@ -727,9 +740,26 @@ bool FeSettings::thegamesdb_scraper( FeImporterContext &c )
 	std::string emu_name = c.emulator.get_info( FeEmulatorInfo::Name );
 
 	for ( FeRomInfoListType::iterator itl = c.romlist.begin(); itl != c.romlist.end(); ++itl )
-	{
 		(*itl).set_info( FeRomInfo::Emulator, emu_name );
 
+	// Check the whole list for each artwork we scrape up front
+	const bool scrape_flags[] = { m_scrape_snaps, m_scrape_marquees, m_scrape_flyers, m_scrape_wheels, m_scrape_fanart };
+	const char *scrape_labels[] = { "snap", "marquee", "flyer", "wheel", "fanart" };
+	const int scrape_count = 5;
+
+	std::vector<bool> have_art[scrape_count];
+	if ( c.scrape_art )
+	{
+		for ( int j=0; j<scrape_count; j++ )
+		{
+			if ( scrape_flags[j] )
+				check_artwork( c.romlist, scrape_labels[j], AnyArt, have_art[j] );
+		}
+	}
+
+	size_t i=0;
+	for ( FeRomInfoListType::iterator itl = c.romlist.begin(); itl != c.romlist.end(); ++itl, i++ )
+	{
 		if ( c.scrape_art )
 		{
 			// Don't scrape art for a clone if its parent has the same name
@@ -737,11 +767,11 @@ bool FeSettings::thegamesdb_scraper( FeImporterContext &c )
 				continue;
 
 			// Don't query if we already have the art already
-			if ( ( !m_scrape_snaps || has_artwork( *itl, "snap" ) )
-					&& ( !m_scrape_marquees || has_artwork( *itl, "marquee" ) )
-					&& ( !m_scrape_flyers || has_artwork( *itl, "flyer" ) )
-					&& ( !m_scrape_wheels || has_artwork( *itl, "wheel" ) )
-					&& ( !m_scrape_fanart || has_artwork( *itl, "fanart" ) ) )
+			bool have_all = true;
+			for ( int j=0; have_all && ( j<scrape_count ); j++ )
+				have_all = !scrape_flags[j] || have_art[j][i];
+
+			if ( have_all )
 				continue;
 		}
 
@@ -31,11 +31,59 @@
 #include "nowide/fstream.hpp"
 #include <list>
 #include <map>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include <SFML/System/Sleep.hpp>
 
 extern const char *FE_ROMLIST_SUBDIR;
 
+//
+// The part of a romlist build that is done for each emulator.  When more
+// than one emulator is being built these run on a pool of worker threads
+//
+class FeRomlistBuild
+{
+public:
+	FeRomlistBuild( const FeEmulatorInfo &e, const std::string &n )
+		: name( n ), ctx( e, romlist ), done( false ), percent( 0 ), cancelled( false ), seconds( 0.f )
+	{
+	}
+
+	std::string name; // emulator name given to the entries
+	FeRomInfoListType romlist;
+	FeImporterContext ctx;
+
+	std::ostringstream log; // log output, written out in task order
+	std::atomic<bool> done;
+	std::atomic<int> percent;
+	bool cancelled;
+	float seconds;
+};
+
 namespace {
 
+struct FeRomlistBuildPool
+{
+	std::atomic<size_t> next{ 0 };
+	std::atomic<bool> cancel{ false };
+};
+
+struct FeRomlistBuildUpdate
+{
+	FeRomlistBuild *build;
+	FeRomlistBuildPool *pool;
+};
+
+// UiUpdate for worker threads, progress is reported by the main thread
+bool worker_ui_update( void *d, int i, const std::string &aux )
+{
+	FeRomlistBuildUpdate *u = (FeRomlistBuildUpdate *)d;
+	u->build->percent = i;
+	return !u->pool->cancel;
+}
+
 void build_basic_romlist( FeImporterContext &c )
 {
 	// don't scan rompath for scummvm, we get the available games from 'scummvm -t'
@@ -554,6 +602,117 @@ bool FeSettings::apply_xml_import( FeImporterContext &c )
 	return !cancelled;
 }
 
+void FeSettings::run_romlist_build( FeRomlistBuild &b )
+{
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	FeLog() << "*** Generating Collection/Rom List: " << b.name << std::endl;
+
+	build_basic_romlist( b.ctx );
+	if ( !apply_xml_import( b.ctx ) )
+		b.cancelled = true;
+
+	apply_import_extras( b.ctx, b.ctx.emulator.is_mame() );
+	apply_emulator_name( b.name, b.romlist );
+
+	b.seconds = std::chrono::duration<float>( std::chrono::steady_clock::now() - start ).count();
+
+	FeLog() << "[Build " << b.name << "] - " << b.romlist.size() << " entries in "
+		<< as_str( b.seconds, 2 ) << "s" << std::endl;
+}
+
+//
+// Run the builds on a pool of worker threads.  They spend most of their time
+// scanning directories and waiting on emulator output, so the pool is at
+// least two threads even on a single core.  Each build's log output is held
+// and written out in task order, and progress is reported from this thread
+// as the average over all builds.
+//
+// Returns false if cancelled by the user
+//
+bool FeSettings::run_romlist_builds( std::deque<FeRomlistBuild> &builds,
+	UiUpdate uiu, void *uid )
+{
+	if ( builds.size() == 1 )
+	{
+		FeRomlistBuild &b = builds.front();
+		b.ctx.uiupdate = uiu;
+		b.ctx.uiupdatedata = uid;
+		run_romlist_build( b );
+		return !b.cancelled;
+	}
+
+	FeRomlistBuildPool pool;
+	std::vector<FeRomlistBuildUpdate> updates( builds.size() );
+	for ( size_t i=0; i<builds.size(); i++ )
+	{
+		updates[i].build = &builds[i];
+		updates[i].pool = &pool;
+		builds[i].ctx.uiupdate = worker_ui_update;
+		builds[i].ctx.uiupdatedata = &updates[i];
+		builds[i].ctx.console_progress = false;
+	}
+
+	size_t thread_count = std::min( builds.size(),
+		std::max( (size_t)2, (size_t)std::thread::hardware_concurrency() ));
+
+	FeLog() << " - Building " << builds.size() << " romlists with "
+		<< thread_count << " threads" << std::endl;
+
+	std::vector<std::thread> workers;
+	for ( size_t t=0; t<thread_count; t++ )
+	{
+		workers.emplace_back( [this, &builds, &pool]()
+		{
+			size_t i;
+			while (( i = pool.next++ ) < builds.size() )
+			{
+				FeRomlistBuild &b = builds[i];
+				if ( pool.cancel )
+					b.cancelled = true;
+				else
+				{
+					fe_set_thread_log( &b.log );
+					run_romlist_build( b );
+					fe_set_thread_log( NULL );
+				}
+
+				b.percent = 100;
+				b.done = true;
+			}
+		});
+	}
+
+	size_t logged=0;
+	while ( logged < builds.size() )
+	{
+		sf::sleep( sf::milliseconds( 100 ));
+
+		int total=0;
+		for ( std::deque<FeRomlistBuild>::iterator itr=builds.begin(); itr!=builds.end(); ++itr )
+			total += (*itr).percent;
+
+		while (( logged < builds.size() ) && builds[logged].done )
+			FeLog() << builds[logged++].log.str();
+
+		if ( uiu && !pool.cancel
+				&& !uiu( uid, total / (int)builds.size(),
+					( logged < builds.size() ) ? builds[logged].name : "" ))
+			pool.cancel = true;
+	}
+
+	for ( std::vector<std::thread>::iterator itr = workers.begin(); itr != workers.end(); ++itr )
+		(*itr).join();
+
+	for ( std::deque<FeRomlistBuild>::iterator itr=builds.begin(); itr!=builds.end(); ++itr )
+	{
+		if ( (*itr).cancelled )
+			return false;
+	}
+
+	return true;
+}
+
 bool FeSettings::build_romlist( const std::vector< FeImportTask > &task_list,
 						const std::string &output_name,
 						FeFilter &filter,
@@ -562,38 +721,44 @@ bool FeSettings::build_romlist( const std::vector< FeImportTask > &task_list,
 	FeRomInfoListType total_romlist;
 	std::string best_name, list_name, path;
 
+	//
+	// The build romlist tasks are independent of each other, so run them
+	// all together first.  Their results are merged in task order below
+	//
+	std::deque<FeRomlistBuild> builds;
 	for ( std::vector<FeImportTask>::const_iterator itr=task_list.begin();
 			itr < task_list.end(); ++itr )
 	{
-		if ( (*itr).task_type == FeImportTask::BuildRomlist )
-		{
-			// Build romlist task
-			FeLog() << "*** Generating Collection/Rom List: "
-				<< (*itr).emulator_name << std::endl;
-
-			FeEmulatorInfo *emu = m_rl.get_emulator( (*itr).emulator_name );
-			if ( emu == NULL )
-			{
-				FeLog() << " ! Error: Invalid --build-rom-list target: "
-					<<  (*itr).emulator_name << std::endl;
-			}
-			else
-			{
-				FeRomInfoListType romlist;
-
-				best_name = emu->get_info( FeEmulatorInfo::Name );
-
-				FeImporterContext ctx( *emu, romlist );
-				ctx.full = full;
-				ctx.out_name = output_name;
+		if ( (*itr).task_type != FeImportTask::BuildRomlist )
+			continue;
 
-				build_basic_romlist( ctx );
+		FeEmulatorInfo *emu = m_rl.get_emulator( (*itr).emulator_name );
+		if ( emu == NULL )
+		{
+			FeLog() << " ! Error: Invalid --build-rom-list target: "
+				<<  (*itr).emulator_name << std::endl;
+		}
+		else
+		{
+			builds.emplace_back( *emu, emu->get_info( FeEmulatorInfo::Name ) );
+			builds.back().ctx.full = full;
+			builds.back().ctx.out_name = output_name;
+		}
+	}
 
-				apply_xml_import( ctx );
-				apply_import_extras( ctx, emu->is_mame() );
+	run_romlist_builds( builds, NULL, NULL );
 
-				apply_emulator_name( best_name, romlist );
-				total_romlist.splice( total_romlist.end(), romlist );
+	std::deque<FeRomlistBuild>::iterator next_build = builds.begin();
+	for ( std::vector<FeImportTask>::const_iterator itr=task_list.begin();
+			itr < task_list.end(); ++itr )
+	{
+		if ( (*itr).task_type == FeImportTask::BuildRomlist )
+		{
+			if ( m_rl.get_emulator( (*itr).emulator_name ) != NULL )
+			{
+				best_name = (*next_build).name;
+				total_romlist.splice( total_romlist.end(), (*next_build).romlist );
+				++next_build;
 			}
 		}
 		else if ( (*itr).task_type == FeImportTask::ImportRomlist )
@@ -779,43 +944,32 @@ bool FeSettings::build_romlist( const std::vector<std::string> &emu_list, const
 		uiu( uid, 0, "" );
 
 	FeRomInfoListType total_romlist;
-	bool cancelled = false;
 	std::string user_message;
 
+	std::deque<FeRomlistBuild> builds;
 	for ( std::vector<std::string>::const_iterator itr = emu_list.begin();
-		!cancelled && ( itr != emu_list.end() ); ++itr )
+		itr != emu_list.end(); ++itr )
 	{
 		FeEmulatorInfo *emu = m_rl.get_emulator( *itr );
 		if ( emu == NULL )
 			continue;
 
-		FeLog() << "*** Generating Collection/Rom List: "
-			<< emu->get_info( FeEmulatorInfo::Name ) << std::endl;
-
-		FeRomInfoListType romlist;
-
-		FeImporterContext ctx( *emu, romlist );
-		ctx.uiupdate = uiu;
-		ctx.uiupdatedata = uid;
-		ctx.out_name = out_name;
-		ctx.use_net = use_net;
-
-		build_basic_romlist( ctx );
-		if ( !apply_xml_import( ctx ) )
-			cancelled = true;
+		builds.emplace_back( *emu, *itr );
+		builds.back().ctx.out_name = out_name;
+		builds.back().ctx.use_net = use_net;
+	}
 
-		apply_import_extras( ctx, emu->is_mame() );
-		apply_emulator_name( *itr, romlist );
+	if ( !run_romlist_builds( builds, uiu, uid ))
+		return false;
 
-		total_romlist.splice( total_romlist.end(), romlist );
+	for ( std::deque<FeRomlistBuild>::iterator itr = builds.begin(); itr != builds.end(); ++itr )
+	{
+		total_romlist.splice( total_romlist.end(), (*itr).romlist );
 
-		if ( !ctx.user_message.empty() )
-			user_message = ctx.user_message;
+		if ( !(*itr).ctx.user_message.empty() )
+			user_message = (*itr).ctx.user_message;
 	}
 
-	if ( cancelled )
-		return false;
-
 	total_romlist.sort( FeRomListSorter() );
 
 	// strip duplicate entries
@@ -838,7 +992,7 @@ bool FeSettings::build_romlist( const std::vector<std::string> &emu_list, const
 		? _( "Wrote $1 entries to Collection/Rom List", { as_str( total_romlist.size() ) })
 		: user_message;
 
-	return !cancelled;
+	return true;
 }
 
 bool FeSettings::scrape_artwork( const std::string &emu_name, UiUpdate uiu, void *uid, std::string &msg )
@@ -904,7 +1058,7 @@ bool FeSettings::scrape_artwork( const std::string &emu_name, UiUpdate uiu, void
 
 	// if we scraped something then make sure our path caches are reloaded
 	if ( ctx.download_count > 0 )
-		m_path_cache.clear();
+		clear_path_cache();
 
 	return true;
 }
@@ -123,25 +123,27 @@ bool FeSettings::simple_scraper( FeImporterContext &c,
 
 	bool is_snap = ( strcmp( art_label, "snap" ) == 0 );
 
+	// ugh, this must be set for check_artwork() to correctly function
 	for ( FeRomInfoListType::iterator itr=c.romlist.begin(); itr!=c.romlist.end(); ++itr )
-	{
-		// ugh, this must be set for has_artwork() to correctly function
 		(*itr).set_info( FeRomInfo::Emulator, emu_name );
 
+	std::vector<bool> have_art;
+	if ( !is_snap )
+		check_artwork( c.romlist, art_label, AnyArt, have_art );
+	else if ( is_vid ) // vid snap
+		check_artwork( c.romlist, art_label, VideoArt, have_art );
+	else // image snap
+		check_artwork( c.romlist, art_label, ImageArt, have_art );
+
+	size_t i=0;
+	for ( FeRomInfoListType::iterator itr=c.romlist.begin(); itr!=c.romlist.end(); ++itr, i++ )
+	{
 		// Don't scrape for a clone if its parent has the same name
 		//
 		if ( has_same_name_as_parent( *itr, parent_map ) )
 			continue;
 
-		bool do_scrape = false;
-		if ( !is_snap )
-			do_scrape = !has_artwork( *itr, art_label );
-		else if ( is_vid ) // vid snap
-			do_scrape = !has_video_artwork( *itr, art_label );
-		else // image snap
-			do_scrape = !has_image_artwork( *itr, art_label );
-
-		if ( do_scrape )
+		if ( !have_art[i] )
 		{
 			const std::string &rname = (*itr).get_info( FeRomInfo::Romname );
 			std::string fname = base_path + art_label + "/" + rname;
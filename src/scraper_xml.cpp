@@ -23,12 +23,16 @@
 #include "scraper_xml.hpp"
 #include "fe_util.hpp"
 #include "zip.hpp"
+#include "fe_cache.hpp"
 
 #include <cstring>
 #include <cstdio>
 #include <iostream>
 #include <iomanip>
+#include <algorithm>
+#include <mutex>
 #include "nowide/fstream.hpp"
+#include "nowide/cstdlib.hpp"
 
 #include <expat.h>
 
@@ -113,10 +117,90 @@ bool FeXMLParser::parse_internal(
 	return ud.parsed_xml;
 }
 
-bool FeMapComp::operator()(const char *lhs, const char *rhs) const
+namespace
 {
-	return ( strcmp( lhs, rhs ) < 0 );
-}
+	// Romlists can be built in parallel, two of which may share an emulator
+	std::mutex g_listxml_cache_mutex;
+
+	bool is_machine_element( const char *element )
+	{
+		return (( strcmp( element, "machine" ) == 0 )
+			|| ( strcmp( element, "game" ) == 0 )
+			|| ( strcmp( element, "software" ) == 0 ));
+	}
+
+	//
+	// Elements that make up most of the -listxml output but have nothing we
+	// use, their subtrees are skipped without any further comparisons
+	//
+	bool is_ignored_element( const char *element )
+	{
+		switch ( element[0] )
+		{
+		case 'a': return ( strcmp( element, "adjuster" ) == 0 );
+		case 'b': return ( strcmp( element, "biosset" ) == 0 );
+		case 'c': return (( strcmp( element, "chip" ) == 0 )
+				|| ( strcmp( element, "configuration" ) == 0 ));
+		case 'd': return (( strcmp( element, "device_ref" ) == 0 )
+				|| ( strcmp( element, "dipswitch" ) == 0 ));
+		case 'p': return ( strcmp( element, "port" ) == 0 );
+		case 'r': return (( strcmp( element, "rom" ) == 0 )
+				|| ( strcmp( element, "ramoption" ) == 0 ));
+		case 's': return (( strcmp( element, "sample" ) == 0 )
+				|| ( strcmp( element, "sound" ) == 0 )
+				|| ( strcmp( element, "slot" ) == 0 )
+				|| ( strcmp( element, "softwarelist" ) == 0 ));
+		default: return false;
+		}
+	}
+
+	void set_if_present( FeRomInfo &rom, FeRomInfo::Index idx, const std::string &value )
+	{
+		if ( !value.empty() )
+			rom.set_info( idx, value );
+	}
+
+	//
+	// Return the full path of the program that running "prog" would start,
+	// searching PATH if it has no directory.  Empty if it can't be found
+	//
+	std::string find_program( const std::string &prog )
+	{
+		if ( prog.find_first_of( "/\\" ) != std::string::npos )
+			return file_exists( prog ) ? prog : "";
+
+#ifdef SFML_SYSTEM_WINDOWS
+		const char *sep = ";";
+		const char *exts[] = { "", ".exe", NULL };
+#else
+		const char *sep = ":";
+		const char *exts[] = { "", NULL };
+#endif
+
+		const char *env = nowide::getenv( "PATH" );
+		std::string path = env ? env : "";
+
+		size_t pos=0;
+		while ( pos < path.size() )
+		{
+			std::string dir;
+			token_helper( path, pos, dir, sep );
+			if ( dir.empty() )
+				continue;
+
+			if ( dir.find_last_of( "/\\" ) != dir.size() - 1 )
+				dir += '/';
+
+			for ( int i=0; exts[i]; i++ )
+			{
+				if ( file_exists( dir + prog + exts[i] ) )
+					return dir + prog + exts[i];
+			}
+		}
+
+		return "";
+	}
+};
 
 //
 // Mame -listxml Parser
@@ -124,11 +208,12 @@ bool FeMapComp::operator()(const char *lhs, const char *rhs) const
 FeListXMLParser::FeListXMLParser( FeImporterContext &ctx )
 	: FeXMLParser( ctx.uiupdate, ctx.uiupdatedata ),
 	m_ctx( ctx ),
+	m_digest( NULL ),
+	m_text( NULL ),
 	m_count( 0 ),
-	m_displays( 0 ),
-	m_collect_data( false ),
-	m_chd( false ),
-	m_mechanical( false )
+	m_last_percent( 0 ),
+	m_skip_depth( 0 ),
+	m_collect_data( false )
 {
 }
 
@@ -136,315 +221,366 @@ void FeListXMLParser::start_element(
 			const char *element,
 			const char **attribute )
 {
-	if (( strcmp( element, "game" ) == 0 )
-		|| ( strcmp( element, "software" ) == 0 )
-		|| ( strcmp( element, "machine" ) == 0 ))
+	if ( m_skip_depth )
 	{
-		int i;
-		for ( i=0; attribute[i]; i+=2 )
+		m_skip_depth++;
+		return;
+	}
+
+	if ( is_machine_element( element ))
+	{
+		m_entry = FeListXMLDigest::Entry();
+
+		for ( int i=0; attribute[i]; i+=2 )
 		{
 			if ( strcmp( attribute[i], "name" ) == 0 )
-			{
-				std::map<const char *, FeRomInfoListType::iterator, FeMapComp>::iterator itr;
-				itr = m_map.find( attribute[i+1] );
-				if ( itr != m_map.end() )
-				{
-					m_itr = (*itr).second;
-					m_collect_data=true;
-					m_displays=0;
-					m_chd=false;
-					m_mechanical=false;
-					m_keep_rom=true;
-				}
-				else
-				{
-					if ( m_ctx.full )
-					{
-						m_ctx.romlist.push_back( FeRomInfo( attribute[i+1] ) );
-						m_itr = m_ctx.romlist.end();
-						--m_itr;
-						m_collect_data=true;
-						m_displays=0;
-						m_chd=false;
-						m_mechanical=false;
-						m_keep_rom=true;
-					}
-					else
-						m_collect_data=false;
-				}
-
-				break;
-			}
+				m_entry.name = attribute[i+1];
+			else if ((( strcmp( attribute[i], "isbios" ) == 0 )
+					|| ( strcmp( attribute[i], "isdevice" ) == 0 ))
+				&& ( strcmp( attribute[i+1], "yes" ) == 0 ))
+				m_entry.flags |= FeListXMLDigest::Entry::Discard;
+			else if ( strcmp( attribute[i], "cloneof" ) == 0 )
+				m_entry.cloneof = attribute[i+1];
+			else if ( strcmp( attribute[i], "romof" ) == 0 )
+				m_entry.romof = attribute[i+1];
+			else if (( strcmp( attribute[i], "ismechanical" ) == 0 )
+				&& ( strcmp( attribute[i+1], "yes" ) == 0 ))
+				m_entry.flags |= FeListXMLDigest::Entry::Mechanical;
 		}
-		if ( m_collect_data )
+
+		// Machines that aren't in the romlist are skipped entirely, unless
+		// we are building a digest or importing everything
+		m_collect_data = m_digest || m_ctx.full
+			|| ( m_map.find( m_entry.name ) != m_map.end() );
+
+		if ( !m_collect_data )
+			m_skip_depth = 1;
+
+		return;
+	}
+
+	if ( !m_collect_data )
+	{
+		if ( m_digest && ( strcmp( element, "mame" ) == 0 ))
 		{
-			for ( i=0; attribute[i]; i+=2 )
+			for ( int i=0; attribute[i]; i+=2 )
 			{
-				if ((( strcmp( attribute[i], "isbios" ) == 0 )
-						|| ( strcmp( attribute[i], "isdevice" ) == 0 ))
-					&& ( strcmp( attribute[i+1], "yes" ) == 0 ))
-				{
-					m_keep_rom=false;
-					break;
-				}
-				else if ( strcmp( attribute[i], "cloneof" ) == 0 )
-					(*m_itr).set_info( FeRomInfo::Cloneof, attribute[i+1] );
-				else if ( strcmp( attribute[i], "romof" ) == 0 )
-					(*m_itr).set_info( FeRomInfo::AltRomname, attribute[i+1] );
-				else if (( strcmp( attribute[i], "ismechanical" ) == 0 )
-					&& ( strcmp( attribute[i+1], "yes" ) == 0 ))
-				{
-					m_mechanical = true;
-				}
+				if ( strcmp( attribute[i], "build" ) == 0 )
+					m_digest->build = attribute[i+1];
 			}
 		}
+		return;
 	}
-	else if ( m_collect_data )
+
+	if ( is_ignored_element( element ))
 	{
-		if ( strcmp( element, "input" ) == 0 )
+		m_skip_depth = 1;
+		return;
+	}
+
+	if ( strcmp( element, "input" ) == 0 )
+	{
+		for ( int i=0; attribute[i]; i+=2 )
 		{
-			for ( int i=0; attribute[i]; i+=2 )
-			{
-				if (( strcmp( attribute[i], "players" ) == 0 )
-						&& (*m_itr).get_info( FeRomInfo::Players ).empty() )
-					(*m_itr).set_info( FeRomInfo::Players, attribute[i+1] );
-				else if (( strcmp( attribute[i], "buttons" ) == 0 )
-						&& (*m_itr).get_info( FeRomInfo::Buttons ).empty() )
-					(*m_itr).set_info( FeRomInfo::Buttons, attribute[i+1] );
-
-				// Older MAME XML included control as an attribute of the input tag:
-				else if (( strcmp( attribute[i], "control" ) == 0 )
-						&& (*m_itr).get_info( FeRomInfo::Control ).empty() )
-					(*m_itr).set_info( FeRomInfo::Control, attribute[i+1] );
-			}
+			if (( strcmp( attribute[i], "players" ) == 0 )
+					&& m_entry.players.empty() )
+				m_entry.players = attribute[i+1];
+			else if (( strcmp( attribute[i], "buttons" ) == 0 )
+					&& m_entry.buttons.empty() )
+				m_entry.buttons = attribute[i+1];
+
+			// Older MAME XML included control as an attribute of the input tag:
+			else if (( strcmp( attribute[i], "control" ) == 0 )
+					&& m_entry.control.empty() )
+				m_entry.control = attribute[i+1];
 		}
-		else if ( strcmp( element, "display" ) == 0 )
+	}
+	else if ( strcmp( element, "display" ) == 0 )
+	{
+		for ( int i=0; attribute[i]; i+=2 )
 		{
-			for ( int i=0; attribute[i]; i+=2 )
-			{
-				if ( strcmp( attribute[i], "rotate" ) == 0 )
-					(*m_itr).set_info( FeRomInfo::Rotation, attribute[i+1] );
-				else if ( strcmp( attribute[i], "type" ) == 0 )
-					(*m_itr).set_info( FeRomInfo::DisplayType, attribute[i+1] );
-			}
-			m_displays++;
+			if ( strcmp( attribute[i], "rotate" ) == 0 )
+				m_entry.rotation = attribute[i+1];
+			else if ( strcmp( attribute[i], "type" ) == 0 )
+				m_entry.display_type = attribute[i+1];
 		}
-		else if ( strcmp( element, "driver" ) == 0 )
+		m_entry.displays++;
+	}
+	else if ( strcmp( element, "driver" ) == 0 )
+	{
+		for ( int i=0; attribute[i]; i+=2 )
 		{
-			for ( int i=0; attribute[i]; i+=2 )
+			if ( strcmp( attribute[i], "status" ) == 0 )
 			{
-				if ( strcmp( attribute[i], "status" ) == 0 )
-				{
-					(*m_itr).set_info( FeRomInfo::Status, attribute[i+1] );
-					break;
-				}
+				m_entry.status = attribute[i+1];
+				break;
 			}
 		}
-		else if ( strcmp( element, "control" ) == 0 )
-		{
-			std::string type, ways, old_type;
-
-			old_type = (*m_itr).get_info( FeRomInfo::Control );
-			if ( !old_type.empty() )
-				old_type += ",";
+	}
+	else if ( strcmp( element, "control" ) == 0 )
+	{
+		std::string type, ways;
 
-			for ( int i=0; attribute[i]; i+=2 )
-			{
-				if ( strcmp( attribute[i], "type" ) == 0 )
-					type = attribute[i+1];
-				else if ( strcmp( attribute[i], "ways" ) == 0 )
-					ways = attribute[i+1];
-
-				if (( strcmp( attribute[i], "buttons" ) == 0 )
-						&& (*m_itr).get_info( FeRomInfo::Buttons ).empty() )
-					(*m_itr).set_info( FeRomInfo::Buttons, attribute[i+1] );
-			}
+		for ( int i=0; attribute[i]; i+=2 )
+		{
+			if ( strcmp( attribute[i], "type" ) == 0 )
+				type = attribute[i+1];
+			else if ( strcmp( attribute[i], "ways" ) == 0 )
+				ways = attribute[i+1];
+
+			if (( strcmp( attribute[i], "buttons" ) == 0 )
+					&& m_entry.buttons.empty() )
+				m_entry.buttons = attribute[i+1];
+		}
 
-			struct my_map_struct { const char *in; const char *out; };
-			my_map_struct my_map[] =
-			{
-				{ "stick", "joystick (analog)" },
-				{ "doublejoy", "double joystick" },
-				{ NULL, NULL }
-			};
+		struct my_map_struct { const char *in; const char *out; };
+		my_map_struct my_map[] =
+		{
+			{ "stick", "joystick (analog)" },
+			{ "doublejoy", "double joystick" },
+			{ NULL, NULL }
+		};
 
-			if ( type.compare( "joy" ) == 0 )
-			{
-				// construct the joystick name
-				//
-				type = "joystick (";
-				type += ways;
-				type += "-way)";
-			}
-			else
-			{
-				// we also do a bit of name remapping
-				//
-				int i=0;
-				while ( my_map[i].in != NULL )
-				{
-					if ( type.compare( my_map[i].in ) == 0 )
-					{
-						type = my_map[i].out;
-						break;
-					}
-					i++;
-				}
-			}
-			(*m_itr).set_info( FeRomInfo::Control, old_type + type );
-		}
-		else if ( strcmp( element, "disk" ) == 0 )
+		if ( type.compare( "joy" ) == 0 )
 		{
-			m_chd=true;
+			// construct the joystick name
+			//
+			type = "joystick (";
+			type += ways;
+			type += "-way)";
 		}
-		else if ( strcmp( element, "extension" ) == 0 )
+		else
 		{
+			// we also do a bit of name remapping
 			//
-			// The extension attribute is encountered when parsing machines
-			// in connection with -listsoftware processing.  This indicates
-			// file extensions supported when emulating software on the given
-			// machine (so for sega genesis for example, this should be giving
-			// us "smd", "bin", "md" and "gen")
-			//
-			for ( int i=0; attribute[i]; i+=2 )
+			int i=0;
+			while ( my_map[i].in != NULL )
 			{
-				if ( strcmp( attribute[i], "name" ) == 0 )
+				if ( type.compare( my_map[i].in ) == 0 )
 				{
-					m_sl_exts.push_back( attribute[i+1] );
+					type = my_map[i].out;
 					break;
 				}
+				i++;
 			}
 		}
-		// "cloneof", "genre" and "buttons" elements appear in hyperspin .xml
-		// "publisher" in listsoftware xml
-		else if (( strcmp( element, "description" ) == 0 )
-				|| ( strcmp( element, "cloneof" ) == 0 )
-				|| ( strcmp( element, "genre" ) == 0 )
-				|| ( strcmp( element, "year" ) == 0 )
-				|| ( strcmp( element, "publisher" ) == 0 )
-				|| ( strcmp( element, "manufacturer" ) == 0 )
-				|| ( strcmp( element, "buttons" ) == 0 ))
-		{
-			m_element_open=true;
-		}
-		// "info"/"alt_title" in listsoftware xml
-		else if ( strcmp( element, "info" ) == 0 )
-		{
-			std::string value;
-			bool found=false;
 
-			for ( int i=0; attribute[i]; i+=2 )
+		if ( !m_entry.control.empty() )
+			m_entry.control += ",";
+
+		m_entry.control += type;
+	}
+	else if ( strcmp( element, "disk" ) == 0 )
+	{
+		m_entry.flags |= FeListXMLDigest::Entry::Chd;
+	}
+	else if ( strcmp( element, "extension" ) == 0 )
+	{
+		//
+		// The extension attribute is encountered when parsing machines
+		// in connection with -listsoftware processing.  This indicates
+		// file extensions supported when emulating software on the given
+		// machine (so for sega genesis for example, this should be giving
+		// us "smd", "bin", "md" and "gen")
+		//
+		for ( int i=0; attribute[i]; i+=2 )
+		{
+			if ( strcmp( attribute[i], "name" ) == 0 )
 			{
-				if (( strcmp( attribute[i], "name" ) == 0 )
-						&& ( strcmp( attribute[i+1], "alt_title" ) == 0 ))
-					found = true;
-				else if ( strcmp( attribute[i], "value" ) == 0 )
-					value = attribute[i+1];
+				m_entry.extensions.push_back( attribute[i+1] );
+				break;
 			}
+		}
+	}
+	else if ( strcmp( element, "description" ) == 0 )
+		m_text = &m_entry.description;
+	else if ( strcmp( element, "year" ) == 0 )
+		m_text = &m_entry.year;
+	// "publisher" in listsoftware xml
+	else if (( strcmp( element, "manufacturer" ) == 0 )
+			|| ( strcmp( element, "publisher" ) == 0 ))
+		m_text = &m_entry.manufacturer;
+	// "cloneof", "genre" and "buttons" elements appear in hyperspin .xml
+	else if ( strcmp( element, "cloneof" ) == 0 )
+		m_text = &m_entry.cloneof;
+	else if ( strcmp( element, "genre" ) == 0 )
+		m_text = &m_entry.category;
+	else if ( strcmp( element, "buttons" ) == 0 )
+	{
+		m_text = &m_entry.buttons;
+		m_entry.flags |= FeListXMLDigest::Entry::ForceButtons;
+	}
+	// "info"/"alt_title" in listsoftware xml
+	else if ( strcmp( element, "info" ) == 0 )
+	{
+		std::string value;
+		bool found=false;
 
-			if ( found )
-				(*m_itr).set_info( FeRomInfo::AltTitle, value );
+		for ( int i=0; attribute[i]; i+=2 )
+		{
+			if (( strcmp( attribute[i], "name" ) == 0 )
+					&& ( strcmp( attribute[i+1], "alt_title" ) == 0 ))
+				found = true;
+			else if ( strcmp( attribute[i], "value" ) == 0 )
+				value = attribute[i+1];
 		}
+
+		if ( found )
+			m_entry.alt_title = value;
 	}
+
+	if ( m_text )
+		m_element_open=true;
 }
 
 void FeListXMLParser::end_element( const char *element )
 {
-	if (( strcmp( element, "game" ) == 0 )
-		|| ( strcmp( element, "software" ) == 0 )
-		|| ( strcmp( element, "machine" ) == 0 ))
+	if ( m_skip_depth )
 	{
-		if ( m_collect_data )
-		{
-			m_collect_data = false;
+		m_skip_depth--;
+		return;
+	}
 
-			if ( !m_keep_rom )
-				m_discarded.push_back( m_itr );
-			else
-			{
-				//
-				// Construct the extra info now
-				//
-				std::string extra;
-				if ( m_chd )
-					extra += "chd";
+	if ( m_element_open )
+	{
+		m_text->swap( m_current_data );
+		m_current_data.clear();
+		m_text=NULL;
+		m_element_open=false;
+	}
+	else if ( m_collect_data && is_machine_element( element ))
+	{
+		m_collect_data = false;
+		apply_entry( m_entry );
 
-				if ( m_mechanical )
-				{
-					if ( !extra.empty() )
-						extra += ",";
+		if ( m_digest )
+			m_digest->entries.push_back( std::move( m_entry ) );
+	}
+}
 
-					extra += "mechanical";
-				}
+void FeListXMLParser::apply_entry( const FeListXMLDigest::Entry &e )
+{
+	FeRomInfoListType::iterator itr;
 
-				(*m_itr).set_info( FeRomInfo::Extra, extra );
-				(*m_itr).set_info( FeRomInfo::DisplayCount, as_str( m_displays ) );
-			}
+	auto found = m_map.find( e.name );
+	if ( found != m_map.end() )
+		itr = (*found).second;
+	else if ( m_ctx.full )
+	{
+		m_ctx.romlist.push_back( FeRomInfo( e.name ) );
+		itr = m_ctx.romlist.end();
+		--itr;
+	}
+	else
+		return;
 
-			m_count++;
+	for ( std::vector<std::string>::const_iterator ite = e.extensions.begin();
+			ite != e.extensions.end(); ++ite )
+	{
+		if ( std::find( m_sl_exts.begin(), m_sl_exts.end(), *ite ) == m_sl_exts.end() )
+			m_sl_exts.push_back( *ite );
+	}
 
-			static int last_percent( 0 );
-			if ( !m_ctx.full && ( !m_ctx.romlist.empty() ))
-			{
-				int per = m_ctx.progress_past
-					+ m_count * m_ctx.progress_range
-					/ m_ctx.romlist.size();
+	FeRomInfo &rom = *itr;
+	set_if_present( rom, FeRomInfo::Title, e.description );
+	set_if_present( rom, FeRomInfo::Year, e.year );
+	set_if_present( rom, FeRomInfo::Manufacturer, e.manufacturer );
+	set_if_present( rom, FeRomInfo::Cloneof, e.cloneof );
+	set_if_present( rom, FeRomInfo::AltRomname, e.romof );
+	set_if_present( rom, FeRomInfo::Rotation, e.rotation );
+	set_if_present( rom, FeRomInfo::DisplayType, e.display_type );
+	set_if_present( rom, FeRomInfo::Status, e.status );
+	set_if_present( rom, FeRomInfo::Category, e.category );
+	set_if_present( rom, FeRomInfo::AltTitle, e.alt_title );
+
+	if ( rom.get_info( FeRomInfo::Players ).empty() )
+		set_if_present( rom, FeRomInfo::Players, e.players );
+
+	if (( e.flags & FeListXMLDigest::Entry::ForceButtons )
+			|| rom.get_info( FeRomInfo::Buttons ).empty() )
+		set_if_present( rom, FeRomInfo::Buttons, e.buttons );
+
+	if ( !e.control.empty() )
+	{
+		std::string control = rom.get_info( FeRomInfo::Control );
+		if ( !control.empty() )
+			control += ",";
 
-				if ( per != last_percent )
-				{
-					last_percent = per;
+		rom.set_info( FeRomInfo::Control, control + e.control );
+	}
+
+	if ( e.flags & FeListXMLDigest::Entry::Discard )
+		m_discarded.push_back( itr );
+	else
+	{
+		//
+		// Construct the extra info now
+		//
+		std::string extra;
+		if ( e.flags & FeListXMLDigest::Entry::Chd )
+			extra += "chd";
 
-					std::cout << "\b\b\b\b" << std::setw(3)
-						<< last_percent << '%' << std::flush;
+		if ( e.flags & FeListXMLDigest::Entry::Mechanical )
+		{
+			if ( !extra.empty() )
+				extra += ",";
 
-					if ( m_ui_update )
-					{
-						if ( m_ui_update( m_ui_update_data,
-								last_percent,
-								(*m_itr).get_info( FeRomInfo::Title ) ) == false )
-							set_continue_parse( false );
-					}
-				}
-			}
+			extra += "mechanical";
 		}
+
+		rom.set_info( FeRomInfo::Extra, extra );
+		rom.set_info( FeRomInfo::DisplayCount, as_str( e.displays ) );
 	}
 
-	if ( m_element_open )
+	m_count++;
+
+	if ( !m_ctx.full && ( !m_ctx.romlist.empty() ))
 	{
-		if ( strcmp( element, "description" ) == 0 )
-			(*m_itr).set_info( FeRomInfo::Title, m_current_data );
-		else if ( strcmp( element, "year" ) == 0 )
-			(*m_itr).set_info( FeRomInfo::Year, m_current_data );
-		else if (( strcmp( element, "manufacturer" ) == 0 )
-				|| ( strcmp( element, "publisher" ) == 0 ))
-			(*m_itr).set_info( FeRomInfo::Manufacturer, m_current_data );
-		else if ( strcmp( element, "cloneof" ) == 0 ) // Hyperspin .xml
-			(*m_itr).set_info( FeRomInfo::Cloneof, m_current_data );
-		else if ( strcmp( element, "genre" ) == 0 ) // Hyperspin .xml
-			(*m_itr).set_info( FeRomInfo::Category, m_current_data );
-		else if ( strcmp( element, "buttons" ) == 0 ) // Hyperspin .xml
-			(*m_itr).set_info( FeRomInfo::Buttons, m_current_data );
+		int per = m_ctx.progress_past
+			+ m_count * m_ctx.progress_range
+			/ m_ctx.romlist.size();
 
-		m_current_data.clear();
-		m_element_open=false;
+		if ( per != m_last_percent )
+		{
+			m_last_percent = per;
+
+			if ( m_ctx.console_progress )
+				std::cout << "\b\b\b\b" << std::setw(3)
+					<< m_last_percent << '%' << std::flush;
+
+			if ( m_ui_update )
+			{
+				if ( m_ui_update( m_ui_update_data,
+						m_last_percent,
+						rom.get_info( FeRomInfo::Title ) ) == false )
+					set_continue_parse( false );
+			}
+		}
 	}
 }
 
 void FeListXMLParser::pre_parse()
 {
 	m_count=0;
+	m_skip_depth=0;
+	m_collect_data=false;
+	m_text=NULL;
+	m_sl_exts.clear();
 
 	m_map.clear();
+	m_map.reserve( m_ctx.romlist.size() );
 	for ( FeRomInfoListType::iterator itr=m_ctx.romlist.begin();
 			itr != m_ctx.romlist.end(); ++itr )
-		m_map[ (*itr).get_info( FeRomInfo::Romname ).c_str() ] = itr;
+		m_map[ (*itr).get_info( FeRomInfo::Romname ) ] = itr;
 
-	std::cout << "    ";
+	if ( m_ctx.console_progress )
+		std::cout << "    ";
 }
 
 void FeListXMLParser::post_parse()
 {
-	std::cout << std::endl;
+	if ( m_ctx.console_progress )
+		std::cout << std::endl;
 
 	if ( !m_discarded.empty() )
 	{
@@ -464,6 +600,37 @@ bool FeListXMLParser::parse_command( const std::string &prog, const std::string
 {
 	pre_parse();
 
+	//
+	// Running the emulator for its -listxml output takes a while, so the
+	// parsed output is kept as a digest that is reused for as long as the
+	// executable is unchanged
+	//
+	FeListXMLDigest digest;
+	std::string exe = find_program( prog );
+	std::int64_t mtime = exe.empty() ? 0 : file_mtime( exe );
+	std::uint64_t size = exe.empty() ? 0 : file_size( exe );
+
+	bool cached = false;
+	if ( mtime )
+	{
+		std::lock_guard<std::mutex> l( g_listxml_cache_mutex );
+		cached = FeCache::load_listxml( exe, digest )
+			&& digest.matches( exe, size, mtime );
+	}
+
+	if ( cached )
+	{
+		FeDebug() << "Using cached -listxml info for " << exe
+			<< " (" << digest.build << ")" << std::endl;
+
+		for ( std::vector<FeListXMLDigest::Entry>::const_iterator itr = digest.entries.begin();
+				( itr != digest.entries.end() ) && m_continue_parse; ++itr )
+			apply_entry( *itr );
+
+		post_parse();
+		return true;
+	}
+
 	std::string base_args = "-listxml";
 
 	//
@@ -488,8 +655,23 @@ bool FeListXMLParser::parse_command( const std::string &prog, const std::string
 	// }
 	// else
 
+	digest = FeListXMLDigest();
+	digest.executable = exe;
+	digest.mtime = mtime;
+	digest.size = size;
+	m_digest = &digest;
+
 	ret_val = parse_internal( prog, base_args, work_dir );
 
+	m_digest = NULL;
+
+	// Only keep complete output, not that of a cancelled import
+	if ( ret_val && mtime && m_continue_parse && !digest.entries.empty() )
+	{
+		std::lock_guard<std::mutex> l( g_listxml_cache_mutex );
+		FeCache::save_listxml( digest );
+	}
+
 	post_parse();
 	return ret_val;
 }
@@ -24,10 +24,17 @@
 #define FE_XML_HPP
 
 #include <string>
+#include <string_view>
 #include <set>
 #include <map>
+#include <unordered_map>
 #include <vector>
+#include <cstdint>
 #include "scraper_base.hpp"
+#include "fe_base.hpp"
+#include "cereal/cereal.hpp"
+#include <cereal/types/string.hpp>
+#include <cereal/types/vector.hpp>
 
 class FeXMLParser
 {
@@ -62,12 +69,74 @@ protected:
 	bool parse_internal( const std::string &, const std::string &, const std::string & );
 };
 
-class FeMapComp
+//
+// The fields we use from the -listxml output of an emulator, one entry per
+// machine.  Digests are persisted through FeCache keyed by the emulator
+// executable's path, size and modified time, so that later imports can skip
+// running the emulator.
+//
+class FeListXMLDigest
 {
 public:
-	bool operator()(const char *lhs, const char *rhs) const;
+	struct Entry
+	{
+		enum Flags
+		{
+			Discard=1,      // bios or device, removed from the romlist
+			Chd=2,
+			Mechanical=4,
+			ForceButtons=8  // buttons came from a <buttons> element
+		};
+
+		std::string name;
+		std::string description;
+		std::string year;
+		std::string manufacturer;
+		std::string cloneof;
+		std::string romof;
+		std::string rotation;
+		std::string display_type;
+		std::string status;
+		std::string players;
+		std::string buttons;
+		std::string control;
+		std::string category;
+		std::string alt_title;
+		std::vector<std::string> extensions; // softlist file extensions
+		std::int32_t displays=0;
+		std::uint32_t flags=0;
+
+		template<class Archive>
+		void serialize( Archive &archive )
+		{
+			archive( name, description, year, manufacturer, cloneof, romof,
+				rotation, display_type, status, players, buttons, control,
+				category, alt_title, extensions, displays, flags );
+		}
+	};
+
+	std::string executable;
+	std::int64_t mtime=0;
+	std::uint64_t size=0;
+	std::string build; // emulator version reported in the xml
+	std::vector<Entry> entries;
+
+	// return true if this digest was made by "exe" with the given size and mtime
+	bool matches( const std::string &exe, std::uint64_t s, std::int64_t m ) const
+	{
+		return ( m != 0 ) && ( mtime == m ) && ( size == s ) && ( executable.compare( exe ) == 0 );
+	};
+
+	template<class Archive>
+	void serialize( Archive &archive, std::uint32_t const version )
+	{
+		if ( version != FE_CACHE_VERSION ) throw "Invalid FeListXMLDigest cache";
+		archive( executable, mtime, size, build, entries );
+	}
 };
 
+CEREAL_CLASS_VERSION( FeListXMLDigest, FE_CACHE_VERSION );
+
 class FeListXMLParser : public FeXMLParser
 {
 public:
@@ -80,18 +149,20 @@ public:
 
 private:
 	FeImporterContext &m_ctx;
-	FeRomInfoListType::iterator m_itr;
-	std::map<const char *, FeRomInfoListType::iterator, FeMapComp> m_map;
+	std::unordered_map<std::string_view, FeRomInfoListType::iterator> m_map;
 	std::vector<FeRomInfoListType::iterator> m_discarded;
+	FeListXMLDigest::Entry m_entry; // machine currently being parsed
+	FeListXMLDigest *m_digest; // when set, every machine parsed is added to it
+	std::string *m_text; // m_entry field that the open element's text goes to
 	int m_count;
-	int m_displays;
+	int m_last_percent;
+	int m_skip_depth; // >0 while inside an element whose contents we ignore
 	bool m_collect_data;
-	bool m_chd;
-	bool m_mechanical;
-	std::vector<std::string> m_sl_exts; // softlists: supported extensions
+	std::vector<std::string> m_sl_exts; // softlists: extensions of the romlist's machines
 
 	void pre_parse();
 	void post_parse();
+	void apply_entry( const FeListXMLDigest::Entry &e );
 
 	void start_element( const char *, const char ** );
 	void end_element( const char * );
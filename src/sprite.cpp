@@ -57,6 +57,7 @@
 ////////////////////////////////////////////////////////////
 #include "sprite.hpp"
 #include "fe_present.hpp"
+#include "fe_batch.hpp"
 #include <SFML/OpenGL.hpp>
 #include <SFML/Graphics/Texture.hpp>
 #include <SFML/Graphics/RenderTarget.hpp>
@@ -79,6 +80,7 @@ FeSprite::FeSprite() :
 m_vertices( sf::PrimitiveType::TriangleStrip, 4 ),
 m_texture    (NULL),
 m_textureRect(),
+m_textureOffset( 0.f, 0.f ),
 m_pinch( 0.f, 0.f ),
 m_skew( 0.f, 0.f ),
 m_border( 0, 0, 0, 0 ),
@@ -93,6 +95,7 @@ FeSprite::FeSprite(const sf::Texture& texture) :
 m_vertices( sf::PrimitiveType::TriangleStrip, 4 ),
 m_texture    (NULL),
 m_textureRect(),
+m_textureOffset( 0.f, 0.f ),
 m_pinch( 0.f, 0.f ),
 m_skew( 0.f, 0.f ),
 m_border( 0, 0, 0, 0 ),
@@ -108,6 +111,7 @@ FeSprite::FeSprite(const sf::Texture& texture, const sf::FloatRect& rectangle) :
 m_vertices( sf::PrimitiveType::TriangleStrip, 4 ),
 m_texture    (NULL),
 m_textureRect(),
+m_textureOffset( 0.f, 0.f ),
 m_pinch( 0.f, 0.f ),
 m_skew( 0.f, 0.f ),
 m_border( 0, 0, 0, 0 ),
@@ -142,6 +146,17 @@ void FeSprite::setTextureRect(const sf::FloatRect& rectangle)
 }
 
 
+////////////////////////////////////////////////////////////
+void FeSprite::setTextureOffset(const sf::Vector2f& offset)
+{
+    if (offset != m_textureOffset)
+    {
+        m_textureOffset = offset;
+        updateGeometry();
+    }
+}
+
+
 ////////////////////////////////////////////////////////////
 void FeSprite::setColor( sf::Color color)
 {
@@ -191,18 +206,35 @@ void FeSprite::draw(sf::RenderTarget& target, sf::RenderStates states) const
 		if ( m_vertices[0].color.a > 0 )
 			target.draw( m_vertices, states );
 
-		// Set anisotropic filtering
-		FePresent *fep = FePresent::script_get_fep();
-		if ( fep )
+		applyAnisotropicFilter();
+	}
+}
+
+////////////////////////////////////////////////////////////
+void FeSprite::batch( FeDrawBatch &b, sf::RenderStates states ) const
+{
+	if (m_texture)
+	{
+		states.transform *= getTransform();
+		states.texture = m_texture;
+		if ( m_vertices[0].color.a > 0 )
+			b.add( m_vertices, states, true );
+	}
+}
+
+////////////////////////////////////////////////////////////
+void FeSprite::applyAnisotropicFilter()
+{
+	FePresent *fep = FePresent::script_get_fep();
+	if ( fep )
+	{
+		int af_mode = fep->get_fes()->get_anisotropic();
+		if ( af_mode > 0 )
 		{
-			int af_mode = fep->get_fes()->get_anisotropic();
-			if ( af_mode > 0 )
-			{
-				GLfloat aniso_max;
-				glGetFloatv( GL_MAX_TEXTURE_MAX_ANISOTROPY_EXT, &aniso_max );
-				glTexParameterf( GL_TEXTURE_2D, GL_TEXTURE_MAX_ANISOTROPY_EXT, (GLfloat)std::min( (int)aniso_max, af_mode ));
-				glTexParameterf( GL_TEXTURE_2D, GL_TEXTURE_LOD_BIAS, -0.25 );
-			}
+			GLfloat aniso_max;
+			glGetFloatv( GL_MAX_TEXTURE_MAX_ANISOTROPY_EXT, &aniso_max );
+			glTexParameterf( GL_TEXTURE_2D, GL_TEXTURE_MAX_ANISOTROPY_EXT, (GLfloat)std::min( (int)aniso_max, af_mode ));
+			glTexParameterf( GL_TEXTURE_2D, GL_TEXTURE_LOD_BIAS, -0.25 );
 		}
 	}
 }
@@ -520,9 +552,12 @@ void FeSprite::updateGeometry()
 	}
 
 	//
-	// Finally, update the vertex colour
+	// Finally, update the vertex colour and offset the texture coordinates
 	//
 	for ( unsigned int i=0; i< m_vertices.getVertexCount(); i++ )
+	{
 		m_vertices[i].color = vert_colour;
+		m_vertices[i].texCoords += m_textureOffset;
+	}
 
 }
@@ -68,6 +68,8 @@ namespace sf
 	class Texture;
 };
 
+class FeDrawBatch;
+
 // sf::IntRect extended with edge-based fields
 struct IntEdges : public sf::IntRect
 {
@@ -179,6 +181,16 @@ public :
     ////////////////////////////////////////////////////////////
     void setTextureRect(const sf::FloatRect& rectangle);
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Set an offset added to the texture coordinates
+    ///
+    /// Used when the image is one area of a larger texture,
+    /// such as an atlas page.  The texture rect stays relative
+    /// to the image.
+    ///
+    ////////////////////////////////////////////////////////////
+    void setTextureOffset(const sf::Vector2f& offset);
+
     ////////////////////////////////////////////////////////////
     /// \brief Set the global color of the sprite
     ///
@@ -259,6 +271,19 @@ public :
 	float getBorderScale() const;
 	void setBorderScale( float s );
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Add the sprite to a draw batch
+    ///
+    ////////////////////////////////////////////////////////////
+	void batch( FeDrawBatch &b, sf::RenderStates states ) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Apply the anisotropic filtering setting to the
+    ///        currently bound texture
+    ///
+    ////////////////////////////////////////////////////////////
+	static void applyAnisotropicFilter();
+
 	using sf::Transformable::getRotation;
 	using sf::Transformable::setRotation;
 	using sf::Transformable::setPosition;
@@ -287,6 +312,7 @@ private :
 	sf::VertexArray m_vertices;
 	const sf::Texture* m_texture;     ///< Texture of the sprite
 	sf::FloatRect m_textureRect;      ///< Rectangle defining the area of the source texture to display
+	sf::Vector2f m_textureOffset;
 	sf::Vector2f m_pinch;
 	sf::Vector2f m_skew;
 	IntEdges m_border;
@@ -26,6 +26,7 @@
 #include <algorithm>
 
 #include "fe_present.hpp"
+#include "fe_batch.hpp"
 
 FeTextPrimitive::FeTextPrimitive( )
 	: m_texts( 1, sf::JustifyText( *FePresent::script_get_fep()->get_default_font() )),
@@ -38,7 +39,8 @@ FeTextPrimitive::FeTextPrimitive( )
 	m_outline( 0.0 ),
 	m_line_spacing( 1.0 ),
 	m_word_wrap( false ),
-	m_needs_pos_set( false )
+	m_needs_pos_set( false ),
+	m_layout_valid( false )
 {
 	setColor( sf::Color::White );
 	setBgOutlineColor( sf::Color::Black );
@@ -61,7 +63,8 @@ FeTextPrimitive::FeTextPrimitive(
 	m_outline( 0.0 ),
 	m_line_spacing( 1.0 ),
 	m_word_wrap( false ),
-	m_needs_pos_set( false )
+	m_needs_pos_set( false ),
+	m_layout_valid( false )
 {
 	setColor( colour );
 	setBgColor( bgcolour );
@@ -87,6 +90,9 @@ void FeTextPrimitive::setFrom( const FeTextPrimitive &c )
 	m_line_spacing = c.m_line_spacing;
 	m_word_wrap = c.m_word_wrap;
 	m_needs_pos_set = c.m_needs_pos_set;
+	m_layout_string = c.m_layout_string;
+	m_layout_key = c.m_layout_key;
+	m_layout_valid = c.m_layout_valid;
 }
 
 void FeTextPrimitive::setColor( sf::Color c )
@@ -158,13 +164,14 @@ void FeTextPrimitive::fit_string(
 	const sf::Font *font = getFont();
 	unsigned int charsize = m_texts[0].getCharacterSize();
 	unsigned int spacing = charsize;
+	const sf::GlyphTable glyphs( *font, charsize, m_texts[0].getStyle() & sf::Text::Bold );
 	float width = m_bgRect.getSize().x / m_texts[0].getScale().x;
 
 	int running_total( 0 );
 	int running_width( 0 );
 	int kerning( 0 );
 
-	const sf::Glyph *g = &font->getGlyph( s[i], charsize, m_texts[0].getStyle() & sf::Text::Bold );
+	const sf::Glyph *g = &glyphs.getGlyph( s[i] );
 
 	if ( font->getLineSpacing( spacing ) > spacing )
 		spacing = font->getLineSpacing( spacing );
@@ -190,7 +197,7 @@ void FeTextPrimitive::fit_string(
 				running_total += kerning;
 			}
 
-			g = &font->getGlyph( s[i], charsize, m_texts[0].getStyle() & sf::Text::Bold );
+			g = &glyphs.getGlyph( s[i] );
 			running_width = std::max( running_width, (int)( running_total + g->bounds.position.x + g->bounds.size.x ));
 			running_total += g->advance;
 
@@ -216,7 +223,7 @@ void FeTextPrimitive::fit_string(
 			j--;
 			kerning = font->getKerning( s[j], s[std::min( j + 1, (int)s.size() - 1 )], charsize );
 			running_total += kerning;
-			g = &font->getGlyph( s[j], charsize, m_texts[0].getStyle() & sf::Text::Bold );
+			g = &glyphs.getGlyph( s[j] );
 			running_width = std::max( running_width, (int)( running_total + g->bounds.position.x + g->bounds.size.x ));
 			running_total += g->advance;
 		}
@@ -251,8 +258,51 @@ void FeTextPrimitive::fit_string(
 	position = i;
 }
 
+bool FeTextPrimitive::LayoutKey::operator==( const LayoutKey &o ) const
+{
+	return ( font == o.font )
+		&& ( char_size == o.char_size )
+		&& ( style == o.style )
+		&& ( scale == o.scale )
+		&& ( size == o.size )
+		&& ( letter_spacing == o.letter_spacing )
+		&& ( line_spacing == o.line_spacing )
+		&& ( margin == o.margin )
+		&& ( justify == o.justify )
+		&& ( align == o.align )
+		&& ( first_line == o.first_line )
+		&& ( word_wrap == o.word_wrap );
+}
+
+FeTextPrimitive::LayoutKey FeTextPrimitive::get_layout_key() const
+{
+	LayoutKey k;
+	k.font = getFont();
+	k.char_size = m_texts[0].getCharacterSize();
+	k.style = m_texts[0].getStyle();
+	k.scale = m_texts[0].getScale();
+	k.size = m_bgRect.getSize();
+	k.letter_spacing = m_texts[0].getLetterSpacing();
+	k.line_spacing = m_line_spacing;
+	k.margin = m_margin;
+	k.justify = m_justify;
+	k.align = m_align;
+	k.first_line = m_first_line;
+	k.word_wrap = m_word_wrap;
+	return k;
+}
+
 void FeTextPrimitive::setString( const std::string &t )
 {
+	//
+	// Nothing to do if the string and everything that affects its layout
+	// are unchanged since the last call.  This is the common case for
+	// listbox rows that keep their text when the selection moves
+	//
+	LayoutKey key = get_layout_key();
+	if ( m_layout_valid && ( key == m_layout_key ) && ( t == m_layout_string ))
+		return;
+
 	//
 	// UTF-8 character encoding is assumed.
 	// Need to convert to UTF-32 before giving string to SFML
@@ -266,12 +316,19 @@ void FeTextPrimitive::setString( const std::string &t )
 	std::fill_n( back_inserter( tmp ), 1, L' ' );
 
 	setString( tmp );
+
+	// fit_string() may have clamped the first line, so take the key again
+	m_layout_string = t;
+	m_layout_key = get_layout_key();
+	m_layout_valid = true;
 }
 
 sf::Vector2f FeTextPrimitive::setString(
 			const std::basic_string<std::uint32_t> &t,
 			int position )
 {
+	m_layout_valid = false;
+
 	//
 	// We count the total lines
 	//
@@ -720,3 +777,16 @@ void FeTextPrimitive::draw( sf::RenderTarget &target, sf::RenderStates states )
 		for ( unsigned int i=0; i < m_texts.size(); i++ )
 			target.draw( m_texts[i], states );
 }
+
+void FeTextPrimitive::batch( FeDrawBatch &b, sf::RenderStates states ) const
+{
+	if ( m_needs_pos_set )
+		set_positions();
+
+	if ( m_bgRect.getFillColor().a > 0 )
+		b.draw( m_bgRect, states );
+
+	if ( m_texts[0].getFillColor().a > 0 )
+		for ( unsigned int i=0; i < m_texts.size(); i++ )
+			m_texts[i].batch( b, states );
+}
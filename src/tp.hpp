@@ -27,6 +27,8 @@
 #include <SFML/Graphics.hpp>
 #include <vector>
 
+class FeDrawBatch;
+
 class FeTextPrimitive : public sf::Drawable
 {
 public:
@@ -117,6 +119,8 @@ public:
 	int getActualWidth(); // return the width of the actual text
 	int getActualHeight(); // return the height of the actual text
 
+	void batch( FeDrawBatch &b, sf::RenderStates states ) const;
+
 private:
 	sf::RectangleShape m_bgRect;
 	mutable std::vector<sf::JustifyText> m_texts;
@@ -138,6 +142,34 @@ private:
 
 	mutable bool m_needs_pos_set;
 
+	//
+	// The parameters that the last layout was made with.  setString()
+	// skips the layout entirely if neither these nor the string changed
+	//
+	struct LayoutKey
+	{
+		const sf::Font *font;
+		unsigned int char_size;
+		std::uint32_t style;
+		sf::Vector2f scale;
+		sf::Vector2f size;
+		float letter_spacing;
+		float line_spacing;
+		int margin;
+		int justify;
+		int align;
+		int first_line;
+		bool word_wrap;
+
+		bool operator==( const LayoutKey &o ) const;
+	};
+
+	LayoutKey get_layout_key() const;
+
+	std::string m_layout_string;
+	LayoutKey m_layout_key;
+	bool m_layout_valid;
+
 	//
 	// Determines how to fit the given string "s" into the text space
 	// parameters:
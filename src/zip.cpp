@@ -23,8 +23,11 @@
 #include "zip.hpp"
 #include "fe_util.hpp"
 #include "fe_base.hpp"
+#include "fe_cache.hpp"
 #include <iostream>
 #include <cstring>
+#include <cctype>
+#include <algorithm>
 #include <mutex>
 
 typedef void *(*FE_ZIP_ALLOC_CALLBACK) ( size_t );
@@ -36,21 +39,22 @@ namespace
 	// growing up to CONTENT_CACHE_SIZE entries max
 	//
 	const int CONTENT_CACHE_SIZE = 8;
-	std::vector < std::pair < std::string, std::vector < std::string > > > g_ccache;
+	std::vector < std::pair < std::string, std::shared_ptr < const FeArchiveToc > > > g_ccache;
 	std::recursive_mutex g_ccache_mutex;
 
-	bool check_content_cache( const std::string &archive,
-			std::vector < std::string > &contents )
+	//
+	// Tables of contents with at least this many entries are also saved
+	// to the on-disk cache. Smaller archives are cheap enough to re-read.
+	//
+	const int TOC_DISK_CACHE_MIN_ENTRIES = 32;
+
+	std::shared_ptr < const FeArchiveToc > check_content_cache( const std::string &archive )
 	{
-		size_t i=0;
-		for ( i=0; i < g_ccache.size(); i++ )
+		for ( size_t i=0; i < g_ccache.size(); i++ )
 		{
 			if ( g_ccache[i].first.compare( archive ) == 0 )
 			{
 				// Cache hit
-				//
-				contents = g_ccache[i].second; // vector copy
-
 				//
 				// Promote hit to the top of the cache
 				//
@@ -60,25 +64,21 @@ namespace
 					g_ccache[j].second.swap( g_ccache[j-1].second );
 				}
 
-				return true;
+				return g_ccache.front().second;
 			}
 		}
-		return false;
+		return std::shared_ptr < const FeArchiveToc >();
 	}
 
 	void add_to_content_cache( const std::string &archive,
-			std::vector < std::string > &contents )
+			std::shared_ptr < const FeArchiveToc > toc )
 	{
-		std::pair< std::string, std::vector< std::string > > temp;
-		temp.first = archive;
-		temp.second = contents; // vector copy
-
 		if ( g_ccache.size() < CONTENT_CACHE_SIZE )
 			g_ccache.push_back(
-				std::pair< std::string, std::vector< std::string > >() );
+				std::pair< std::string, std::shared_ptr < const FeArchiveToc > >() );
 
-		g_ccache.back().first.swap( temp.first );
-		g_ccache.back().second.swap( temp.second );
+		g_ccache.back().first = archive;
+		g_ccache.back().second.swap( toc );
 
 		for ( size_t i=g_ccache.size()-1; i > 0; i-- )
 		{
@@ -91,6 +91,22 @@ namespace
 		//
 	}
 
+	std::string to_lower( const std::string &s )
+	{
+		std::string retval( s );
+		std::transform( retval.begin(), retval.end(), retval.begin(),
+			[]( unsigned char c ) { return std::tolower( c ); } );
+		return retval;
+	}
+
+	std::string get_filename_part( const std::string &path )
+	{
+		size_t pos = path.find_last_of( "/\\" );
+		return ( pos == std::string::npos ) ? path : path.substr( pos + 1 );
+	}
+
+	bool read_toc( const char *archive, FeArchiveToc &toc );
+
 	// Count the number of path separators ('/' or '\') in path
 	//
 	int count_path_seps( const std::string &path )
@@ -163,6 +179,10 @@ bool fe_zip_open_to_buff(
 	const char *filename,
 	std::vector< char > &buff )
 {
+	std::shared_ptr<const FeArchiveToc> toc = fe_zip_get_toc( arch );
+	if ( !toc || !toc->find( filename ) )
+		return false;
+
 	struct archive *a = my_archive_init();
 	int r = archive_read_open_filename( a, arch, 8192 );
 
@@ -194,35 +214,41 @@ bool fe_zip_open_to_buff(
 	return false;
 }
 
-bool fe_zip_get_dir(
-	const char *archive,
-	std::vector<std::string> &result )
+namespace
 {
-	std::lock_guard<std::recursive_mutex> l( g_ccache_mutex );
-	if ( check_content_cache( archive, result ) )
-		return true;
+	bool read_toc( const char *archive, FeArchiveToc &toc )
+	{
+		struct archive *a = my_archive_init();
+		int r = archive_read_open_filename( a, archive, 8192 );
 
-	struct archive *a = my_archive_init();
-	int r = archive_read_open_filename( a, archive, 8192 );
+		if ( r != ARCHIVE_OK )
+		{
+			FeLog() << "Error opening archive: "
+				<< archive << std::endl;
+			archive_read_free( a );
+			return false;
+		}
 
-	if ( r != ARCHIVE_OK )
-	{
-		FeLog() << "Error opening archive: "
-			<< archive << std::endl;
-		archive_read_free( a );
-		return false;
-	}
+		struct archive_entry *ae;
 
-	struct archive_entry *ae;
+		std::uint32_t i=0;
+		while ( archive_read_next_header( a, &ae ) == ARCHIVE_OK )
+		{
+			FeArchiveToc::Entry e;
+			e.name = archive_entry_pathname( ae );
+			e.index = i++;
 
-	while ( archive_read_next_header( a, &ae ) == ARCHIVE_OK )
-		result.push_back( archive_entry_pathname( ae ) );
+			// libarchive doesn't report the compressed size, comp_size stays 0
+			if ( archive_entry_size_is_set( ae ) )
+				e.size = archive_entry_size( ae );
 
-	archive_read_free( a );
+			toc.add_entry( e );
+		}
 
-	add_to_content_cache( archive, result );
-	return true;
-}
+		archive_read_free( a );
+		return true;
+	}
+};
 
 #else
 
@@ -233,6 +259,14 @@ bool fe_zip_open_to_buff(
 	const char *filename,
 	std::vector< char > &buff )
 {
+	std::shared_ptr<const FeArchiveToc> toc = fe_zip_get_toc( archive );
+	if ( !toc )
+		return false;
+
+	const FeArchiveToc::Entry *e = toc->find( filename );
+	if ( !e )
+		return false;
+
 	mz_zip_archive zip;
 	memset( &zip, 0, sizeof( zip ) );
 
@@ -243,16 +277,10 @@ bool fe_zip_open_to_buff(
 		return false;
 	}
 
-	int index = mz_zip_reader_locate_file( &zip,
-		filename, NULL, 0 );
-	if ( index < 0 )
-	{
-		mz_zip_reader_end( &zip );
-		return false;
-	}
-
+	int index = e->index;
 	mz_zip_archive_file_stat file_stat;
-	if ( !mz_zip_reader_file_stat(&zip, index, &file_stat) )
+	if (( index < (int)mz_zip_reader_get_num_files( &zip ) )
+		&& !mz_zip_reader_file_stat(&zip, index, &file_stat) )
 	{
 		FeLog() << "Error reading filestats. zip: "
 			<< archive << ", file: " << filename << std::endl;
@@ -260,6 +288,20 @@ bool fe_zip_open_to_buff(
 		return false;
 	}
 
+	// If the zip changed after its contents were read, the index can
+	// point at another member or be past the end.  Look the member up
+	// by name instead
+	if (( index >= (int)mz_zip_reader_get_num_files( &zip ) )
+		|| ( e->name.compare( file_stat.m_filename ) != 0 ))
+	{
+		index = mz_zip_reader_locate_file( &zip, e->name.c_str(), NULL, 0 );
+		if (( index < 0 ) || !mz_zip_reader_file_stat( &zip, index, &file_stat ))
+		{
+			mz_zip_reader_end( &zip );
+			return false;
+		}
+	}
+
 	buff.resize( file_stat.m_uncomp_size );
 
 	if ( !mz_zip_reader_extract_to_mem( &zip,
@@ -275,39 +317,179 @@ bool fe_zip_open_to_buff(
 	return true;
 }
 
-bool fe_zip_get_dir(
-	const char *archive,
-	std::vector<std::string> &result )
+namespace
 {
-	std::lock_guard<std::recursive_mutex> l( g_ccache_mutex );
-	if ( check_content_cache( archive, result ) )
+	bool read_toc( const char *archive, FeArchiveToc &toc )
+	{
+		mz_zip_archive zip;
+		memset( &zip, 0, sizeof( zip ) );
+
+		if ( !mz_zip_reader_init_file( &zip, archive, 0 ) )
+		{
+			FeLog() << "Error initializing zip: "
+				<< archive << std::endl;
+			return false;
+		}
+
+		for ( int i=0; i<(int)mz_zip_reader_get_num_files(&zip); i++)
+		{
+			mz_zip_archive_file_stat file_stat;
+			if ( mz_zip_reader_file_stat(&zip, i, &file_stat) )
+			{
+				FeArchiveToc::Entry e;
+				e.name = file_stat.m_filename;
+				e.index = i;
+				e.offset = file_stat.m_local_header_ofs;
+				e.comp_size = file_stat.m_comp_size;
+				e.size = file_stat.m_uncomp_size;
+				e.crc = file_stat.m_crc32;
+				e.has_crc = true;
+
+				toc.add_entry( e );
+			}
+		}
+
+		mz_zip_reader_end( &zip );
 		return true;
+	}
+};
 
-	mz_zip_archive zip;
-	memset( &zip, 0, sizeof( zip ) );
+#endif // USE_LIBARCHIVE
 
-	if ( !mz_zip_reader_init_file( &zip, archive, 0 ) )
+FeArchiveToc::FeArchiveToc()
+	: m_size( 0 ),
+	m_mtime( 0 )
+{
+}
+
+FeArchiveToc::FeArchiveToc( const std::string &path,
+	std::uint64_t size, std::int64_t mtime )
+	: m_path( path ),
+	m_size( size ),
+	m_mtime( mtime )
+{
+}
+
+bool FeArchiveToc::matches( const std::string &path,
+	std::uint64_t size, std::int64_t mtime ) const
+{
+	return (( m_size == size ) && ( m_mtime == mtime )
+		&& ( m_path.compare( path ) == 0 ));
+}
+
+void FeArchiveToc::add_entry( const Entry &e )
+{
+	m_entries.push_back( e );
+}
+
+void FeArchiveToc::build_index()
+{
+	m_index.clear();
+	m_index.reserve( m_entries.size() );
+
+	for ( int i=0; i<(int)m_entries.size(); i++ )
 	{
-		FeLog() << "Error initializing zip: "
-			<< archive << std::endl;
-		return false;
+		IndexEntry ie;
+		ie.key = to_lower( get_filename_part( m_entries[i].name ) );
+		ie.pos = i;
+		m_index.push_back( ie );
+	}
+
+	std::stable_sort( m_index.begin(), m_index.end(),
+		[]( const IndexEntry &a, const IndexEntry &b ) { return a.key < b.key; } );
+}
+
+const FeArchiveToc::Entry *FeArchiveToc::find( const std::string &name ) const
+{
+	std::string key = to_lower( get_filename_part( name ) );
+
+	std::vector<IndexEntry>::const_iterator itr = std::lower_bound(
+		m_index.begin(), m_index.end(), key,
+		[]( const IndexEntry &a, const std::string &k ) { return a.key < k; } );
+
+	// Member names match regardless of case, as in the archive readers.
+	// An exact match wins over one that only differs in case
+	const Entry *found = NULL;
+	for ( ; ( itr != m_index.end() ) && ( (*itr).key == key ); ++itr )
+	{
+		const Entry &e = m_entries[ (*itr).pos ];
+		if ( e.name.compare( name ) == 0 )
+			return &e;
+
+		if ( !found && ( icompare( e.name, name ) == 0 ))
+			found = &e;
 	}
 
-	for ( int i=0; i<(int)mz_zip_reader_get_num_files(&zip); i++)
+	return found;
+}
+
+void FeArchiveToc::find_by_filename_prefix( const std::string &prefix,
+	std::vector<int> &result ) const
+{
+	std::string key = to_lower( prefix );
+	size_t first = result.size();
+
+	std::vector<IndexEntry>::const_iterator itr = std::lower_bound(
+		m_index.begin(), m_index.end(), key,
+		[]( const IndexEntry &a, const std::string &k ) { return a.key < k; } );
+
+	for ( ; ( itr != m_index.end() )
+			&& ( (*itr).key.compare( 0, key.size(), key ) == 0 ); ++itr )
+		result.push_back( (*itr).pos );
+
+	std::sort( result.begin() + first, result.end() );
+}
+
+std::shared_ptr<const FeArchiveToc> fe_zip_get_toc( const std::string &archive )
+{
+	std::lock_guard<std::recursive_mutex> l( g_ccache_mutex );
+	std::uint64_t size = file_size( archive );
+	std::int64_t mtime = file_mtime( archive );
+
+	// The archive may have been rewritten since its contents were cached
+	std::shared_ptr<const FeArchiveToc> retval = check_content_cache( archive );
+	if ( retval && retval->matches( archive, size, mtime ))
+		return retval;
+
+	retval.reset();
+
+	std::shared_ptr<FeArchiveToc> toc = std::make_shared<FeArchiveToc>();
+	if ( !FeCache::load_archive_toc( archive, *toc )
+		|| !toc->matches( archive, size, mtime ) )
 	{
-		mz_zip_archive_file_stat file_stat;
-		if ( mz_zip_reader_file_stat(&zip, i, &file_stat) )
-			result.push_back( file_stat.m_filename );
+		*toc = FeArchiveToc( archive, size, mtime );
+		if ( !read_toc( archive.c_str(), *toc ) )
+			return retval;
+
+		toc->build_index();
+
+		if ( (int)toc->get_entries().size() >= TOC_DISK_CACHE_MIN_ENTRIES )
+			FeCache::save_archive_toc( archive, *toc );
 	}
 
-	mz_zip_reader_end( &zip );
+	retval = toc;
+	add_to_content_cache( archive, retval );
+	return retval;
+}
+
+bool fe_zip_get_dir(
+	const char *archive,
+	std::vector<std::string> &result )
+{
+	std::shared_ptr<const FeArchiveToc> toc = fe_zip_get_toc( archive );
+	if ( !toc )
+		return false;
+
+	const std::vector<FeArchiveToc::Entry> &entries = toc->get_entries();
+	result.reserve( result.size() + entries.size() );
+
+	for ( std::vector<FeArchiveToc::Entry>::const_iterator itr=entries.begin();
+			itr != entries.end(); ++itr )
+		result.push_back( (*itr).name );
 
-	add_to_content_cache( archive, result );
 	return true;
 }
 
-#endif // USE_LIBARCHIVE
-
 const char *FE_ARCHIVE_EXT[] =
 {
 	".zip",
@@ -426,27 +608,38 @@ void gather_archive_filenames_with_base(
 	const std::string &basename,
 	const char **exts )
 {
+	std::shared_ptr<const FeArchiveToc> toc = fe_zip_get_toc( archive );
+	if ( !toc )
+		return;
+
 	// Need to support basenames that contain path separators.
 	int sep_count = count_path_seps( basename );
 
-	std::vector<std::string> wl;
-	fe_zip_get_dir( archive.c_str(), wl );
-	for ( std::vector<std::string>::iterator itr=wl.begin();
-		itr!=wl.end(); ++itr )
+	//
+	// Narrow down the candidates using the toc's filename index.  The
+	// filename of any match must start with the last part of basename
+	//
+	std::vector<int> candidates;
+	toc->find_by_filename_prefix( get_filename_part( basename ), candidates );
+
+	const std::vector<FeArchiveToc::Entry> &entries = toc->get_entries();
+	for ( std::vector<int>::iterator itr=candidates.begin();
+		itr!=candidates.end(); ++itr )
 	{
-		size_t pos = get_pos_from_back( *itr, sep_count );
+		const std::string &name = entries[ *itr ].name;
+		size_t pos = get_pos_from_back( name, sep_count );
 
-		if ( icompare( (*itr).substr( pos, basename.size() ),
+		if ( icompare( name.substr( pos, basename.size() ),
 				basename ) == 0 )
 		{
 			if ( !exts )
-				in_list.push_back( *itr );
+				in_list.push_back( name );
 			else
 			{
-				if ( tail_compare( *itr, exts ) )
-					in_list.push_back( *itr );
+				if ( tail_compare( name, exts ) )
+					in_list.push_back( name );
 				else
-					out_list.push_back( *itr );
+					out_list.push_back( name );
 			}
 
 		}
@@ -25,7 +25,99 @@
 
 #include <string>
 #include <vector>
+#include <memory>
+#include <cstdint>
 #include <SFML/System/InputStream.hpp>
+#include "fe_base.hpp"
+#include "cereal/cereal.hpp"
+#include <cereal/types/string.hpp>
+#include <cereal/types/vector.hpp>
+
+//
+// Table of contents for an archive.  Holds the name, offset, size and crc of
+// each member along with a sorted index of member filenames, so that lookups
+// by basename are O(log n) even for archives with many thousands of entries.
+//
+// TOCs are kept in an in-memory cache and larger ones are also persisted
+// through FeCache, keyed by the archive's path, size and modified time.
+//
+class FeArchiveToc
+{
+public:
+	struct Entry
+	{
+		std::string name;
+		std::uint32_t index=0;     // position of member within the archive
+		std::uint64_t offset=0;    // local header offset (zip), 0 if unknown
+		std::uint64_t comp_size=0; // 0 if unknown
+		std::uint64_t size=0;
+		std::uint32_t crc=0;
+		bool has_crc=false;
+
+		template<class Archive>
+		void serialize( Archive &archive )
+		{
+			archive( name, index, offset, comp_size, size, crc, has_crc );
+		}
+	};
+
+	FeArchiveToc();
+	FeArchiveToc( const std::string &path, std::uint64_t size, std::int64_t mtime );
+
+	const std::string &get_path() const { return m_path; }
+	const std::vector<Entry> &get_entries() const { return m_entries; }
+
+	// return true if this toc was built from "path" with the given size and mtime
+	bool matches( const std::string &path, std::uint64_t size, std::int64_t mtime ) const;
+
+	void add_entry( const Entry &e );
+
+	// sort the filename index, call once all entries have been added
+	void build_index();
+
+	// Return the entry with the exact name "name", NULL if not found
+	const Entry *find( const std::string &name ) const;
+
+	// Append to "result" the positions (in m_entries) of entries whose
+	// filename (the part after the last path separator) starts with
+	// "prefix" (case insensitive).  Results are in archive order.
+	void find_by_filename_prefix( const std::string &prefix,
+		std::vector<int> &result ) const;
+
+	template<class Archive>
+	void serialize( Archive &archive, std::uint32_t const version )
+	{
+		if ( version != FE_CACHE_VERSION ) throw "Invalid FeArchiveToc cache";
+		archive( m_path, m_size, m_mtime, m_entries, m_index );
+	}
+
+private:
+	struct IndexEntry
+	{
+		std::string key; // lowercase filename
+		int pos=0;
+
+		template<class Archive>
+		void serialize( Archive &archive )
+		{
+			archive( key, pos );
+		}
+	};
+
+	std::string m_path;
+	std::uint64_t m_size;
+	std::int64_t m_mtime;
+	std::vector<Entry> m_entries;
+	std::vector<IndexEntry> m_index;
+};
+
+CEREAL_CLASS_VERSION( FeArchiveToc, FE_CACHE_VERSION );
+
+//
+// Get the table of contents for "archive", from the memory or disk cache
+// where possible.  Returns an empty pointer if the archive can't be read.
+//
+std::shared_ptr<const FeArchiveToc> fe_zip_get_toc( const std::string &archive );
 
 typedef void *(*FE_ZIP_ALLOC_CALLBACK) ( size_t );
 bool fe_zip_open_to_buff(
@@ -0,0 +1,69 @@
+/*
+ *
+ *  Attract-Mode Plus frontend
+ *  Copyright (C) 2025 Andrew Mickelson & Radek Dutkiewicz
+ *
+ *  This file is part of Attract-Mode Plus
+ *
+ *  Attract-Mode Plus is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Attract-Mode Plus is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Attract-Mode Plus.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef FE_TEST_HPP
+#define FE_TEST_HPP
+
+//
+// Minimal checks for the programs in test/.  Each program is built against
+// the frontend objects by "make test" and returns non-zero if a check failed
+//
+#include <iostream>
+#include <string>
+
+namespace FeTest
+{
+	inline int &failures() { static int f=0; return f; };
+
+	inline int report( const char *name )
+	{
+		if ( failures() )
+			std::cout << name << ": " << failures() << " check(s) failed" << std::endl;
+		else
+			std::cout << name << ": passed" << std::endl;
+
+		return failures() ? 1 : 0;
+	}
+
+	// Directory for temporary files, from the command line
+	inline std::string scratch_dir( int argc, char *argv[] )
+	{
+		std::string dir = ( argc > 1 ) ? argv[1] : ".";
+		if ( dir.back() != '/' )
+			dir += '/';
+
+		return dir;
+	}
+};
+
+#define FE_CHECK( expr ) \
+	do { if ( !( expr )) { \
+		std::cout << __FILE__ << ":" << __LINE__ << ": check failed: " << #expr << std::endl; \
+		FeTest::failures()++; } } while ( 0 )
+
+#define FE_CHECK_MSG( expr, msg ) \
+	do { if ( !( expr )) { \
+		std::cout << __FILE__ << ":" << __LINE__ << ": check failed: " << #expr \
+			<< " (" << msg << ")" << std::endl; \
+		FeTest::failures()++; } } while ( 0 )
+
+#endif
@@ -0,0 +1,315 @@
+/*
+ *
+ *  Attract-Mode Plus frontend
+ *  Copyright (C) 2025 Andrew Mickelson & Radek Dutkiewicz
+ *
+ *  This file is part of Attract-Mode Plus
+ *
+ *  Attract-Mode Plus is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Attract-Mode Plus is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Attract-Mode Plus.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+//
+// Checks that drawing a set of elements through FeDrawBatch produces the
+// same triangles, in the same order and with the same render states, as
+// drawing each element directly.  Draws are recorded rather than rendered,
+// so no window or GL context is needed
+//
+#include "fe_test.hpp"
+#include "fe_batch.hpp"
+
+#include <SFML/Graphics/RenderTarget.hpp>
+#include <SFML/Graphics/Texture.hpp>
+
+#include <vector>
+
+namespace
+{
+	class FeNullTarget : public sf::RenderTarget
+	{
+	public:
+		sf::Vector2u getSize() const override { return { 640, 480 }; };
+	};
+
+	struct FeRecordedDraw
+	{
+		sf::PrimitiveType type;
+		std::vector<sf::Vertex> vertices;
+		sf::RenderStates states;
+	};
+
+	class FeRecordingBatch : public FeDrawBatch
+	{
+	public:
+		FeRecordingBatch( sf::RenderTarget &t, std::vector<FeRecordedDraw> &out )
+			: FeDrawBatch( t ), m_out( out )
+		{
+		}
+
+	protected:
+		void submit( const sf::Drawable &d, const sf::RenderStates &states ) override
+		{
+			const sf::VertexArray *v = dynamic_cast<const sf::VertexArray *>( &d );
+			FE_CHECK( v != NULL );
+			if ( !v )
+				return;
+
+			FeRecordedDraw r;
+			r.type = v->getPrimitiveType();
+			for ( std::size_t i=0; i<v->getVertexCount(); i++ )
+				r.vertices.push_back( (*v)[i] );
+			r.states = states;
+			m_out.push_back( r );
+		}
+
+	private:
+		std::vector<FeRecordedDraw> &m_out;
+	};
+
+	struct FeElement
+	{
+		sf::VertexArray vertices;
+		sf::RenderStates states;
+	};
+
+	//
+	// The triangles drawn by consecutive draw calls with the same states,
+	// in world coordinates
+	//
+	struct FeRun
+	{
+		sf::PrimitiveType type;
+		sf::RenderStates states; // transform is not used
+		std::vector<sf::Vertex> vertices;
+	};
+
+	bool same_states( const sf::RenderStates &a, const sf::RenderStates &b )
+	{
+		return ( a.texture == b.texture )
+			&& ( a.shader == b.shader )
+			&& ( a.blendMode == b.blendMode )
+			&& ( a.stencilMode == b.stencilMode )
+			&& ( a.coordinateType == b.coordinateType );
+	}
+
+	bool same_vertex( const sf::Vertex &a, const sf::Vertex &b )
+	{
+		return ( a.position == b.position )
+			&& ( a.color == b.color )
+			&& ( a.texCoords == b.texCoords );
+	}
+
+	void add_run( std::vector<FeRun> &runs, const FeRecordedDraw &d )
+	{
+		FeRun run;
+		run.type = d.type;
+		run.states = d.states;
+
+		std::vector<sf::Vertex> v = d.vertices;
+		for ( std::vector<sf::Vertex>::iterator itr=v.begin(); itr!=v.end(); ++itr )
+			(*itr).position = d.states.transform.transformPoint( (*itr).position );
+
+		if ( d.type == sf::PrimitiveType::TriangleStrip )
+		{
+			run.type = sf::PrimitiveType::Triangles;
+			for ( std::size_t i=0; i+2<v.size(); i++ )
+			{
+				run.vertices.push_back( v[i] );
+				run.vertices.push_back( v[i+1] );
+				run.vertices.push_back( v[i+2] );
+			}
+		}
+		else if ( d.type == sf::PrimitiveType::Triangles )
+			run.vertices.assign( v.begin(), v.begin() + v.size() / 3 * 3 );
+		else
+			run.vertices = v;
+
+		if ( run.vertices.empty() )
+			return;
+
+		if ( !runs.empty()
+				&& ( run.type == sf::PrimitiveType::Triangles )
+				&& ( runs.back().type == sf::PrimitiveType::Triangles )
+				&& same_states( runs.back().states, run.states ))
+		{
+			runs.back().vertices.insert( runs.back().vertices.end(),
+				run.vertices.begin(), run.vertices.end() );
+		}
+		else
+			runs.push_back( run );
+	}
+
+	void compare_runs( const std::vector<FeRun> &direct, const std::vector<FeRun> &batched )
+	{
+		FE_CHECK( direct.size() == batched.size() );
+
+		for ( std::size_t i=0; i<std::min( direct.size(), batched.size() ); i++ )
+		{
+			FE_CHECK_MSG( direct[i].type == batched[i].type, "run " << i );
+			FE_CHECK_MSG( same_states( direct[i].states, batched[i].states ), "run " << i );
+			FE_CHECK_MSG( direct[i].vertices.size() == batched[i].vertices.size(), "run " << i );
+
+			for ( std::size_t j=0; j<std::min( direct[i].vertices.size(), batched[i].vertices.size() ); j++ )
+				FE_CHECK_MSG( same_vertex( direct[i].vertices[j], batched[i].vertices[j] ),
+					"run " << i << ", vertex " << j );
+		}
+	}
+
+	sf::VertexArray make_quad( float x, float y, float w, float h, sf::Color c )
+	{
+		sf::VertexArray v( sf::PrimitiveType::TriangleStrip, 4 );
+		v[0] = sf::Vertex{ { x, y }, c, { 0.f, 0.f } };
+		v[1] = sf::Vertex{ { x, y + h }, c, { 0.f, 1.f } };
+		v[2] = sf::Vertex{ { x + w, y }, c, { 1.f, 0.f } };
+		v[3] = sf::Vertex{ { x + w, y + h }, c, { 1.f, 1.f } };
+		return v;
+	}
+
+	FeElement make_element( const sf::VertexArray &v, const sf::RenderStates &rs )
+	{
+		FeElement e;
+		e.vertices = v;
+		e.states = rs;
+		return e;
+	}
+};
+
+int main()
+{
+	FeNullTarget target;
+	sf::Texture tex_a, tex_b;
+
+	// Shaders are only compared, never used, so stand-ins do without
+	// the GL context that a real sf::Shader needs
+	int shader_storage;
+	const sf::Shader *shader = reinterpret_cast<const sf::Shader *>( &shader_storage );
+
+	sf::StencilMode stencil;
+	stencil.stencilComparison = sf::StencilComparison::Equal;
+	stencil.stencilReference = 1;
+
+	std::vector<FeElement> elements;
+	sf::RenderStates rs;
+
+	// Three elements with texture A and different transforms form one batch
+	rs.texture = &tex_a;
+	rs.transform = sf::Transform().translate( { 10.f, 20.f } );
+	elements.push_back( make_element( make_quad( 0, 0, 32, 32, sf::Color::White ), rs ));
+
+	rs.transform = sf::Transform().scale( { 2.f, 3.f } );
+	elements.push_back( make_element( make_quad( 5, 5, 16, 8, sf::Color::Red ), rs ));
+
+	sf::VertexArray tri( sf::PrimitiveType::Triangles, 6 );
+	for ( int i=0; i<6; i++ )
+		tri[i] = sf::Vertex{ { i * 7.f, i * 3.f }, sf::Color( 10 * i, 20, 30 ), { i * 0.1f, 0.5f } };
+	rs.transform = sf::Transform().rotate( sf::degrees( 30.f ) );
+	elements.push_back( make_element( tri, rs ));
+
+	// Texture break
+	rs.texture = &tex_b;
+	rs.transform = sf::Transform::Identity;
+	elements.push_back( make_element( make_quad( 100, 100, 20, 20, sf::Color::Blue ), rs ));
+
+	// Shader break
+	rs.shader = shader;
+	elements.push_back( make_element( make_quad( 120, 100, 20, 20, sf::Color::Blue ), rs ));
+
+	// Blend break
+	rs.blendMode = sf::BlendAdd;
+	elements.push_back( make_element( make_quad( 140, 100, 20, 20, sf::Color::Blue ), rs ));
+
+	// Stencil break
+	rs.stencilMode = stencil;
+	elements.push_back( make_element( make_quad( 160, 100, 20, 20, sf::Color::Blue ), rs ));
+
+	// Coordinate type break
+	rs.coordinateType = sf::CoordinateType::Normalized;
+	elements.push_back( make_element( make_quad( 180, 100, 20, 20, sf::Color::Blue ), rs ));
+
+	// Lines can't be batched and are drawn on their own, in order
+	sf::VertexArray lines( sf::PrimitiveType::Lines, 2 );
+	lines[0] = sf::Vertex{ { 0.f, 0.f }, sf::Color::Green };
+	lines[1] = sf::Vertex{ { 50.f, 50.f }, sf::Color::Green };
+	rs = sf::RenderStates();
+	rs.transform = sf::Transform().translate( { 3.f, 4.f } );
+	elements.push_back( make_element( lines, rs ));
+
+	// A strip too short to draw anything
+	rs.texture = &tex_a;
+	sf::VertexArray short_strip( sf::PrimitiveType::TriangleStrip, 2 );
+	short_strip[0] = sf::Vertex{ { 1.f, 1.f } };
+	short_strip[1] = sf::Vertex{ { 2.f, 2.f } };
+	elements.push_back( make_element( short_strip, rs ));
+
+	// Texture A again after the lines starts a new batch, including a strip
+	// with a repeated vertex (degenerate triangles are kept)
+	elements.push_back( make_element( make_quad( 200, 0, 10, 10, sf::Color::Yellow ), rs ));
+
+	sf::VertexArray strip( sf::PrimitiveType::TriangleStrip, 6 );
+	strip[0] = sf::Vertex{ { 0.f, 0.f }, sf::Color::White, { 0.f, 0.f } };
+	strip[1] = sf::Vertex{ { 0.f, 10.f }, sf::Color::White, { 0.f, 1.f } };
+	strip[2] = sf::Vertex{ { 10.f, 0.f }, sf::Color::White, { 1.f, 0.f } };
+	strip[3] = strip[2];
+	strip[4] = sf::Vertex{ { 20.f, 0.f }, sf::Color::Cyan, { 0.f, 0.f } };
+	strip[5] = sf::Vertex{ { 20.f, 10.f }, sf::Color::Cyan, { 0.f, 1.f } };
+	rs.transform = sf::Transform().translate( { 50.f, 60.f } ).scale( { 0.5f, 0.5f } );
+	elements.push_back( make_element( strip, rs ));
+
+	//
+	// Direct drawing, one draw call per element
+	//
+	std::vector<FeRun> direct_runs;
+	for ( std::vector<FeElement>::iterator itr=elements.begin(); itr!=elements.end(); ++itr )
+	{
+		FeRecordedDraw d;
+		d.type = (*itr).vertices.getPrimitiveType();
+		for ( std::size_t i=0; i<(*itr).vertices.getVertexCount(); i++ )
+			d.vertices.push_back( (*itr).vertices[i] );
+		d.states = (*itr).states;
+		add_run( direct_runs, d );
+	}
+
+	//
+	// Batched drawing
+	//
+	std::vector<FeRecordedDraw> batched;
+	FeDrawBatch::reset_counts();
+	{
+		FeRecordingBatch b( target, batched );
+		for ( std::vector<FeElement>::iterator itr=elements.begin(); itr!=elements.end(); ++itr )
+			b.add( (*itr).vertices, (*itr).states );
+
+		b.flush();
+	}
+
+	std::vector<FeRun> batched_runs;
+	for ( std::vector<FeRecordedDraw>::iterator itr=batched.begin(); itr!=batched.end(); ++itr )
+	{
+		// Batched vertices are already transformed
+		if ( (*itr).type == sf::PrimitiveType::Triangles )
+			FE_CHECK( (*itr).states.transform == sf::Transform::Identity );
+
+		add_run( batched_runs, *itr );
+	}
+
+	compare_runs( direct_runs, batched_runs );
+
+	// Each batch needed a state change, so there is one draw call per run
+	FE_CHECK( batched.size() == 8 );
+	FE_CHECK( batched.size() == direct_runs.size() );
+	FE_CHECK( FeDrawBatch::get_draw_calls() == batched.size() );
+	FE_CHECK( FeDrawBatch::get_batched() == elements.size() - 2 );
+
+	return FeTest::report( "test_draw_batch" );
+}
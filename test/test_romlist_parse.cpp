@@ -0,0 +1,173 @@
+/*
+ *
+ *  Attract-Mode Plus frontend
+ *  Copyright (C) 2025 Andrew Mickelson & Radek Dutkiewicz
+ *
+ *  This file is part of Attract-Mode Plus
+ *
+ *  Attract-Mode Plus is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Attract-Mode Plus is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Attract-Mode Plus.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+//
+// Checks that the chunked romlist parser used by FeRomList::load_romlist_file()
+// gives the same roms as the per-line FeBaseConfigurable::load_from_file(),
+// and that the length bounded token_helper() matches the std::string one
+//
+#include "fe_test.hpp"
+#include "fe_romlist.hpp"
+#include "fe_util.hpp"
+#include "nowide/fstream.hpp"
+
+#include <cstdio>
+#include <vector>
+
+namespace
+{
+	const char *LINES[] =
+	{
+		"#Name;Title;Emulator;CloneOf;Year;Manufacturer;Category;Players;Rotation;Control;Status;DisplayCount;DisplayType;AltRomname;AltTitle;Extra;Buttons;Series;Language;Region;Rating",
+		"pacman;Pac-Man;mame;;1980;Namco;Maze;2;90;joystick (4-way);good;1;raster;;;;;;;;",
+		"mspacman;\"Ms. Pac-Man; Special\";mame;pacman;1981;;;;;;;;;;;;;;;;",
+		"  galaga ;Galaga;mame;;1981;Namco;Shooter;2;90;joystick;good;1;raster;;;;;;;;   ",
+		"",
+		"# comment;with;separators",
+		"dkong;\"Donkey \\\"Kong\\\"\";mame;;1981",
+		"emptyrow;;;;;;;;;;;;;;;;;;;;",
+		"\t;leading empty romname",
+		"short",
+		"unterminated;\"quote;mame",
+		NULL
+	};
+
+	void check_token_helper( const std::string &line, const char *sep )
+	{
+		// Trailing bytes that the bounded version must not read
+		std::string buff = line + "\"tail;x y";
+
+		size_t pos1=0, pos2=0;
+		std::string tok1, tok2;
+		int count=0;
+
+		for ( ;; )
+		{
+			bool r1 = token_helper( line, pos1, tok1, sep );
+			bool r2 = token_helper( buff.data(), line.size(), pos2, tok2, sep );
+
+			FE_CHECK_MSG( r1 == r2, "\"" << line << "\" token " << count );
+			FE_CHECK_MSG( tok1 == tok2, "\"" << line << "\" token " << count << ": \"" << tok1 << "\" != \"" << tok2 << "\"" );
+			FE_CHECK_MSG( pos1 == pos2, "\"" << line << "\" token " << count );
+
+			if (( pos1 >= line.size() ) || ( pos1 != pos2 ) || ( ++count > 64 ))
+				break;
+		}
+	}
+
+	std::string make_romlist( const char *eol, bool final_eol )
+	{
+		std::string s;
+		for ( int i=0; LINES[i]; i++ )
+		{
+			s += LINES[i];
+			s += eol;
+		}
+
+		// Enough rows of varying length for chunk boundaries to land mid line
+		for ( int i=0; i<300; i++ )
+		{
+			s += "game" + as_str( i ) + ";Title " + std::string( i % 23, 'x' )
+				+ ";mame;;" + as_str( 1980 + i % 20 ) + ";Maker;;;;;;;;;;;;;;;" + eol;
+		}
+
+		s += "lastgame;Last;mame";
+		if ( final_eol )
+			s += eol;
+
+		return s;
+	}
+
+	void check_romlist( const std::string &dir, const std::string &name, const std::string &content )
+	{
+		std::string path = dir + name;
+		{
+			nowide::ofstream out( path, std::ios::binary );
+			out.write( content.data(), content.size() );
+		}
+
+		// Reference result from the per-line parser
+		std::string config_path = dir;
+		FeRomList rl( config_path );
+		FE_CHECK( rl.load_from_file( path, ";" ) );
+		std::vector<FeRomInfo> expected( rl.get_list().begin(), rl.get_list().end() );
+		FE_CHECK_MSG( expected.size() > 300, name );
+
+		const char *data = content.data();
+		size_t size = content.size();
+		int mid_line = 0;
+
+		for ( size_t chunks=1; chunks<=64; chunks++ )
+		{
+			std::vector<size_t> bounds;
+			romlist_chunk_bounds( data, size, chunks, bounds );
+
+			FE_CHECK( bounds.size() == chunks + 1 );
+			FE_CHECK( bounds.front() == 0 );
+			FE_CHECK( bounds.back() == size );
+
+			std::vector<FeRomInfo> roms;
+			for ( size_t i=0; i<chunks; i++ )
+			{
+				if (( i > 0 ) && ( size / chunks * i > 0 ) && ( data[ size / chunks * i - 1 ] != '\n' ))
+					mid_line++;
+
+				FE_CHECK( bounds[i] <= bounds[i+1] );
+				FE_CHECK(( bounds[i] == 0 ) || ( data[ bounds[i] - 1 ] == '\n' ));
+
+				parse_romlist_chunk( data, bounds[i], bounds[i+1], roms );
+			}
+
+			FE_CHECK_MSG( roms.size() == expected.size(), name << ", " << chunks << " chunks" );
+			for ( size_t i=0; ( i < roms.size() ) && ( i < expected.size() ); i++ )
+			{
+				FE_CHECK_MSG( roms[i].full_comparison( expected[i] ),
+					name << ", " << chunks << " chunks: " << roms[i].as_output() << " != " << expected[i].as_output() );
+			}
+		}
+
+		// Make sure the split was tested with boundaries that start inside a line
+		FE_CHECK_MSG( mid_line > 0, name );
+
+		std::remove( path.c_str() );
+	}
+};
+
+int main( int argc, char *argv[] )
+{
+	std::string dir = FeTest::scratch_dir( argc, argv );
+
+	for ( int i=0; LINES[i]; i++ )
+	{
+		std::string line = LINES[i];
+		check_token_helper( line, ";" );
+		check_token_helper( line, FE_WHITESPACE );
+		check_token_helper( line + "\r", ";" );
+	}
+
+	check_romlist( dir, "test_romlist_lf.txt", make_romlist( "\n", true ));
+	check_romlist( dir, "test_romlist_crlf.txt", make_romlist( "\r\n", true ));
+	check_romlist( dir, "test_romlist_lf_no_eol.txt", make_romlist( "\n", false ));
+	check_romlist( dir, "test_romlist_crlf_no_eol.txt", make_romlist( "\r\n", false ));
+
+	return FeTest::report( "test_romlist_parse" );
+}
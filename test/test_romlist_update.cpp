@@ -0,0 +1,149 @@
+/*
+ *
+ *  Attract-Mode Plus frontend
+ *  Copyright (C) 2025 Andrew Mickelson & Radek Dutkiewicz
+ *
+ *  This file is part of Attract-Mode Plus
+ *
+ *  Attract-Mode Plus is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Attract-Mode Plus is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Attract-Mode Plus.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+//
+// Checks that FeSettings::update_romlist_file() edits, inserts and erases
+// a single entry of a romlist file and leaves the other lines as they were
+//
+#include "fe_test.hpp"
+#include "fe_settings.hpp"
+#include "fe_util.hpp"
+#include "nowide/fstream.hpp"
+
+#include <cstdio>
+#include <sstream>
+#include <vector>
+
+namespace
+{
+	const char *HEADER = "#Name;Title;Emulator;CloneOf;Year;Manufacturer;Category;Players;Rotation;Control;Status;DisplayCount;DisplayType;AltRomname;AltTitle;Extra;Buttons;Series;Language;Region;Rating";
+
+	FeRomInfo make_rom( const std::string &line )
+	{
+		std::string setting, value;
+		line_to_setting_and_value( line, setting, value, ";" );
+		FeRomInfo rom( setting );
+		rom.process_setting( setting, value, "" );
+		return rom;
+	}
+
+	std::string read_file( const std::string &path )
+	{
+		nowide::ifstream in( path, std::ios::binary );
+		std::ostringstream ss;
+		ss << in.rdbuf();
+		return ss.str();
+	}
+
+	void write_file( const std::string &path, const std::string &content )
+	{
+		nowide::ofstream out( path, std::ios::binary );
+		out.write( content.data(), content.size() );
+	}
+
+	std::string join( const std::vector<std::string> &lines, const char *eol, bool final_eol )
+	{
+		std::string s;
+		for ( size_t i=0; i<lines.size(); i++ )
+		{
+			s += lines[i];
+			if ( final_eol || ( i + 1 < lines.size() ))
+				s += eol;
+		}
+		return s;
+	}
+
+	void check_update( FeSettings &fes, const std::string &path, const char *eol, bool final_eol )
+	{
+		std::vector<std::string> lines;
+		lines.push_back( HEADER );
+		lines.push_back( make_rom( "first;First Game;mame;;1980" ).as_output() );
+		lines.push_back( make_rom( "middle;Middle Game;mame;;1981;Maker" ).as_output() );
+		lines.push_back( make_rom( "last;Last Game;mame;;1982" ).as_output() );
+
+		const std::string name = std::string( "test" ) + (( eol[0] == '\r' ) ? "_crlf" : "_lf" )
+			+ ( final_eol ? "" : "_no_eol" );
+
+		FeRomInfo middle = make_rom( lines[2] );
+		FeRomInfo edited = middle;
+		edited.set_info( FeRomInfo::Title, "Edited Game" );
+
+		// Edit the middle row in place
+		write_file( path, join( lines, eol, final_eol ));
+		FE_CHECK_MSG( fes.update_romlist_file( "test", middle, edited, FeSettings::UpdateEntry ), name );
+
+		std::vector<std::string> expected( lines );
+		expected[2] = edited.as_output();
+		FE_CHECK_MSG( read_file( path ) == join( expected, eol, final_eol ),
+			name << " edit:\n" << read_file( path ));
+
+		// Edit it back again, the edited row must be found
+		FE_CHECK_MSG( fes.update_romlist_file( "test", edited, middle, FeSettings::UpdateEntry ), name );
+		FE_CHECK_MSG( read_file( path ) == join( lines, eol, final_eol ),
+			name << " edit back:\n" << read_file( path ));
+
+		// Insert before the middle row
+		FeRomInfo inserted = make_rom( "inserted;Inserted Game;mame" );
+		FE_CHECK_MSG( fes.update_romlist_file( "test", middle, inserted, FeSettings::InsertEntry ), name );
+
+		expected = lines;
+		expected.insert( expected.begin() + 2, inserted.as_output() );
+		FE_CHECK_MSG( read_file( path ) == join( expected, eol, final_eol ),
+			name << " insert:\n" << read_file( path ));
+
+		// Erase the middle row, then the inserted one
+		FE_CHECK_MSG( fes.update_romlist_file( "test", middle, middle, FeSettings::EraseEntry ), name );
+		FE_CHECK_MSG( fes.update_romlist_file( "test", inserted, inserted, FeSettings::EraseEntry ), name );
+
+		expected = lines;
+		expected.erase( expected.begin() + 2 );
+		FE_CHECK_MSG( read_file( path ) == join( expected, eol, final_eol ),
+			name << " erase:\n" << read_file( path ));
+
+		// Edit the last row, which may have no line ending
+		FeRomInfo last = make_rom( lines[3] );
+		FeRomInfo last_edited = last;
+		last_edited.set_info( FeRomInfo::Year, "1999" );
+		FE_CHECK_MSG( fes.update_romlist_file( "test", last, last_edited, FeSettings::UpdateEntry ), name );
+
+		expected[2] = last_edited.as_output();
+		FE_CHECK_MSG( read_file( path ) == join( expected, eol, true ),
+			name << " edit last:\n" << read_file( path ));
+	}
+};
+
+int main( int argc, char *argv[] )
+{
+	std::string dir = FeTest::scratch_dir( argc, argv ) + "test_romlist_update/";
+	confirm_directory( dir, FE_ROMLIST_SUBDIR );
+
+	std::string path = dir + FE_ROMLIST_SUBDIR + "test" + FE_ROMLIST_FILE_EXTENSION;
+
+	FeSettings fes( dir );
+	check_update( fes, path, "\n", true );
+	check_update( fes, path, "\r\n", true );
+	check_update( fes, path, "\n", false );
+
+	std::remove( path.c_str() );
+
+	return FeTest::report( "test_romlist_update" );
+}